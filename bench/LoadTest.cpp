@@ -0,0 +1,430 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/connectivity/mqtt/MqttConnectivityService.h"
+#include "core/connectivity/mqtt/PahoMqttClient.h"
+#include "core/model/Message.h"
+#include "core/model/MessagePool.h"
+#include "core/model/messages/FeedValuesBuilder.h"
+#include "core/persistence/filesystem/FileSystemMessagePersistence.h"
+#include "core/persistence/inmemory/InMemoryMessagePersistence.h"
+#include "core/protocol/wolkabout/WolkaboutDataProtocol.h"
+#include "core/utilities/Logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace wolkabout;
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+const std::string SEQUENCE_REFERENCE = "SEQ";
+
+/**
+ * The load profile, filled in from the command line arguments.
+ */
+struct Profile
+{
+    std::uint32_t devices = 10;
+    std::uint32_t feeds = 4;
+    std::uint32_t rate = 1000;
+    std::uint32_t duration = 10;
+    std::string broker;
+    std::string persistencePath;
+    std::uint32_t publishLatencyUs = 0;
+    std::uint32_t disconnectEvery = 0;
+    std::uint32_t disconnectFor = 1;
+    std::uint32_t poolSize = 4096;
+};
+
+/**
+ * Stands in for the broker connection, acknowledging every publish after the configured latency while connected.
+ */
+class FakeMqttClient : public MqttClient
+{
+public:
+    explicit FakeMqttClient(std::chrono::microseconds publishLatency)
+    : m_publishLatency{publishLatency}, m_connected{false}
+    {
+    }
+
+    bool connect(const std::string&, const std::string&, const std::string&, const std::string&) override
+    {
+        m_connected = true;
+        return true;
+    }
+
+    void disconnect() override { m_connected = false; }
+
+    bool isConnected() override { return m_connected; }
+
+    bool subscribe(const std::string&) override { return m_connected; }
+
+    bool publish(const std::string&, const std::string&, bool) override
+    {
+        if (m_publishLatency.count() > 0)
+            std::this_thread::sleep_for(m_publishLatency);
+        return m_connected;
+    }
+
+private:
+    const std::chrono::microseconds m_publishLatency;
+    std::atomic_bool m_connected;
+};
+
+/**
+ * Keeps the time every message was generated at, and the latencies of the ones that were acknowledged since.
+ */
+class Recorder
+{
+public:
+    std::uint64_t generated(Clock::time_point time)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_generatedAt.emplace_back(time);
+        return m_generatedAt.size() - 1;
+    }
+
+    void published(std::uint64_t sequence, Clock::time_point time)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (sequence >= m_generatedAt.size())
+            return;
+
+        const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(time - m_generatedAt[sequence]);
+        m_interval.emplace_back(latency.count());
+        m_total.emplace_back(latency.count());
+        ++m_published;
+    }
+
+    std::uint64_t generatedCount()
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        return m_generatedAt.size();
+    }
+
+    std::uint64_t publishedCount()
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        return m_published;
+    }
+
+    std::vector<std::int64_t> takeInterval()
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        auto interval = std::vector<std::int64_t>{};
+        interval.swap(m_interval);
+        return interval;
+    }
+
+    std::vector<std::int64_t> total()
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        return m_total;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::vector<Clock::time_point> m_generatedAt;
+    std::vector<std::int64_t> m_interval;
+    std::vector<std::int64_t> m_total;
+    std::uint64_t m_published = 0;
+};
+
+/**
+ * Wraps the client the connectivity service publishes through, and records when each generated message got
+ * acknowledged. The sequence number is read out of the "SEQ" reading every generated message carries.
+ */
+class MeasuringMqttClient : public MqttClient
+{
+public:
+    MeasuringMqttClient(std::shared_ptr<MqttClient> client, Recorder& recorder)
+    : m_client{std::move(client)}, m_recorder{recorder}
+    {
+        m_client->onConnectionLost([this] {
+            if (m_onConnectionLost)
+                m_onConnectionLost();
+        });
+        m_client->onMessageReceived([this](std::string topic, std::string message) {
+            if (m_onMessageReceived)
+                m_onMessageReceived(std::move(topic), std::move(message));
+        });
+    }
+
+    bool connect(const std::string& username, const std::string& password, const std::string& address,
+                 const std::string& clientId) override
+    {
+        m_client->setTrustStore(getTrustStore());
+        m_client->setLastWill(getLastWillTopic(), getLastWillMessage(), getLastWillRetain());
+        return m_client->connect(username, password, address, clientId);
+    }
+
+    void disconnect() override { m_client->disconnect(); }
+
+    bool isConnected() override { return m_client->isConnected(); }
+
+    bool subscribe(const std::string& topic) override { return m_client->subscribe(topic); }
+
+    bool publish(const std::string& topic, const std::string& message, bool retained) override
+    {
+        if (!m_client->publish(topic, message, retained))
+            return false;
+
+        const auto acknowledged = Clock::now();
+        const auto key = "\"" + SEQUENCE_REFERENCE + "\":";
+        const auto position = message.find(key);
+        if (position != std::string::npos)
+            m_recorder.published(std::strtoull(message.c_str() + position + key.size(), nullptr, 10), acknowledged);
+        return true;
+    }
+
+private:
+    std::shared_ptr<MqttClient> m_client;
+    Recorder& m_recorder;
+};
+
+std::int64_t percentile(std::vector<std::int64_t>& values, double fraction)
+{
+    if (values.empty())
+        return 0;
+
+    const auto index = static_cast<std::size_t>(fraction * static_cast<double>(values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(index), values.end());
+    return values[index];
+}
+
+std::uint64_t memoryStatusKb(const std::string& field)
+{
+    auto status = std::ifstream{"/proc/self/status"};
+    auto line = std::string{};
+    while (std::getline(status, line))
+    {
+        if (line.compare(0, field.size(), field) == 0 && line.size() > field.size() && line[field.size()] == ':')
+            return std::strtoull(line.c_str() + field.size() + 1, nullptr, 10);
+    }
+    return 0;
+}
+
+void printUsage(const std::string& name)
+{
+    std::cout << "Usage: " << name << " [options]\n"
+              << "  --devices=N             number of devices to publish for (10)\n"
+              << "  --feeds=N               number of feeds in each message (4)\n"
+              << "  --rate=N                messages per second, across all devices (1000)\n"
+              << "  --duration=N            seconds to generate messages for (10)\n"
+              << "  --broker=URI            publish to this broker instead of the in-process fake client\n"
+              << "  --publish-latency-us=N  time the fake client takes to acknowledge a publish (0)\n"
+              << "  --disconnect-every=N    drop the connection every N seconds, 0 to never drop it (0)\n"
+              << "  --disconnect-for=N      seconds to stay disconnected (1)\n"
+              << "  --persistence-path=DIR  persist the backlog into files in DIR instead of in memory\n"
+              << "  --pool-size=N           messages in the pool they are made out of, 0 to allocate each one (4096)\n";
+}
+
+bool parseArguments(int argc, char** argv, Profile& profile)
+{
+    const auto numbers = std::map<std::string, std::uint32_t*>{{"--devices", &profile.devices},
+                                                               {"--feeds", &profile.feeds},
+                                                               {"--rate", &profile.rate},
+                                                               {"--duration", &profile.duration},
+                                                               {"--publish-latency-us", &profile.publishLatencyUs},
+                                                               {"--disconnect-every", &profile.disconnectEvery},
+                                                               {"--disconnect-for", &profile.disconnectFor},
+                                                               {"--pool-size", &profile.poolSize}};
+    const auto strings = std::map<std::string, std::string*>{{"--broker", &profile.broker},
+                                                             {"--persistence-path", &profile.persistencePath}};
+
+    for (auto i = 1; i < argc; ++i)
+    {
+        const auto argument = std::string{argv[i]};
+        const auto separator = argument.find('=');
+        const auto name = argument.substr(0, separator);
+        const auto value = separator == std::string::npos ? std::string{} : argument.substr(separator + 1);
+
+        const auto number = numbers.find(name);
+        const auto string = strings.find(name);
+        if (number != numbers.cend() && !value.empty())
+            *number->second = static_cast<std::uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+        else if (string != strings.cend() && !value.empty())
+            *string->second = value;
+        else
+            return false;
+    }
+    return profile.devices > 0 && profile.feeds > 0 && profile.rate > 0 && profile.duration > 0;
+}
+
+std::shared_ptr<Message> makeMessage(DataProtocol& protocol, MessagePool* pool, const std::string& deviceKey,
+                                     std::uint64_t sequence, std::uint32_t feeds, std::uint64_t timestamp)
+{
+    auto builder = FeedValuesBuilder{};
+    builder.add(Reading{SEQUENCE_REFERENCE, sequence, timestamp});
+    for (std::uint32_t feed = 1; feed < feeds; ++feed)
+        builder.add(Reading{"F" + std::to_string(feed), static_cast<double>(sequence % 1000) / 10, timestamp});
+    if (pool == nullptr)
+        return protocol.makeOutboundMessage(deviceKey, builder.build());
+    return protocol.makeOutboundMessage(deviceKey, builder.build(), *pool);
+}
+
+void printInterval(double second, std::uint64_t generated, std::uint64_t published,
+                   std::vector<std::int64_t> latencies, std::uint64_t backlog)
+{
+    std::cout << std::fixed << std::setprecision(1) << std::setw(7) << second << "s  generated " << std::setw(8)
+              << generated << " msg/s  published " << std::setw(8) << published << " msg/s  p50 " << std::setw(9)
+              << percentile(latencies, 0.5) << " us  p99 " << std::setw(9) << percentile(latencies, 0.99)
+              << " us  backlog " << std::setw(8) << backlog << "  rss " << memoryStatusKb("VmRSS") << " kB"
+              << std::endl;
+}
+}    // namespace
+
+/**
+ * Drives the whole outbound pipeline, from building the feed values messages to the MQTT client acknowledging them,
+ * at a fixed rate while dropping the connection on schedule. Prints the throughput, the latency between a message
+ * being generated and it being acknowledged, the size of the backlog and the resident memory every second.
+ */
+int main(int argc, char** argv)
+{
+    auto profile = Profile{};
+    if (!parseArguments(argc, argv, profile))
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+    Logger::init(LogLevel::ERROR, Logger::Type::CONSOLE);
+
+    auto client = std::shared_ptr<MqttClient>{};
+    if (profile.broker.empty())
+        client = std::make_shared<FakeMqttClient>(std::chrono::microseconds{profile.publishLatencyUs});
+    else
+        client = std::make_shared<PahoMqttClient>();
+
+    auto persistence = std::shared_ptr<MessagePersistence>{};
+    if (profile.persistencePath.empty())
+        persistence = std::make_shared<InMemoryMessagePersistence>();
+    else
+        persistence = std::make_shared<FileSystemMessagePersistence>(profile.persistencePath, PersistenceMethod::FIFO);
+
+    Recorder recorder;
+    MqttConnectivityService service{
+      std::make_shared<MeasuringMqttClient>(client, recorder), "LOAD_TEST", "", profile.broker, "", "LOAD_TEST",
+      persistence};
+    if (!service.connect())
+    {
+        std::cerr << "Failed to connect to '" << profile.broker << "'" << std::endl;
+        return 1;
+    }
+
+    // The messages held by the backlog keep their slots, so a pool smaller than the backlog falls back to allocating
+    auto pool = std::unique_ptr<MessagePool>{};
+    if (profile.poolSize > 0)
+        pool.reset(new MessagePool{profile.poolSize});
+    auto& poolMisses = MetricsRegistry::getInstance().counter("wolkabout_message_pool_misses_total", "");
+
+    std::atomic_bool generating{true};
+    auto generator = std::thread{[&] {
+        auto protocol = WolkaboutDataProtocol{};
+        const auto interval = std::chrono::nanoseconds{1000000000 / profile.rate};
+        const auto start = Clock::now();
+        const auto end = start + std::chrono::seconds{profile.duration};
+        auto next = start;
+        auto connected = true;
+        auto disconnectedUntil = Clock::time_point{};
+        auto nextDisconnect = start + std::chrono::seconds{profile.disconnectEvery};
+
+        while (next < end && Clock::now() < end)
+        {
+            std::this_thread::sleep_until(next);
+            const auto now = Clock::now();
+            if (profile.disconnectEvery > 0 && connected && now >= nextDisconnect)
+            {
+                service.disconnect();
+                connected = false;
+                disconnectedUntil = now + std::chrono::seconds{profile.disconnectFor};
+                nextDisconnect += std::chrono::seconds{profile.disconnectEvery};
+            }
+            else if (!connected && now >= disconnectedUntil)
+            {
+                connected = service.connect();
+            }
+
+            // Measure from the scheduled time, so falling behind the rate shows up in the latency instead of hiding it
+            const auto sequence = recorder.generated(next);
+            const auto deviceKey = "DEVICE_" + std::to_string(sequence % profile.devices);
+            const auto timestamp = static_cast<std::uint64_t>(
+              std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+                .count());
+            service.addMessage(makeMessage(protocol, pool.get(), deviceKey, sequence, profile.feeds, timestamp));
+            next += interval;
+        }
+
+        while (!connected)
+        {
+            std::this_thread::sleep_until(disconnectedUntil);
+            connected = service.connect();
+            disconnectedUntil = Clock::now() + std::chrono::seconds{profile.disconnectFor};
+        }
+        generating = false;
+    }};
+
+    // Report every second until everything generated got acknowledged, or the backlog stopped draining
+    const auto start = Clock::now();
+    auto report = start;
+    auto lastGenerated = std::uint64_t{0};
+    auto lastPublished = std::uint64_t{0};
+    auto stalled = 0;
+    while (true)
+    {
+        report += std::chrono::seconds{1};
+        std::this_thread::sleep_until(report);
+
+        const auto generated = recorder.generatedCount();
+        const auto published = recorder.publishedCount();
+        const auto second = std::chrono::duration<double>(Clock::now() - start).count();
+        printInterval(second, generated - lastGenerated, published - lastPublished, recorder.takeInterval(),
+                      generated - published);
+
+        stalled = published == lastPublished ? stalled + 1 : 0;
+        lastGenerated = generated;
+        lastPublished = published;
+        if (!generating && (generated == published || stalled >= 5))
+            break;
+    }
+    generator.join();
+
+    const auto elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    auto latencies = recorder.total();
+    const auto published = recorder.publishedCount();
+    std::cout << "\nGenerated " << recorder.generatedCount() << " messages, published " << published << " in "
+              << std::setprecision(2) << elapsed << "s (" << std::setprecision(1)
+              << static_cast<double>(published) / elapsed << " msg/s)\n"
+              << "Latency p50 " << percentile(latencies, 0.5) << " us, p99 " << percentile(latencies, 0.99)
+              << " us, max " << percentile(latencies, 1.0) << " us\n"
+              << "Peak resident memory " << memoryStatusKb("VmHWM") << " kB\n"
+              << "Messages allocated because the pool was empty " << poolMisses.value() << std::endl;
+
+    service.disconnect();
+    return 0;
+}
@@ -0,0 +1,238 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/model/Message.h"
+#include "core/persistence/filesystem/CircularFileSystemMessagePersistence.h"
+#include "core/persistence/filesystem/FileSystemMessagePersistence.h"
+#include "core/persistence/inmemory/InMemoryMessagePersistence.h"
+#include "core/utilities/FileSystemUtils.h"
+
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <fstream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace wolkabout;
+
+namespace
+{
+/**
+ * The persistences are compared by running every benchmark once for each of them.
+ */
+enum Backend : std::int64_t
+{
+    IN_MEMORY,
+    FILE_SYSTEM,
+    CIRCULAR_FILE_SYSTEM
+};
+
+const unsigned CIRCULAR_SIZE_LIMIT = 16 * 1024 * 1024;
+
+/**
+ * The directory the file system persistences are benchmarked in. Point the PERSISTENCE_BENCHMARK_PATH environment
+ * variable at a tmpfs or at a disk mount to compare the two, the directory is removed after every benchmark.
+ */
+std::string benchmarkPath()
+{
+    const auto path = std::getenv("PERSISTENCE_BENCHMARK_PATH");
+    return path != nullptr ? path : "./persistence_benchmark";
+}
+
+std::unique_ptr<MessagePersistence> makePersistence(std::int64_t backend)
+{
+    switch (backend)
+    {
+    case FILE_SYSTEM:
+        return std::unique_ptr<MessagePersistence>{
+          new FileSystemMessagePersistence{benchmarkPath(), PersistenceMethod::FIFO}};
+    case CIRCULAR_FILE_SYSTEM:
+        return std::unique_ptr<MessagePersistence>{
+          new CircularFileSystemMessagePersistence{benchmarkPath(), PersistenceMethod::FIFO, CIRCULAR_SIZE_LIMIT}};
+    default:
+        return std::unique_ptr<MessagePersistence>{new InMemoryMessagePersistence};
+    }
+}
+
+std::string backendName(std::int64_t backend)
+{
+    switch (backend)
+    {
+    case FILE_SYSTEM:
+        return "FileSystem";
+    case CIRCULAR_FILE_SYSTEM:
+        return "CircularFileSystem";
+    default:
+        return "InMemory";
+    }
+}
+
+void removeBenchmarkPath()
+{
+    const auto path = benchmarkPath();
+    for (const auto& file : FileSystemUtils::listFiles(path))
+        FileSystemUtils::deleteFile(FileSystemUtils::composePath(file, path));
+    rmdir(path.c_str());
+}
+
+/**
+ * A feed values message of roughly the given size.
+ */
+std::shared_ptr<Message> makeMessage(std::size_t size)
+{
+    auto content = std::string{"[{\"T\":"};
+    while (content.size() + 32 < size)
+        content += "21.5,";
+    content += "21.5,\"timestamp\":1623159800000}]";
+    return std::make_shared<Message>(content, "d2p/BENCHMARK_DEVICE/feed_values");
+}
+
+/**
+ * Reads a counter out of /proc/self/io, "wchar" for the bytes passed to write calls and "write_bytes" for the bytes
+ * the process caused to be sent to the storage. Both are 0 where the kernel does not account the I/O.
+ */
+std::uint64_t ioCounter(const std::string& name)
+{
+    auto io = std::ifstream{"/proc/self/io"};
+    auto line = std::string{};
+    while (std::getline(io, line))
+    {
+        if (line.compare(0, name.size(), name) == 0 && line.size() > name.size() && line[name.size()] == ':')
+            return std::strtoull(line.c_str() + name.size() + 1, nullptr, 10);
+    }
+    return 0;
+}
+
+/**
+ * The space the files in the benchmark directory take up on the device, in whole blocks.
+ */
+std::uint64_t allocatedBytes()
+{
+    const auto path = benchmarkPath();
+    auto total = std::uint64_t{0};
+    for (const auto& file : FileSystemUtils::listFiles(path))
+    {
+        struct stat status = {};
+        if (stat(FileSystemUtils::composePath(file, path).c_str(), &status) == 0)
+            total += static_cast<std::uint64_t>(status.st_blocks) * 512;
+    }
+    return total;
+}
+
+void fill(MessagePersistence& persistence, std::size_t count, const std::shared_ptr<Message>& message)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        persistence.push(message);
+}
+
+void persistenceArguments(benchmark::internal::Benchmark* benchmark, std::int64_t first, std::int64_t last)
+{
+    for (auto backend : {IN_MEMORY, FILE_SYSTEM, CIRCULAR_FILE_SYSTEM})
+        benchmark->Args({backend, first})->Args({backend, last});
+}
+}    // namespace
+
+/**
+ * Pushes messages of the given size, and reports how many bytes each backend writes and keeps per byte of payload.
+ */
+static void BM_PersistencePush(benchmark::State& state)
+{
+    removeBenchmarkPath();
+    const auto message = makeMessage(static_cast<std::size_t>(state.range(1)));
+    const auto payload = message->getChannel().size() + message->getContent().size();
+    auto persistence = makePersistence(state.range(0));
+
+    const auto writtenBefore = ioCounter("wchar");
+    const auto storedBefore = ioCounter("write_bytes");
+    for (auto _ : state)
+        benchmark::DoNotOptimize(persistence->push(message));
+
+    const auto payloadBytes = static_cast<double>(state.iterations() * payload);
+    state.counters["written/payload"] = static_cast<double>(ioCounter("wchar") - writtenBefore) / payloadBytes;
+    state.counters["stored/payload"] = static_cast<double>(ioCounter("write_bytes") - storedBefore) / payloadBytes;
+    state.counters["allocated/payload"] = static_cast<double>(allocatedBytes()) / payloadBytes;
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * payload));
+    state.SetLabel(backendName(state.range(0)));
+
+    persistence.reset();
+    removeBenchmarkPath();
+}
+BENCHMARK(BM_PersistencePush)->Apply([](benchmark::internal::Benchmark* benchmark) {
+    persistenceArguments(benchmark, 256, 16 * 1024);
+});
+
+/**
+ * Drains a persistence the way the connectivity service does, reading the front message and removing it once sent.
+ */
+static void BM_PersistenceFrontPop(benchmark::State& state)
+{
+    const std::size_t batch = 1000;
+    removeBenchmarkPath();
+    const auto message = makeMessage(static_cast<std::size_t>(state.range(1)));
+    auto persistence = makePersistence(state.range(0));
+
+    for (auto _ : state)
+    {
+        if (persistence->empty())
+        {
+            state.PauseTiming();
+            fill(*persistence, batch, message);
+            state.ResumeTiming();
+        }
+
+        const auto front = persistence->front();
+        benchmark::DoNotOptimize(front);
+        persistence->remove(front);
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+    state.SetLabel(backendName(state.range(0)));
+
+    persistence.reset();
+    removeBenchmarkPath();
+}
+BENCHMARK(BM_PersistenceFrontPop)->Apply([](benchmark::internal::Benchmark* benchmark) {
+    persistenceArguments(benchmark, 256, 16 * 1024);
+});
+
+/**
+ * Opens a persistence over the given number of messages left behind by a previous run.
+ */
+static void BM_PersistenceRecovery(benchmark::State& state)
+{
+    removeBenchmarkPath();
+    const auto count = static_cast<std::size_t>(state.range(1));
+    {
+        auto persistence = makePersistence(state.range(0));
+        fill(*persistence, count, makeMessage(256));
+    }
+
+    for (auto _ : state)
+    {
+        auto persistence = makePersistence(state.range(0));
+        benchmark::DoNotOptimize(persistence->empty());
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * count));
+    state.SetLabel(backendName(state.range(0)));
+    removeBenchmarkPath();
+}
+BENCHMARK(BM_PersistenceRecovery)
+  ->Args({FILE_SYSTEM, 100})
+  ->Args({FILE_SYSTEM, 10000})
+  ->Args({CIRCULAR_FILE_SYSTEM, 100})
+  ->Args({CIRCULAR_FILE_SYSTEM, 10000})
+  ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,193 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "core/model/Message.h"
+#include "core/model/MessagePool.h"
+#include "core/model/messages/FeedValuesBuilder.h"
+#include "core/model/messages/FeedValuesMessage.h"
+#include "core/model/messages/FileListResponseMessage.h"
+#include "core/model/messages/GatewaySubdeviceMessage.h"
+#include "core/protocol/wolkabout/WolkaboutDataProtocol.h"
+#include "core/protocol/wolkabout/WolkaboutFileManagementProtocol.h"
+#include "core/protocol/wolkabout/WolkaboutGatewaySubdeviceProtocol.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace wolkabout;
+
+namespace
+{
+const std::string DEVICE_KEY = "BENCHMARK_DEVICE";
+const std::uint64_t TIMESTAMP = 1623159800000;
+
+/**
+ * Makes the readings a device usually sends, a few feeds of every type sampled at the same timestamps.
+ */
+std::vector<Reading> makeReadings(std::size_t count)
+{
+    auto readings = std::vector<Reading>{};
+    readings.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const auto timestamp = TIMESTAMP + i / 4 * 1000;
+        switch (i % 4)
+        {
+        case 0:
+            readings.emplace_back("T", 21.5 + static_cast<double>(i % 10) / 10, timestamp);
+            break;
+        case 1:
+            readings.emplace_back("P", static_cast<std::uint64_t>(1000 + i), timestamp);
+            break;
+        case 2:
+            readings.emplace_back("SW", i % 8 == 2, timestamp);
+            break;
+        default:
+            readings.emplace_back("LOC", Location{45.2671 + static_cast<double>(i) / 1e4, 19.8335}, timestamp);
+        }
+    }
+    return readings;
+}
+
+std::shared_ptr<Message> makeInboundFeedValues(std::size_t count)
+{
+    auto protocol = WolkaboutDataProtocol{};
+    const auto outbound = protocol.makeOutboundMessage(DEVICE_KEY, FeedValuesMessage{makeReadings(count)});
+    return std::make_shared<Message>(outbound->getContent(), "p2d/" + DEVICE_KEY + "/feed_values");
+}
+
+std::vector<GatewaySubdeviceMessage> makeSubdeviceMessages(std::size_t count)
+{
+    auto protocol = WolkaboutDataProtocol{};
+    const auto readings = makeReadings(8);
+    auto messages = std::vector<GatewaySubdeviceMessage>{};
+    messages.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const auto message =
+          protocol.makeOutboundMessage("SUBDEVICE_" + std::to_string(i), FeedValuesMessage{readings});
+        messages.emplace_back(*message);
+    }
+    return messages;
+}
+}    // namespace
+
+static void BM_DataProtocolSerializeFeedValues(benchmark::State& state)
+{
+    auto protocol = WolkaboutDataProtocol{};
+    const auto message = FeedValuesMessage{makeReadings(static_cast<std::size_t>(state.range(0)))};
+    for (auto _ : state)
+        benchmark::DoNotOptimize(protocol.makeOutboundMessage(DEVICE_KEY, message));
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_DataProtocolSerializeFeedValues)->RangeMultiplier(4)->Range(1, 4096);
+
+static void BM_DataProtocolSerializeFeedValuesColumns(benchmark::State& state)
+{
+    auto protocol = WolkaboutDataProtocol{};
+    auto builder = FeedValuesBuilder{};
+    for (const auto& reading : makeReadings(static_cast<std::size_t>(state.range(0))))
+        builder.add(reading);
+    const auto message = builder.build();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(protocol.makeOutboundMessage(DEVICE_KEY, message));
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_DataProtocolSerializeFeedValuesColumns)->RangeMultiplier(4)->Range(1, 4096);
+
+static void BM_DataProtocolSerializeFeedValuesPooled(benchmark::State& state)
+{
+    auto protocol = WolkaboutDataProtocol{};
+    MessagePool pool{1};
+    auto builder = FeedValuesBuilder{};
+    for (const auto& reading : makeReadings(static_cast<std::size_t>(state.range(0))))
+        builder.add(reading);
+    const auto message = builder.build();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(protocol.makeOutboundMessage(DEVICE_KEY, message, pool));
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_DataProtocolSerializeFeedValuesPooled)->RangeMultiplier(4)->Range(1, 4096);
+
+static void BM_DataProtocolParseFeedValues(benchmark::State& state)
+{
+    auto protocol = WolkaboutDataProtocol{};
+    const auto message = makeInboundFeedValues(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(protocol.parseFeedValues(message));
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * state.range(0));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * message->getContent().size()));
+}
+BENCHMARK(BM_DataProtocolParseFeedValues)->RangeMultiplier(4)->Range(1, 4096);
+
+static void BM_SubdeviceProtocolSerializeBatch(benchmark::State& state)
+{
+    auto protocol = WolkaboutGatewaySubdeviceProtocol{};
+    const auto messages = makeSubdeviceMessages(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(protocol.makeOutboundMessage(DEVICE_KEY, messages));
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_SubdeviceProtocolSerializeBatch)->RangeMultiplier(4)->Range(1, 1024);
+
+static void BM_SubdeviceProtocolParseBatch(benchmark::State& state)
+{
+    auto protocol = WolkaboutGatewaySubdeviceProtocol{};
+    const auto batch = std::shared_ptr<Message>{
+      protocol.makeOutboundMessage(DEVICE_KEY, makeSubdeviceMessages(static_cast<std::size_t>(state.range(0))))};
+    for (auto _ : state)
+        benchmark::DoNotOptimize(protocol.parseIncomingSubdeviceMessage(batch));
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * state.range(0));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * batch->getContent().size()));
+}
+BENCHMARK(BM_SubdeviceProtocolParseBatch)->RangeMultiplier(4)->Range(1, 1024);
+
+static void BM_FileManagementProtocolParseBinaryResponse(benchmark::State& state)
+{
+    auto protocol = WolkaboutFileManagementProtocol{};
+    const auto message = std::make_shared<Message>(
+      std::string(32, 'P') + std::string(static_cast<std::size_t>(state.range(0)), 'D') + std::string(32, 'C'),
+      "p2d/" + DEVICE_KEY + "/file_binary_response");
+    for (auto _ : state)
+        benchmark::DoNotOptimize(protocol.parseFileBinaryResponse(message));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_FileManagementProtocolParseBinaryResponse)->Range(1024, 1 << 20);
+
+static void BM_FileManagementProtocolParseUploadInitiate(benchmark::State& state)
+{
+    auto protocol = WolkaboutFileManagementProtocol{};
+    const auto message = std::make_shared<Message>(
+      R"({"name":"firmware-1.2.3.bin","size":1048576,"hash":")" + std::string(64, 'a') + R"("})",
+      "p2d/" + DEVICE_KEY + "/file_upload_initiate");
+    for (auto _ : state)
+        benchmark::DoNotOptimize(protocol.parseFileUploadInit(message));
+}
+BENCHMARK(BM_FileManagementProtocolParseUploadInitiate);
+
+static void BM_FileManagementProtocolSerializeFileList(benchmark::State& state)
+{
+    auto protocol = WolkaboutFileManagementProtocol{};
+    auto files = std::vector<FileInformation>{};
+    for (auto i = 0; i < state.range(0); ++i)
+        files.emplace_back(FileInformation{"file_" + std::to_string(i) + ".bin", 1024u * static_cast<std::uint64_t>(i),
+                                           std::string(64, 'a')});
+    const auto message = FileListResponseMessage{files};
+    for (auto _ : state)
+        benchmark::DoNotOptimize(protocol.makeOutboundMessage(DEVICE_KEY, message));
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_FileManagementProtocolSerializeFileList)->RangeMultiplier(4)->Range(1, 1024);
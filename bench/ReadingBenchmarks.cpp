@@ -0,0 +1,74 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "core/model/Reading.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace wolkabout;
+
+namespace
+{
+/**
+ * Values of every type a reading can hold, in the form they arrive from the platform.
+ */
+const std::vector<std::string> VALUES = {"1623159800000", "-42", "21.375", "-1.5e-7", "true", "Hello World!",
+                                         "45.2671,19.8335"};
+}    // namespace
+
+static void BM_ReadingDetectType(benchmark::State& state)
+{
+    const auto reading = Reading{"R", VALUES[static_cast<std::size_t>(state.range(0))]};
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(reading.isUInt());
+        benchmark::DoNotOptimize(reading.isInt());
+        benchmark::DoNotOptimize(reading.isDouble());
+        benchmark::DoNotOptimize(reading.isBoolean());
+        benchmark::DoNotOptimize(reading.isMulti());
+    }
+    state.SetLabel(VALUES[static_cast<std::size_t>(state.range(0))]);
+}
+BENCHMARK(BM_ReadingDetectType)->DenseRange(0, 6);
+
+static void BM_ReadingFromDouble(benchmark::State& state)
+{
+    auto value = 21.375;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Reading{"T", value});
+        value += 0.001;
+    }
+}
+BENCHMARK(BM_ReadingFromDouble);
+
+static void BM_ReadingFromUInt(benchmark::State& state)
+{
+    auto value = std::uint64_t{1623159800000};
+    for (auto _ : state)
+        benchmark::DoNotOptimize(Reading{"P", value++});
+}
+BENCHMARK(BM_ReadingFromUInt);
+
+static void BM_ReadingGetDoubleValues(benchmark::State& state)
+{
+    const auto reading = Reading{"V", std::vector<double>(static_cast<std::size_t>(state.range(0)), 21.375)};
+    for (auto _ : state)
+        benchmark::DoNotOptimize(reading.getDoubleValues());
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_ReadingGetDoubleValues)->Range(1, 256);
@@ -0,0 +1,200 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/utilities/StringUtils.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace wolkabout;
+
+namespace
+{
+/**
+ * The base64 implementation the StringUtils used to have, kept here as the baseline for the comparison.
+ */
+const std::string legacy_base64_chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                                        "abcdefghijklmnopqrstuvwxyz"
+                                        "0123456789+/";
+
+std::string legacyBase64Encode(const ByteArray& bytesToEncode)
+{
+    std::string ret;
+    int i = 0;
+    std::uint8_t char_array_3[3];
+    std::uint8_t char_array_4[4];
+
+    for (const auto& byte : bytesToEncode)
+    {
+        char_array_3[i++] = byte;
+        if (i == 3)
+        {
+            char_array_4[0] = static_cast<std::uint8_t>((char_array_3[0] & 0xfcu) >> 2u);
+            char_array_4[1] =
+              static_cast<std::uint8_t>(((char_array_3[0] & 0x03u) << 4u) + ((char_array_3[1] & 0xf0u) >> 4u));
+            char_array_4[2] =
+              static_cast<std::uint8_t>(((char_array_3[1] & 0x0fu) << 2u) + ((char_array_3[2] & 0xc0u) >> 6u));
+            char_array_4[3] = static_cast<std::uint8_t>(char_array_3[2] & 0x3fu);
+
+            for (i = 0; i < 4; ++i)
+                ret += legacy_base64_chars[char_array_4[i]];
+            i = 0;
+        }
+    }
+
+    if (i)
+    {
+        for (auto j = i; j < 3; ++j)
+            char_array_3[j] = '\0';
+
+        char_array_4[0] = static_cast<std::uint8_t>((char_array_3[0] & 0xfcu) >> 2u);
+        char_array_4[1] =
+          static_cast<std::uint8_t>(((char_array_3[0] & 0x03u) << 4u) + ((char_array_3[1] & 0xf0u) >> 4u));
+        char_array_4[2] =
+          static_cast<std::uint8_t>(((char_array_3[1] & 0x0fu) << 2u) + ((char_array_3[2] & 0xc0u) >> 6u));
+
+        for (auto j = 0; j < i + 1; ++j)
+            ret += legacy_base64_chars[char_array_4[j]];
+
+        while ((i++ < 3))
+            ret += '=';
+    }
+
+    return ret;
+}
+
+std::string legacyBase64Decode(const std::string& encodedString)
+{
+    std::string ret;
+    auto i = 0;
+    std::uint8_t char_array_4[4];
+
+    for (const auto c : encodedString)
+    {
+        if (c == '=' || !StringUtils::isBase64(static_cast<unsigned char>(c)))
+            break;
+
+        char_array_4[i++] = static_cast<std::uint8_t>(c);
+        if (i == 4)
+        {
+            for (i = 0; i < 4; i++)
+                char_array_4[i] =
+                  static_cast<std::uint8_t>(legacy_base64_chars.find(static_cast<char>(char_array_4[i])));
+
+            ret += static_cast<char>((char_array_4[0] << 2) + ((char_array_4[1] & 0x30) >> 4));
+            ret += static_cast<char>(((char_array_4[1] & 0xf) << 4) + ((char_array_4[2] & 0x3c) >> 2));
+            ret += static_cast<char>(((char_array_4[2] & 0x3) << 6) + char_array_4[3]);
+            i = 0;
+        }
+    }
+
+    if (i)
+    {
+        for (auto j = 0; j < i; j++)
+            char_array_4[j] = static_cast<std::uint8_t>(legacy_base64_chars.find(static_cast<char>(char_array_4[j])));
+
+        if (i > 1)
+            ret += static_cast<char>((char_array_4[0] << 2) + ((char_array_4[1] & 0x30) >> 4));
+        if (i > 2)
+            ret += static_cast<char>(((char_array_4[1] & 0xf) << 4) + ((char_array_4[2] & 0x3c) >> 2));
+    }
+
+    return ret;
+}
+
+ByteArray makeBytes(std::size_t size)
+{
+    auto bytes = ByteArray(size);
+    for (std::size_t i = 0; i < size; ++i)
+        bytes[i] = static_cast<std::uint8_t>((i * 131) & 0xFF);
+    return bytes;
+}
+}    // namespace
+
+static void BM_Base64EncodeLegacy(benchmark::State& state)
+{
+    const auto bytes = makeBytes(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(legacyBase64Encode(bytes));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_Base64EncodeLegacy)->Range(64, 1 << 20);
+
+static void BM_Base64Encode(benchmark::State& state)
+{
+    const auto bytes = makeBytes(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(StringUtils::base64Encode(bytes));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_Base64Encode)->Range(64, 1 << 20);
+
+static void BM_Base64EncodeIntoBuffer(benchmark::State& state)
+{
+    const auto bytes = makeBytes(static_cast<std::size_t>(state.range(0)));
+    auto encoded = std::vector<char>(StringUtils::base64EncodedLength(bytes.size()));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(StringUtils::base64Encode(bytes.data(), bytes.size(), encoded.data()));
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_Base64EncodeIntoBuffer)->Range(64, 1 << 20);
+
+static void BM_Base64DecodeLegacy(benchmark::State& state)
+{
+    const auto encoded = StringUtils::base64Encode(makeBytes(static_cast<std::size_t>(state.range(0))));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(legacyBase64Decode(encoded));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_Base64DecodeLegacy)->Range(64, 1 << 20);
+
+static void BM_Base64Decode(benchmark::State& state)
+{
+    const auto encoded = StringUtils::base64Encode(makeBytes(static_cast<std::size_t>(state.range(0))));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(StringUtils::base64Decode(encoded));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_Base64Decode)->Range(64, 1 << 20);
+
+static void BM_Base64DecodeIntoBuffer(benchmark::State& state)
+{
+    const auto encoded = StringUtils::base64Encode(makeBytes(static_cast<std::size_t>(state.range(0))));
+    auto decoded = ByteArray(StringUtils::base64DecodedLength(encoded.size()));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(StringUtils::base64Decode(encoded.data(), encoded.size(), decoded.data()));
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_Base64DecodeIntoBuffer)->Range(64, 1 << 20);
+
+static void BM_MqttTopicMatch(benchmark::State& state)
+{
+    const auto topics = std::vector<std::pair<std::string, std::string>>{
+      {"p2d/+/feed_values", "p2d/DEVICE_KEY/feed_values"},
+      {"p2d/#", "p2d/DEVICE_KEY/file_binary_response"},
+      {"p2d/+/+", "p2d/DEVICE_KEY/file_upload_initiate"},
+      {"p2g/GATEWAY_KEY/+/parameters", "p2g/GATEWAY_KEY/SUBDEVICE_KEY/feed_values"}};
+    const auto& topic = topics[static_cast<std::size_t>(state.range(0))];
+    for (auto _ : state)
+        benchmark::DoNotOptimize(StringUtils::mqttTopicMatch(topic.first, topic.second));
+    state.SetLabel(topic.first);
+}
+BENCHMARK(BM_MqttTopicMatch)->DenseRange(0, 3);
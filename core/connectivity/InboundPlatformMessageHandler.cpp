@@ -26,7 +26,12 @@
 namespace wolkabout
 {
 InboundPlatformMessageHandler::InboundPlatformMessageHandler(std::vector<std::string> deviceKeys)
-: m_deviceKeys{std::move(deviceKeys)}, m_commandBuffer{new CommandBuffer}
+: m_deviceKeys{std::move(deviceKeys)}
+, m_commandBuffer{new CommandBuffer}
+, m_receivedMessages{MetricsRegistry::getInstance().counter("wolkabout_inbound_messages_total",
+                                                            "Messages received from the platform")}
+, m_unhandledMessages{MetricsRegistry::getInstance().counter("wolkabout_inbound_unhandled_messages_total",
+                                                             "Received messages no listener was interested in")}
 {
 }
 
@@ -38,6 +43,7 @@ InboundPlatformMessageHandler::~InboundPlatformMessageHandler()
 void InboundPlatformMessageHandler::messageReceived(const std::string& channel, const std::string& payload)
 {
     LOG(DEBUG) << "Message received on channel: '" << channel << "' : '" << payload << "'";
+    m_receivedMessages.increment();
 
     std::lock_guard<std::mutex> lg{m_lock};
 
@@ -59,6 +65,7 @@ void InboundPlatformMessageHandler::messageReceived(const std::string& channel,
     else
     {
         LOG(DEBUG) << "Handler for device channel not found: " << channel;
+        m_unhandledMessages.increment();
     }
 }
 
@@ -19,6 +19,7 @@
 
 #include "core/connectivity/InboundMessageHandler.h"
 #include "core/utilities/CommandBuffer.h"
+#include "core/utilities/Metrics.h"
 
 #include <map>
 #include <memory>
@@ -53,6 +54,9 @@ private:
 
     std::map<std::string, std::weak_ptr<MessageListener>, std::greater<std::string>> m_channelHandlers;
 
+    Counter& m_receivedMessages;
+    Counter& m_unhandledMessages;
+
     mutable std::mutex m_lock;
 };
 }    // namespace wolkabout
@@ -0,0 +1,191 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/connectivity/MessageTracer.h"
+
+#include "core/model/Message.h"
+
+#include <map>
+#include <sstream>
+
+namespace
+{
+std::uint32_t currentThread()
+{
+    static std::atomic<std::uint32_t> threads{0};
+    thread_local const auto thread = ++threads;
+    return thread;
+}
+
+/**
+ * @return What a message is doing after it reaches the stage, until it reaches the next one.
+ */
+std::string intervalName(wolkabout::TraceStage stage)
+{
+    using wolkabout::TraceStage;
+    switch (stage)
+    {
+    case TraceStage::ENQUEUED:
+        return "buffered";
+    case TraceStage::DEQUEUED:
+        return "dispatching";
+    case TraceStage::PERSISTED:
+        return "persisted";
+    case TraceStage::PUBLISH_STARTED:
+        return "publishing";
+    case TraceStage::ACKNOWLEDGED:
+        return "awaiting response";
+    case TraceStage::PUBLISH_FAILED:
+        return "waiting to republish";
+    case TraceStage::RETRIED:
+        return "retrying";
+    }
+    return "";
+}
+
+void chromeEvent(std::ostringstream& stream, bool& first, const std::string& name, char phase,
+                 const wolkabout::TraceEvent& event)
+{
+    stream << (first ? "" : ",") << "{\"name\":\"" << name << "\",\"cat\":\"message\",\"ph\":\"" << phase
+           << "\",\"id\":\"0x" << std::hex << event.messageId << std::dec << "\",\"ts\":" << event.timestamp
+           << ",\"pid\":1,\"tid\":" << event.thread << "}";
+    first = false;
+}
+}    // namespace
+
+namespace wolkabout
+{
+const std::size_t MessageTracer::DEFAULT_CAPACITY;
+
+std::atomic_bool MessageTracer::m_enabled{false};
+
+std::string toString(TraceStage stage)
+{
+    switch (stage)
+    {
+    case TraceStage::ENQUEUED:
+        return "enqueued";
+    case TraceStage::DEQUEUED:
+        return "dequeued";
+    case TraceStage::PERSISTED:
+        return "persisted";
+    case TraceStage::PUBLISH_STARTED:
+        return "publish_started";
+    case TraceStage::ACKNOWLEDGED:
+        return "acknowledged";
+    case TraceStage::PUBLISH_FAILED:
+        return "publish_failed";
+    case TraceStage::RETRIED:
+        return "retried";
+    }
+    return "";
+}
+
+MessageTracer& MessageTracer::getInstance()
+{
+    static MessageTracer tracer;
+    return tracer;
+}
+
+void MessageTracer::enable(std::size_t capacity)
+{
+    auto& tracer = getInstance();
+    {
+        std::lock_guard<std::mutex> lock{tracer.m_mutex};
+        tracer.m_events.clear();
+        tracer.m_events.setCapacity(capacity);
+        tracer.m_start = std::chrono::steady_clock::now();
+    }
+    m_enabled.store(true, std::memory_order_relaxed);
+}
+
+void MessageTracer::disable()
+{
+    m_enabled.store(false, std::memory_order_relaxed);
+}
+
+void MessageTracer::record(const Message& message, TraceStage stage)
+{
+    const auto now = std::chrono::steady_clock::now();
+    const auto thread = currentThread();
+
+    std::lock_guard<std::mutex> lock{m_mutex};
+    const auto timestamp = std::chrono::duration_cast<std::chrono::microseconds>(now - m_start).count();
+    m_events.push(TraceEvent{message.getId(), stage,
+                             timestamp > 0 ? static_cast<std::uint64_t>(timestamp) : 0, thread});
+}
+
+std::vector<TraceEvent> MessageTracer::getEvents() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto events = std::vector<TraceEvent>{};
+    events.reserve(m_events.size());
+    for (std::size_t i = 0; i < m_events.size(); ++i)
+        events.emplace_back(m_events.at(i));
+    return events;
+}
+
+std::string MessageTracer::toChromeTrace(const std::vector<TraceEvent>& events)
+{
+    // Find the event that ends the interval every event starts. A message enqueued again other than by a retry, like
+    // one that is published out of the persistence after a restart, starts a new pass through the pipeline.
+    auto next = std::vector<std::size_t>(events.size(), events.size());
+    auto latest = std::map<std::uint64_t, std::size_t>{};
+    for (std::size_t i = 0; i < events.size(); ++i)
+    {
+        const auto it = latest.find(events[i].messageId);
+        if (it != latest.end() &&
+            (events[i].stage != TraceStage::ENQUEUED || events[it->second].stage == TraceStage::RETRIED))
+            next[it->second] = i;
+        latest[events[i].messageId] = i;
+    }
+
+    auto stream = std::ostringstream{};
+    auto first = true;
+    stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    auto previous = std::vector<std::size_t>(events.size(), events.size());
+    for (std::size_t i = 0; i < events.size(); ++i)
+    {
+        const auto& event = events[i];
+        if (previous[i] != events.size())
+            chromeEvent(stream, first, intervalName(events[previous[i]].stage), 'e', event);
+
+        chromeEvent(stream, first, toString(event.stage), 'n', event);
+
+        if (next[i] != events.size())
+        {
+            chromeEvent(stream, first, intervalName(event.stage), 'b', event);
+            previous[next[i]] = i;
+        }
+    }
+    stream << "]}";
+    return stream.str();
+}
+
+std::string MessageTracer::toJson(const std::vector<TraceEvent>& events)
+{
+    auto stream = std::ostringstream{};
+    stream << "[";
+    for (std::size_t i = 0; i < events.size(); ++i)
+    {
+        const auto& event = events[i];
+        stream << (i == 0 ? "" : ",") << "{\"message\":" << event.messageId << ",\"stage\":\"" << toString(event.stage)
+               << "\",\"timestamp\":" << event.timestamp << ",\"thread\":" << event.thread << "}";
+    }
+    stream << "]";
+    return stream.str();
+}
+}    // namespace wolkabout
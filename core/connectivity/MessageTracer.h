@@ -0,0 +1,122 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WOLKABOUTCORE_MESSAGETRACER_H
+#define WOLKABOUTCORE_MESSAGETRACER_H
+
+#include "core/utilities/RingBuffer.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace wolkabout
+{
+class Message;
+
+/**
+ * The points of the outbound pipeline an outbound message passes through.
+ */
+enum class TraceStage
+{
+    ENQUEUED,
+    DEQUEUED,
+    PERSISTED,
+    PUBLISH_STARTED,
+    ACKNOWLEDGED,
+    PUBLISH_FAILED,
+    RETRIED
+};
+
+std::string toString(TraceStage stage);
+
+struct TraceEvent
+{
+    // The id of the message, which it keeps while it is persisted, and through retries and restarts
+    std::uint64_t messageId;
+    TraceStage stage;
+    // Microseconds since the tracing was enabled
+    std::uint64_t timestamp;
+    std::uint32_t thread;
+};
+
+/**
+ * This class records the time every outbound message reaches each stage of the pipeline, into a ring of the latest
+ * events, so it can be seen where a slow message spent its time. Tracing is disabled by default, and then `trace`
+ * costs a single relaxed load and a branch.
+ */
+class MessageTracer
+{
+public:
+    static const std::size_t DEFAULT_CAPACITY = 65536;
+
+    static MessageTracer& getInstance();
+
+    /**
+     * This method starts recording the events, and clears the ones recorded before.
+     *
+     * @param capacity The amount of latest events that are kept.
+     */
+    static void enable(std::size_t capacity = DEFAULT_CAPACITY);
+
+    static void disable();
+
+    static bool isEnabled() { return m_enabled.load(std::memory_order_relaxed); }
+
+    static void trace(const Message& message, TraceStage stage)
+    {
+        if (isEnabled())
+            getInstance().record(message, stage);
+    }
+
+    /**
+     * @return The recorded events, oldest first.
+     */
+    std::vector<TraceEvent> getEvents() const;
+
+    /**
+     * Formats the events in the Chrome trace event format, that chrome://tracing and Perfetto open. Every message is
+     * an async track, with a span for each interval between two of its stages, named after what the message was
+     * doing in it.
+     *
+     * @param events The events, oldest first.
+     * @return The trace as a JSON object.
+     */
+    static std::string toChromeTrace(const std::vector<TraceEvent>& events);
+
+    /**
+     * @param events The events, oldest first.
+     * @return The events as a JSON array.
+     */
+    static std::string toJson(const std::vector<TraceEvent>& events);
+
+private:
+    MessageTracer() = default;
+
+    void record(const Message& message, TraceStage stage);
+
+    static std::atomic_bool m_enabled;
+
+    mutable std::mutex m_mutex;
+    RingBuffer<TraceEvent> m_events;
+    std::chrono::steady_clock::time_point m_start;
+};
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCORE_MESSAGETRACER_H
@@ -16,6 +16,7 @@
 
 #include "OutboundRetryMessageHandler.h"
 
+#include "MessageTracer.h"
 #include "OutboundMessageHandler.h"
 #include "core/model/Message.h"
 #include "core/utilities/Logger.h"
@@ -32,7 +33,15 @@ static const size_t FLAG_INDEX = 3;
 namespace wolkabout
 {
 OutboundRetryMessageHandler::OutboundRetryMessageHandler(OutboundMessageHandler& messageHandler)
-: m_messageHandler{messageHandler}, m_run{true}, m_garbageCollector(&OutboundRetryMessageHandler::clearTimers, this)
+: m_messageHandler{messageHandler}
+, m_pendingMessages{MetricsRegistry::getInstance().gauge("wolkabout_retry_pending_messages",
+                                                         "Messages waiting for a response from the platform")}
+, m_retries{MetricsRegistry::getInstance().counter("wolkabout_retry_attempts_total",
+                                                   "Messages sent again because no response arrived in time")}
+, m_failures{MetricsRegistry::getInstance().counter("wolkabout_retry_failures_total",
+                                                    "Messages that got no response after all the retries")}
+, m_run{true}
+, m_garbageCollector(&OutboundRetryMessageHandler::clearTimers, this)
 {
 }
 
@@ -45,6 +54,9 @@ OutboundRetryMessageHandler::~OutboundRetryMessageHandler()
     {
         m_garbageCollector.join();
     }
+
+    std::lock_guard<decltype(m_mutex)> lg{m_mutex};
+    m_pendingMessages.add(-static_cast<std::int64_t>(m_messages.size()));
 }
 
 void OutboundRetryMessageHandler::addMessage(RetryMessageStruct msg)
@@ -59,6 +71,7 @@ void OutboundRetryMessageHandler::addMessage(RetryMessageStruct msg)
     // setup retry
     const auto id = getUniqueId();
     m_messages[id] = std::make_tuple(msg, std::unique_ptr<Timer>(new Timer()), 0, false);
+    m_pendingMessages.increment();
 
     auto& tup = m_messages[id];
     auto& timer = std::get<TIMER_INDEX>(tup);
@@ -84,6 +97,7 @@ void OutboundRetryMessageHandler::addMessage(RetryMessageStruct msg)
         if (retryCount > retryMessage.retryCount)
         {
             LOG(INFO) << "Retry count exceeded for message on channel: " << retryMessage.message->getChannel();
+            m_failures.increment();
 
             // flag message struct for deletion
             auto& clearMessage = std::get<FLAG_INDEX>(tuple);
@@ -98,6 +112,8 @@ void OutboundRetryMessageHandler::addMessage(RetryMessageStruct msg)
         {
             LOG(INFO) << "Retry sending message on channel: " << retryMessage.message->getChannel();
             // retry message sending
+            m_retries.increment();
+            MessageTracer::trace(*retryMessage.message, TraceStage::RETRIED);
             m_messageHandler.addMessage(retryMessage.message);
         }
     });
@@ -148,6 +164,7 @@ void OutboundRetryMessageHandler::clearTimers()
                 auto& timer = std::get<TIMER_INDEX>(tuple);
                 timer->stop();
                 it = m_messages.erase(it);
+                m_pendingMessages.decrement();
             }
             else
             {
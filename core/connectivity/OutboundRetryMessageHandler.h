@@ -17,6 +17,7 @@
 #ifndef OUTBOUNDRETRYMESSAGEHANDLER_H
 #define OUTBOUNDRETRYMESSAGEHANDLER_H
 
+#include "core/utilities/Metrics.h"
 #include "core/utilities/Timer.h"
 
 #include <atomic>
@@ -62,6 +63,10 @@ private:
 
     std::map<unsigned long long, std::tuple<RetryMessageStruct, std::unique_ptr<Timer>, short, bool>> m_messages;
 
+    Gauge& m_pendingMessages;
+    Counter& m_retries;
+    Counter& m_failures;
+
     std::atomic_bool m_run;
     std::condition_variable m_condition;
     std::mutex m_mutex;
@@ -16,6 +16,7 @@
 
 #include "core/connectivity/mqtt/MqttConnectivityService.h"
 
+#include "core/connectivity/MessageTracer.h"
 #include "core/model/Message.h"
 #include "core/persistence/inmemory/InMemoryMessagePersistence.h"
 
@@ -36,6 +37,16 @@ MqttConnectivityService::MqttConnectivityService(std::shared_ptr<MqttClient> mqt
 , m_connectedState{*this}
 , m_disconnectedState{*this}
 , m_currentState{&m_disconnectedState}
+, m_publishedMessages{MetricsRegistry::getInstance().counter("wolkabout_mqtt_published_messages_total",
+                                                             "Messages published to the broker")}
+, m_publishFailures{MetricsRegistry::getInstance().counter("wolkabout_mqtt_publish_failures_total",
+                                                           "Messages the broker did not accept")}
+, m_connectionLosses{
+    MetricsRegistry::getInstance().counter("wolkabout_mqtt_connection_losses_total", "Connections lost to the broker")}
+, m_bufferedMessages{MetricsRegistry::getInstance().gauge("wolkabout_mqtt_buffered_messages",
+                                                          "Messages added and not yet published or persisted")}
+, m_publishLatency{MetricsRegistry::getInstance().histogram("wolkabout_mqtt_publish_latency_microseconds",
+                                                            "Time the client takes to publish a message")}
 , m_run{true}
 , m_worker{new std::thread(&MqttConnectivityService::run, this)}
 {
@@ -50,6 +61,7 @@ MqttConnectivityService::MqttConnectivityService(std::shared_ptr<MqttClient> mqt
     });
 
     m_mqttClient->onConnectionLost([this]() -> void {
+        m_connectionLosses.increment();
         if (m_onConnectionLost)
             m_onConnectionLost();
 
@@ -68,6 +80,17 @@ MqttConnectivityService::~MqttConnectivityService()
     m_buffer.stop();
     if (m_worker->joinable())
         m_worker->join();
+
+    // The messages that were never taken out of the buffer are gone with it
+    while (!m_buffer.isDrained())
+    {
+        m_buffer.swapBuffers();
+        while (!m_buffer.isEmpty())
+        {
+            m_buffer.pop();
+            m_bufferedMessages.decrement();
+        }
+    }
 }
 
 bool MqttConnectivityService::connect()
@@ -110,16 +133,33 @@ bool MqttConnectivityService::isConnected()
 
 bool MqttConnectivityService::publish(std::shared_ptr<Message> outboundMessage)
 {
-    return m_mqttClient->publish(outboundMessage->getChannel(), outboundMessage->getContent());
+    MessageTracer::trace(*outboundMessage, TraceStage::PUBLISH_STARTED);
+    const auto start = std::chrono::steady_clock::now();
+    const auto published = m_mqttClient->publish(outboundMessage->getChannel(), outboundMessage->getContent());
+    m_publishLatency.recordSince(start);
+    MessageTracer::trace(*outboundMessage, published ? TraceStage::ACKNOWLEDGED : TraceStage::PUBLISH_FAILED);
+
+    if (published)
+        m_publishedMessages.increment();
+    else
+        m_publishFailures.increment();
+    return published;
 }
 
 void MqttConnectivityService::addMessage(std::shared_ptr<Message> message)
 {
     LOG(TRACE) << "MqttConnectivityService: Message added. Channel: '" << message->getChannel() << "' Payload: '"
                << message->getContent() << "'";
+    MessageTracer::trace(*message, TraceStage::ENQUEUED);
+    m_bufferedMessages.increment();
     m_buffer.push(std::move(message));
 }
 
+bool MqttConnectivityService::hasPendingMessages() const
+{
+    return !m_buffer.isDrained() || !m_persistence->empty();
+}
+
 void MqttConnectivityService::changeToState(State* state)
 {
     // Check if the current state is not the wanted state
@@ -150,8 +190,14 @@ void MqttConnectivityService::DisconnectedState::run()
         const auto message = m_service.m_buffer.pop();
         if (!message)
             break;
+        m_service.m_bufferedMessages.decrement();
+        MessageTracer::trace(*message, TraceStage::DEQUEUED);
 
-        if (!m_service.m_persistence->push(message))
+        if (m_service.m_persistence->push(message))
+        {
+            MessageTracer::trace(*message, TraceStage::PERSISTED);
+        }
+        else
         {
             LOG(ERROR) << "Failed to persist message";
         }
@@ -167,10 +213,13 @@ void MqttConnectivityService::ConnectedState::run()
         const auto message = m_service.m_buffer.pop();
         if (!message)
             break;
+        m_service.m_bufferedMessages.decrement();
+        MessageTracer::trace(*message, TraceStage::DEQUEUED);
 
         if (!m_service.publish(message))
         {
-            m_service.m_persistence->push(message);
+            if (m_service.m_persistence->push(message))
+                MessageTracer::trace(*message, TraceStage::PERSISTED);
             LOG(ERROR) << "Failed to publish message";
             break;
         }
@@ -184,9 +233,10 @@ void MqttConnectivityService::ConnectedState::run()
         if (!message)
             break;
 
+        // The message is removed by identity, as the retention could have removed it while it was being published
         if (m_service.publish(message))
         {
-            m_service.m_persistence->pop();
+            m_service.m_persistence->remove(message);
         }
         else
         {
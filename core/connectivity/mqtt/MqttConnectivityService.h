@@ -21,6 +21,7 @@
 #include "core/connectivity/OutboundMessageHandler.h"
 #include "core/connectivity/mqtt/MqttClient.h"
 #include "core/utilities/Buffer.h"
+#include "core/utilities/Metrics.h"
 
 #include <atomic>
 #include <memory>
@@ -50,6 +51,14 @@ public:
 
     void addMessage(std::shared_ptr<Message> message) override;
 
+    /**
+     * This method checks whether there are messages waiting to be published, either freshly added ones or the ones
+     * persisted while the connection was down. Other traffic, like the log uploads, can wait for it to be drained.
+     *
+     * @return Whether any message is still waiting to be published.
+     */
+    bool hasPendingMessages() const;
+
 private:
     class State
     {
@@ -102,6 +111,12 @@ private:
 
     Buffer<std::shared_ptr<Message>> m_buffer;
 
+    Counter& m_publishedMessages;
+    Counter& m_publishFailures;
+    Counter& m_connectionLosses;
+    Gauge& m_bufferedMessages;
+    Histogram& m_publishLatency;
+
     std::atomic_bool m_run;
     std::unique_ptr<std::thread> m_worker;
 };
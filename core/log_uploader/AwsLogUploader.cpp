@@ -16,23 +16,144 @@
 
 #include "AwsLogUploader.h"
 
+#include "core/utilities/ByteUtils.h"
+#include "core/utilities/Hasher.h"
 #include "core/utilities/Logger.h"
 
 #include <algorithm>
+#include <atomic>
 #include <aws/core/Aws.h>
+#include <aws/core/http/HttpRequest.h>
 #include <aws/core/utils/logging/LogLevel.h>
+#include <aws/core/utils/ratelimiter/DefaultRateLimiter.h>
 #include <aws/s3/S3Client.h>
-#include <aws/s3/model/ListObjectsRequest.h>
+#include <aws/s3/model/AbortMultipartUploadRequest.h>
+#include <aws/s3/model/CompleteMultipartUploadRequest.h>
+#include <aws/s3/model/CompletedMultipartUpload.h>
+#include <aws/s3/model/CompletedPart.h>
+#include <aws/s3/model/CreateMultipartUploadRequest.h>
+#include <aws/s3/model/ListMultipartUploadsRequest.h>
+#include <aws/s3/model/ListObjectsV2Request.h>
+#include <aws/s3/model/ListPartsRequest.h>
 #include <aws/s3/model/Object.h>
 #include <aws/s3/model/PutObjectRequest.h>
+#include <aws/s3/model/UploadPartRequest.h>
+#include <cctype>
+#include <exception>
 #include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
 #include <sys/stat.h>
+#include <thread>
+#include <vector>
+
+namespace
+{
+const char* const ALLOCATION_TAG = "AwsLogUploader";
+
+// The rate limiter is always in place, and without a limit it allows more than any link can carry
+const std::int64_t UNLIMITED_RATE = std::numeric_limits<std::int32_t>::max();
+
+std::mutex sdkMutex;
+std::size_t sdkUsers = 0;
+Aws::SDKOptions sdkOptions;
+
+void acquireSdk()
+{
+    std::lock_guard<std::mutex> lock{sdkMutex};
+    if (sdkUsers++ == 0)
+    {
+        Aws::InitAPI(sdkOptions);
+    }
+}
+
+void releaseSdk()
+{
+    std::lock_guard<std::mutex> lock{sdkMutex};
+    if (--sdkUsers == 0)
+    {
+        Aws::ShutdownAPI(sdkOptions);
+    }
+}
+
+// The ETag of a part is the MD5 of its content, in hex and in quotes
+bool partMatches(std::ifstream& file, std::uint64_t offset, std::uint64_t length, const Aws::String& eTag)
+{
+    const std::size_t CHUNK_SIZE = 64 * 1024;
+
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(offset));
+
+    auto hash = wolkabout::ByteArray{};
+    try
+    {
+        wolkabout::Hasher hasher{wolkabout::HashAlgorithm::MD5};
+        auto chunk = std::vector<char>(CHUNK_SIZE);
+        while (length > 0)
+        {
+            const auto size = static_cast<std::size_t>(std::min<std::uint64_t>(length, CHUNK_SIZE));
+            if (!file.read(chunk.data(), static_cast<std::streamsize>(size)))
+            {
+                return false;
+            }
+            hasher.update(reinterpret_cast<const wolkabout::Byte*>(chunk.data()), size);
+            length -= size;
+        }
+        hash = hasher.finalize();
+    }
+    catch (const std::exception&)
+    {
+        // A part that can not be verified is uploaded again
+        return false;
+    }
+
+    auto expected = std::string(eTag.c_str(), eTag.size());
+    expected.erase(std::remove(expected.begin(), expected.end(), '"'), expected.end());
+    std::transform(expected.begin(), expected.end(), expected.begin(),
+                   [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+    return wolkabout::ByteUtils::toHexString(hash) == expected;
+}
+}    // namespace
 
 namespace wolkabout
 {
-AwsLogUploader::AwsLogUploader(const std::string& bucketName, const std::string& region)
+const std::uint64_t AwsLogUploader::PART_SIZE;
+const std::uint64_t AwsLogUploader::MULTIPART_THRESHOLD;
+const std::size_t AwsLogUploader::PARALLEL_PARTS;
+
+AwsLogUploader::AwsLogUploader(const std::string& bucketName, const std::string& region, const std::string& endpoint)
 : m_bucketName(Aws::String(bucketName.c_str(), bucketName.size())), m_region(Aws::String(region.c_str(), region.size()))
 {
+    acquireSdk();
+
+    m_rateLimiter = Aws::MakeShared<Aws::Utils::RateLimits::DefaultRateLimiter<>>(ALLOCATION_TAG, UNLIMITED_RATE);
+
+    Aws::Client::ClientConfiguration config;
+    config.writeRateLimiter = m_rateLimiter;
+    if (!m_region.empty())
+    {
+        config.region = m_region;
+    }
+
+    if (!endpoint.empty())
+    {
+        config.endpointOverride = Aws::String(endpoint.c_str(), endpoint.size());
+        if (endpoint.compare(0, 7, "http://") == 0)
+        {
+            config.scheme = Aws::Http::Scheme::HTTP;
+        }
+    }
+
+    // The S3 compatible storages are addressed with the bucket in the path
+    m_client.reset(new Aws::S3::S3Client(config, Aws::Client::AWSAuthV4Signer::PayloadSigningPolicy::Never,
+                                         endpoint.empty()));
+}
+
+AwsLogUploader::~AwsLogUploader()
+{
+    m_client.reset();
+    releaseSdk();
 }
 
 std::string AwsLogUploader::getBucketName()
@@ -47,90 +168,376 @@ std::string AwsLogUploader::getRegion()
 
 bool wolkabout::AwsLogUploader::upload(const std::string& pathToLogFile)
 {
-    Aws::String objectName(pathToLogFile.c_str(), pathToLogFile.size());
+    return upload(pathToLogFile, [] { return false; });
+}
+
+bool AwsLogUploader::upload(const std::string& pathToLogFile, const std::function<bool()>& interrupted)
+{
+    if (interrupted())
+    {
+        return false;
+    }
+
+    const auto remoteName = getRemoteName(pathToLogFile);
+    Aws::String objectName(remoteName.c_str(), remoteName.size());
 
     // Verify that the file exists.
     struct stat buffer
     {
     };
 
-    if (stat(objectName.c_str(), &buffer) == -1)
+    if (stat(pathToLogFile.c_str(), &buffer) == -1)
     {
-        LOG(ERROR) << "File '" << objectName << "' does not exist.";
+        LOG(ERROR) << "File '" << pathToLogFile << "' does not exist.";
         return false;
     }
 
-    Aws::SDKOptions options;
-    Aws::InitAPI(options);
-
-    Aws::Client::ClientConfiguration config;
-
-    if (!m_region.empty())
+    const auto fileSize = static_cast<std::uint64_t>(buffer.st_size);
+    if (fileSize >= MULTIPART_THRESHOLD)
     {
-        config.region = m_region;
+        return uploadMultipart(pathToLogFile, objectName, fileSize, interrupted);
     }
 
-    Aws::S3::S3Client s3_client(config);
-
     Aws::S3::Model::PutObjectRequest request;
     request.SetBucket(m_bucketName);
     request.SetKey(objectName);
 
-    std::shared_ptr<Aws::IOStream> input_data = Aws::MakeShared<Aws::FStream>(
-      "SampleAllocationTag", objectName.c_str(), std::ios_base::in | std::ios_base::binary);
+    std::shared_ptr<Aws::IOStream> input_data =
+      Aws::MakeShared<Aws::FStream>(ALLOCATION_TAG, pathToLogFile.c_str(), std::ios_base::in | std::ios_base::binary);
 
     request.SetBody(input_data);
+    request.SetContinueRequestHandler([&](const Aws::Http::HttpRequest*) { return !interrupted(); });
 
-    Aws::S3::Model::PutObjectOutcome outcome = s3_client.PutObject(request);
+    Aws::S3::Model::PutObjectOutcome outcome = m_client->PutObject(request);
 
     if (outcome.IsSuccess())
     {
         LOG(INFO) << "Added object '" << objectName << "' to bucket '" << m_bucketName << "'.";
-        Aws::ShutdownAPI(options);
         return true;
     }
+    else if (interrupted())
+    {
+        LOG(INFO) << "Stopped the upload of '" << objectName << "', it will be attempted again";
+        return false;
+    }
     else
     {
         LOG(ERROR) << "Add object failed, outcome was: " << outcome.GetError().GetMessage();
-        Aws::ShutdownAPI(options);
         return false;
     }
 }
 
+void AwsLogUploader::setBandwidthLimit(std::uint64_t bytesPerSecond)
+{
+    auto rate = UNLIMITED_RATE;
+    if (bytesPerSecond != 0 && bytesPerSecond < static_cast<std::uint64_t>(UNLIMITED_RATE))
+    {
+        rate = static_cast<std::int64_t>(bytesPerSecond);
+    }
+    m_rateLimiter->SetRate(rate);
+}
+
 std::vector<std::string> wolkabout::AwsLogUploader::getRemoteLogs()
 {
     std::vector<std::string> remoteLogs;
+    for (const auto& remoteLog : getRemoteLogSizes(""))
+    {
+        remoteLogs.emplace_back(remoteLog.first);
+    }
+    return remoteLogs;
+}
+
+std::map<std::string, std::uint64_t> AwsLogUploader::getRemoteLogSizes(const std::string& prefix)
+{
+    std::map<std::string, std::uint64_t> remoteLogs;
+
+    Aws::S3::Model::ListObjectsV2Request request;
+    request.SetBucket(m_bucketName);
+    if (!prefix.empty())
+    {
+        request.SetPrefix(Aws::String(prefix.c_str(), prefix.size()));
+    }
+
+    LOG(DEBUG) << "Objects in bucket '" << m_bucketName << "' starting with '" << prefix << "':";
+    while (true)
+    {
+        auto outcome = m_client->ListObjectsV2(request);
+        if (!outcome.IsSuccess())
+        {
+            LOG(ERROR) << "Failed to get bucket content: " << outcome.GetError().GetMessage();
+            break;
+        }
+
+        const auto& result = outcome.GetResult();
+        for (const auto& object : result.GetContents())
+        {
+            LOG(TRACE) << object.GetKey();
+            remoteLogs.emplace(std::string(object.GetKey().c_str(), object.GetKey().size()),
+                               static_cast<std::uint64_t>(object.GetSize()));
+        }
+
+        if (!result.GetIsTruncated())
+        {
+            break;
+        }
+        request.SetContinuationToken(result.GetNextContinuationToken());
+    }
 
-    Aws::SDKOptions options;
-    Aws::InitAPI(options);
+    return remoteLogs;
+}
+
+void AwsLogUploader::setKeyPrefix(const std::string& keyPrefix)
+{
+    m_keyPrefix = keyPrefix;
+}
+
+std::string AwsLogUploader::getRemoteName(const std::string& pathToLogFile) const
+{
+    if (m_keyPrefix.empty())
     {
-        Aws::Client::ClientConfiguration config;
-        if (!m_region.empty())
+        return pathToLogFile;
+    }
+
+    // An absolute path would leave an empty segment in the name
+    const std::size_t start = pathToLogFile.compare(0, 1, "/") == 0 ? 1 : 0;
+    return m_keyPrefix + "/" + pathToLogFile.substr(start);
+}
+
+bool AwsLogUploader::uploadMultipart(const std::string& pathToLogFile, const Aws::String& objectName,
+                                     std::uint64_t fileSize, const std::function<bool()>& interrupted)
+{
+    const auto partCount = static_cast<std::size_t>((fileSize + PART_SIZE - 1) / PART_SIZE);
+    auto parts = Aws::Vector<Aws::S3::Model::CompletedPart>(partCount);
+
+    auto uploadId = findUnfinishedUpload(pathToLogFile, objectName, fileSize, parts);
+    if (uploadId.empty())
+    {
+        Aws::S3::Model::CreateMultipartUploadRequest createRequest;
+        createRequest.SetBucket(m_bucketName);
+        createRequest.SetKey(objectName);
+
+        auto createOutcome = m_client->CreateMultipartUpload(createRequest);
+        if (!createOutcome.IsSuccess())
         {
-            config.region = m_region;
+            LOG(ERROR) << "Failed to start the upload of '" << objectName
+                       << "', outcome was: " << createOutcome.GetError().GetMessage();
+            return false;
         }
-        Aws::S3::S3Client s3_client(config);
-        Aws::S3::Model::ListObjectsRequest request;
-        request.WithBucket(m_bucketName);
+        uploadId = createOutcome.GetResult().GetUploadId();
+    }
+
+    std::atomic<std::size_t> nextPart{0};
+    std::atomic_bool failed{false};
+    std::atomic_bool stopped{false};
 
-        auto outcome = s3_client.ListObjects(request);
-        if (outcome.IsSuccess())
+    // Every worker reads the parts it uploads on its own, so at most one part per worker is held in memory
+    const auto uploadParts = [&] {
+        std::ifstream file(pathToLogFile, std::ios_base::in | std::ios_base::binary);
+        auto content = std::string{};
+        for (auto part = nextPart++; part < partCount && !failed && !stopped; part = nextPart++)
         {
-            LOG(DEBUG) << "Objects in bucket '" << m_bucketName << "':";
-            Aws::Vector<Aws::S3::Model::Object> objects = outcome.GetResult().GetContents();
-            for (Aws::S3::Model::Object& object : objects)
+            // The parts uploaded by an earlier attempt are skipped
+            if (parts[part].PartNumberHasBeenSet())
+            {
+                continue;
+            }
+
+            if (interrupted())
+            {
+                stopped = true;
+                return;
+            }
+
+            const auto offset = part * PART_SIZE;
+            const auto length = std::min(PART_SIZE, fileSize - offset);
+            content.resize(static_cast<std::size_t>(length));
+            file.seekg(static_cast<std::streamoff>(offset));
+            if (!file.read(&content[0], static_cast<std::streamsize>(length)))
             {
-                LOG(DEBUG) << object.GetKey();
-                remoteLogs.emplace_back(std::string(object.GetKey().c_str(), object.GetKey().size()));
+                LOG(ERROR) << "Failed to read part " << part + 1 << " of '" << objectName << "'";
+                failed = true;
+                return;
             }
+
+            auto body = Aws::MakeShared<Aws::StringStream>(ALLOCATION_TAG);
+            body->write(content.data(), static_cast<std::streamsize>(length));
+
+            Aws::S3::Model::UploadPartRequest request;
+            request.SetBucket(m_bucketName);
+            request.SetKey(objectName);
+            request.SetUploadId(uploadId);
+            request.SetPartNumber(static_cast<int>(part + 1));
+            request.SetContentLength(static_cast<long long>(length));
+            request.SetBody(body);
+            request.SetContinueRequestHandler([&](const Aws::Http::HttpRequest*) { return !interrupted(); });
+
+            auto outcome = m_client->UploadPart(request);
+            if (!outcome.IsSuccess() && interrupted())
+            {
+                stopped = true;
+                return;
+            }
+            if (!outcome.IsSuccess())
+            {
+                LOG(ERROR) << "Failed to upload part " << part + 1 << " of '" << objectName
+                           << "', outcome was: " << outcome.GetError().GetMessage();
+                stopped = true;
+                return;
+            }
+
+            parts[part].SetPartNumber(static_cast<int>(part + 1));
+            parts[part].SetETag(outcome.GetResult().GetETag());
         }
-        else
+    };
+
+    auto workers = std::vector<std::thread>{};
+    for (std::size_t i = 0; i < std::min(PARALLEL_PARTS, partCount); ++i)
+    {
+        workers.emplace_back(uploadParts);
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    // The uploaded parts are kept, so the next attempt continues from where this one stopped
+    if (stopped && !failed)
+    {
+        LOG(INFO) << "Stopped the upload of '" << objectName << "', it will be continued by the next attempt";
+        return false;
+    }
+
+    // The file can not be read, so the uploaded parts are of no use
+    if (failed)
+    {
+        Aws::S3::Model::AbortMultipartUploadRequest abortRequest;
+        abortRequest.SetBucket(m_bucketName);
+        abortRequest.SetKey(objectName);
+        abortRequest.SetUploadId(uploadId);
+        m_client->AbortMultipartUpload(abortRequest);
+        return false;
+    }
+
+    Aws::S3::Model::CompletedMultipartUpload completedUpload;
+    completedUpload.SetParts(parts);
+
+    Aws::S3::Model::CompleteMultipartUploadRequest completeRequest;
+    completeRequest.SetBucket(m_bucketName);
+    completeRequest.SetKey(objectName);
+    completeRequest.SetUploadId(uploadId);
+    completeRequest.SetMultipartUpload(completedUpload);
+
+    auto completeOutcome = m_client->CompleteMultipartUpload(completeRequest);
+    if (!completeOutcome.IsSuccess())
+    {
+        LOG(ERROR) << "Failed to complete the upload of '" << objectName
+                   << "', outcome was: " << completeOutcome.GetError().GetMessage();
+        return false;
+    }
+
+    LOG(INFO) << "Added object '" << objectName << "' to bucket '" << m_bucketName << "' in " << partCount
+              << " parts.";
+    return true;
+}
+
+Aws::String AwsLogUploader::findUnfinishedUpload(const std::string& pathToLogFile, const Aws::String& objectName,
+                                                 std::uint64_t fileSize,
+                                                 Aws::Vector<Aws::S3::Model::CompletedPart>& parts)
+{
+    Aws::S3::Model::ListMultipartUploadsRequest uploadsRequest;
+    uploadsRequest.SetBucket(m_bucketName);
+    uploadsRequest.SetPrefix(objectName);
+
+    auto uploadsOutcome = m_client->ListMultipartUploads(uploadsRequest);
+    if (!uploadsOutcome.IsSuccess())
+    {
+        LOG(WARN) << "Failed to look for an unfinished upload of '" << objectName
+                  << "', outcome was: " << uploadsOutcome.GetError().GetMessage();
+        return {};
+    }
+
+    Aws::String uploadId;
+    for (const auto& upload : uploadsOutcome.GetResult().GetUploads())
+    {
+        if (upload.GetKey() == objectName)
         {
-            LOG(ERROR) << "Failed to get bucket content: " << outcome.GetError().GetMessage();
+            uploadId = upload.GetUploadId();
+            break;
         }
     }
-    Aws::ShutdownAPI(options);
+    if (uploadId.empty())
+    {
+        return {};
+    }
 
-    return remoteLogs;
+    Aws::S3::Model::ListPartsRequest partsRequest;
+    partsRequest.SetBucket(m_bucketName);
+    partsRequest.SetKey(objectName);
+    partsRequest.SetUploadId(uploadId);
+
+    std::ifstream file(pathToLogFile, std::ios_base::in | std::ios_base::binary);
+
+    std::size_t uploadedParts = 0;
+    std::size_t mismatchedParts = 0;
+    while (true)
+    {
+        auto partsOutcome = m_client->ListParts(partsRequest);
+        if (!partsOutcome.IsSuccess())
+        {
+            LOG(WARN) << "Failed to list the parts of the unfinished upload of '" << objectName
+                      << "', outcome was: " << partsOutcome.GetError().GetMessage();
+            return uploadId;
+        }
+
+        const auto& result = partsOutcome.GetResult();
+        for (const auto& part : result.GetParts())
+        {
+            // A part is used only if it holds exactly what this file would place there
+            const auto index = static_cast<std::size_t>(part.GetPartNumber() - 1);
+            if (part.GetPartNumber() < 1 || index >= parts.size() ||
+                static_cast<std::uint64_t>(part.GetSize()) != std::min(PART_SIZE, fileSize - index * PART_SIZE))
+            {
+                continue;
+            }
+
+            // A file rewritten to the same size would otherwise be completed with the parts of its old content
+            if (!partMatches(file, index * PART_SIZE, static_cast<std::uint64_t>(part.GetSize()), part.GetETag()))
+            {
+                ++mismatchedParts;
+                continue;
+            }
+
+            parts[index].SetPartNumber(part.GetPartNumber());
+            parts[index].SetETag(part.GetETag());
+            ++uploadedParts;
+        }
+
+        if (!result.GetIsTruncated())
+        {
+            break;
+        }
+        partsRequest.SetPartNumberMarker(result.GetNextPartNumberMarker());
+    }
+
+    // The upload is of an older version of the file, so it is started over
+    if (mismatchedParts > 0)
+    {
+        LOG(INFO) << "The unfinished upload of '" << objectName << "' does not match the file, starting it over";
+        Aws::S3::Model::AbortMultipartUploadRequest abortRequest;
+        abortRequest.SetBucket(m_bucketName);
+        abortRequest.SetKey(objectName);
+        abortRequest.SetUploadId(uploadId);
+        m_client->AbortMultipartUpload(abortRequest);
+
+        for (auto& part : parts)
+        {
+            part = Aws::S3::Model::CompletedPart{};
+        }
+        return {};
+    }
+
+    LOG(INFO) << "Continuing the upload of '" << objectName << "', " << uploadedParts << " of " << parts.size()
+              << " parts are already uploaded";
+    return uploadId;
 }
 }    // namespace wolkabout
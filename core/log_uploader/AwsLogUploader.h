@@ -20,13 +20,73 @@
 #include "core/utilities/LogUploader.h"
 
 #include <aws/core/utils/memory/stl/AWSString.h>
+#include <aws/core/utils/memory/stl/AWSVector.h>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace Aws
+{
+namespace S3
+{
+class S3Client;
+namespace Model
+{
+class CompletedPart;
+}
+}    // namespace S3
+namespace Utils
+{
+namespace RateLimits
+{
+class RateLimiterInterface;
+}
+}    // namespace Utils
+}    // namespace Aws
 
 namespace wolkabout
 {
+/**
+ * This is the log uploader that places the logs into an AWS S3 bucket. The AWS SDK is initialized by the first uploader
+ * and stays initialized while any uploader exists, and every uploader keeps a single S3 client for all its requests.
+ * An interrupted multipart upload is left in the bucket, and the next upload of the same file continues it.
+ */
 class AwsLogUploader : public wolkabout::LogUploader
 {
 public:
-    AwsLogUploader(const std::string& bucketName, const std::string& region);
+    /**
+     * The size of the parts large files are uploaded in.
+     */
+    static const std::uint64_t PART_SIZE = 5 * 1024 * 1024;
+
+    /**
+     * The size from which the files are uploaded in parts.
+     */
+    static const std::uint64_t MULTIPART_THRESHOLD = 2 * PART_SIZE;
+
+    /**
+     * The amount of parts that are uploaded at the same time.
+     */
+    static const std::size_t PARALLEL_PARTS = 4;
+
+    /**
+     * Default constructor for the uploader.
+     *
+     * @param bucketName The name of the bucket the logs are placed in.
+     * @param region The region of the bucket.
+     * @param endpoint The endpoint of an S3 compatible storage used instead of AWS. Empty uses AWS.
+     */
+    AwsLogUploader(const std::string& bucketName, const std::string& region, const std::string& endpoint = "");
+
+    /**
+     * Overridden destructor. Shuts the AWS SDK down if this is the last uploader.
+     */
+    ~AwsLogUploader() override;
+
+    AwsLogUploader(const AwsLogUploader&) = delete;
+    AwsLogUploader& operator=(const AwsLogUploader&) = delete;
 
     /**
      * The default getter for the bucket name this uploader is connected to.
@@ -49,15 +109,73 @@ public:
      */
     bool upload(const std::string& pathToLogFile) override;
 
+    /**
+     * @brief Attempt to upload a log file to a remote server, stopping the transfer in progress once interrupted. The
+     * parts that were already uploaded are not uploaded again by the next attempt.
+     * @param pathToLogFile Path where the log file is located on the file system
+     * @param interrupted Returns true once the upload should stop and be continued later
+     * @return Success of the operation, false if the upload was interrupted
+     */
+    bool upload(const std::string& pathToLogFile, const std::function<bool()>& interrupted) override;
+
+    /**
+     * @brief Limit the rate the files are uploaded at. The limit is shared by all the parts uploaded in parallel.
+     * @param bytesPerSecond The maximum upload rate, 0 for no limit
+     */
+    void setBandwidthLimit(std::uint64_t bytesPerSecond) override;
+
     /**
      * @brief Get all the name of log files that are present on the remote server
      * @return Vector of file names as string
      */
     std::vector<std::string> getRemoteLogs() override;
 
+    /**
+     * @brief Get the sizes of the log files in the bucket that start with a prefix. The bucket is listed page by page,
+     * so all the files are returned, and only the files with the prefix are listed.
+     * @param prefix The prefix of the object names
+     * @return The sizes of the objects, by their names
+     */
+    std::map<std::string, std::uint64_t> getRemoteLogSizes(const std::string& prefix) override;
+
+    /**
+     * @brief Set the prefix of the object names, like the device key of the device uploading the logs. The object of
+     * a log is named by the prefix and the path of the log, joined by a '/'.
+     * @param keyPrefix The prefix, empty to name the objects by the paths of the logs alone
+     */
+    void setKeyPrefix(const std::string& keyPrefix) override;
+
+    /**
+     * @brief Get the name of the object a file is uploaded as.
+     * @param pathToLogFile Path where the log file is located on the file system
+     * @return The name of the object
+     */
+    std::string getRemoteName(const std::string& pathToLogFile) const override;
+
 private:
+    bool uploadMultipart(const std::string& pathToLogFile, const Aws::String& objectName, std::uint64_t fileSize,
+                         const std::function<bool()>& interrupted);
+
+    /**
+     * This method looks for an unfinished multipart upload of an object, and the parts of it that were uploaded.
+     * Every uploaded part is checked against the content of the file, and an upload with a part that does not match is
+     * aborted, as it belongs to an older version of the file.
+     *
+     * @param pathToLogFile The path of the file being uploaded.
+     * @param objectName The name of the object.
+     * @param fileSize The size of the file, the parts that do not match it are not used.
+     * @param parts The uploaded parts are placed here, at their index.
+     * @return The id of the unfinished upload, empty if there is none or it was aborted.
+     */
+    Aws::String findUnfinishedUpload(const std::string& pathToLogFile, const Aws::String& objectName,
+                                     std::uint64_t fileSize, Aws::Vector<Aws::S3::Model::CompletedPart>& parts);
+
     Aws::String m_bucketName;
     Aws::String m_region;
+    std::string m_keyPrefix;
+
+    std::shared_ptr<Aws::Utils::RateLimits::RateLimiterInterface> m_rateLimiter;
+    std::unique_ptr<Aws::S3::S3Client> m_client;
 };
 
 }    // namespace wolkabout
@@ -16,12 +16,19 @@
 
 #include "core/model/Message.h"
 
+#include <atomic>
+#include <chrono>
 #include <utility>
 
 namespace wolkabout
 {
 Message::Message(std::string content, std::string channel)
-: m_content(std::move(content)), m_channel(std::move(channel))
+: m_content(std::move(content)), m_channel(std::move(channel)), m_id(nextId())
+{
+}
+
+Message::Message(std::string content, std::string channel, std::uint64_t id)
+: m_content(std::move(content)), m_channel(std::move(channel)), m_id(id)
 {
 }
 
@@ -34,4 +41,19 @@ const std::string& Message::getChannel() const
 {
     return m_channel;
 }
+
+std::uint64_t Message::getId() const
+{
+    return m_id;
+}
+
+std::uint64_t Message::nextId()
+{
+    // The ids start from the time the first message was made at, so the ids of the messages persisted before a
+    // restart are not given out again
+    static std::atomic<std::uint64_t> id{static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch())
+        .count())};
+    return id.fetch_add(1, std::memory_order_relaxed);
+}
 }    // namespace wolkabout
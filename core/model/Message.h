@@ -17,6 +17,7 @@
 #ifndef MESSAGE_H
 #define MESSAGE_H
 
+#include <cstdint>
 #include <string>
 
 namespace wolkabout
@@ -37,6 +38,15 @@ public:
      */
     Message(std::string content, std::string channel);
 
+    /**
+     * Constructor for a message that already has an id, like one loaded from the persistence.
+     *
+     * @param content The content that was received/sent in this message.
+     * @param channel The MQTT topic used to receive/send the message.
+     * @param id The id of the message.
+     */
+    Message(std::string content, std::string channel, std::uint64_t id);
+
     /**
      * Default virtual destructor.
      */
@@ -56,9 +66,22 @@ public:
      */
     const std::string& getChannel() const;
 
+    /**
+     * Default getter for the id of the message. The ids are not reused by the messages made later, even after a
+     * restart, and the copies of a message keep its id.
+     *
+     * @return The id of the message.
+     */
+    std::uint64_t getId() const;
+
 private:
+    friend class MessagePool;
+
+    static std::uint64_t nextId();
+
     std::string m_content;
     std::string m_channel;
+    std::uint64_t m_id;
 };
 }    // namespace wolkabout
 
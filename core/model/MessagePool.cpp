@@ -0,0 +1,162 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/model/MessagePool.h"
+
+#include <mutex>
+#include <new>
+#include <utility>
+
+namespace wolkabout
+{
+const std::size_t MessagePool::CONTROL_BLOCK_SIZE;
+
+struct MessagePool::State
+{
+    Slot* take()
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        auto slot = free;
+        if (slot != nullptr)
+        {
+            free = slot->next;
+            --available;
+        }
+        return slot;
+    }
+
+    void giveBack(Slot* slot)
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        slot->next = free;
+        free = slot;
+        ++available;
+    }
+
+    std::mutex mutex;
+    std::unique_ptr<Slot[]> slots;
+    std::size_t capacity;
+    std::size_t available;
+    Slot* free;
+};
+
+/**
+ * This allocator places the control block of a shared pointer in its slot, and gives the slot back to the pool when
+ * the control block is freed, which is the last thing the shared pointer does.
+ */
+template <class T> class MessagePool::SlotAllocator
+{
+public:
+    using value_type = T;
+
+    SlotAllocator(std::shared_ptr<State> state, Slot* slot) : m_state(std::move(state)), m_slot(slot) {}
+
+    template <class U>
+    SlotAllocator(const SlotAllocator<U>& other) : m_state(other.m_state), m_slot(other.m_slot)
+    {
+    }
+
+    T* allocate(std::size_t count)
+    {
+        if (!fitsInSlot(count))
+            return static_cast<T*>(::operator new(count * sizeof(T)));
+        return reinterpret_cast<T*>(&m_slot->controlBlock);
+    }
+
+    void deallocate(T* pointer, std::size_t count)
+    {
+        if (!fitsInSlot(count))
+            ::operator delete(pointer);
+        m_state->giveBack(m_slot);
+    }
+
+    template <class U> bool operator==(const SlotAllocator<U>& other) const { return m_slot == other.m_slot; }
+
+    template <class U> bool operator!=(const SlotAllocator<U>& other) const { return m_slot != other.m_slot; }
+
+private:
+    template <class U> friend class SlotAllocator;
+
+    static bool fitsInSlot(std::size_t count)
+    {
+        return count * sizeof(T) <= sizeof(Slot::controlBlock) && alignof(T) <= alignof(Slot);
+    }
+
+    std::shared_ptr<State> m_state;
+    Slot* m_slot;
+};
+
+MessagePool::MessagePool(std::size_t capacity, std::size_t contentCapacity)
+: m_state{std::make_shared<State>()}
+, m_misses{MetricsRegistry::getInstance().counter(
+    "wolkabout_message_pool_misses_total", "Messages allocated on the heap because the message pool was empty.")}
+{
+    m_state->slots.reset(new Slot[capacity]);
+    m_state->capacity = capacity;
+    m_state->available = capacity;
+    m_state->free = nullptr;
+    for (auto i = capacity; i > 0; --i)
+    {
+        auto& slot = m_state->slots[i - 1];
+        slot.message.m_content.reserve(contentCapacity);
+        slot.next = m_state->free;
+        m_state->free = &slot;
+    }
+}
+
+std::shared_ptr<Message> MessagePool::acquire(const std::string& content, const std::string& channel)
+{
+    return acquire([&](std::string& messageContent, std::string& messageChannel) {
+        messageContent.append(content);
+        messageChannel.append(channel);
+    });
+}
+
+std::size_t MessagePool::capacity() const
+{
+    return m_state->capacity;
+}
+
+std::size_t MessagePool::available() const
+{
+    std::lock_guard<std::mutex> lock{m_state->mutex};
+    return m_state->available;
+}
+
+MessagePool::Slot* MessagePool::take()
+{
+    return m_state->take();
+}
+
+void MessagePool::giveBack(Slot* slot)
+{
+    m_state->giveBack(slot);
+}
+
+std::shared_ptr<Message> MessagePool::share(Slot* slot)
+{
+    try
+    {
+        // The message is not destroyed when it is released, so the slot keeps its buffers
+        return std::shared_ptr<Message>{&slot->message, [](Message*) {}, SlotAllocator<Message>{m_state, slot}};
+    }
+    catch (...)
+    {
+        giveBack(slot);
+        throw;
+    }
+}
+}    // namespace wolkabout
@@ -0,0 +1,135 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WOLKABOUTCORE_MESSAGEPOOL_H
+#define WOLKABOUTCORE_MESSAGEPOOL_H
+
+#include "core/model/Message.h"
+#include "core/utilities/Metrics.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+namespace wolkabout
+{
+/**
+ * This class makes messages out of a fixed number of slots, that are all allocated at once when the pool is created.
+ * A slot holds the message together with the control block of the shared pointer owning it, the way
+ * `std::allocate_shared` would, and goes back to the pool when the last owner of the message lets go of it. The
+ * message is not destroyed in between, so its content and channel buffers are reused by the next message, and once
+ * the buffers have grown to the size of the messages being sent, making a message allocates nothing. Every message
+ * made out of a slot gets a new id. When all the slots are taken, the messages are allocated as usual.
+ */
+class MessagePool
+{
+public:
+    /**
+     * Default constructor for the pool.
+     *
+     * @param capacity The number of messages the pool holds.
+     * @param contentCapacity The size the content buffer of every message is reserved to up front.
+     */
+    explicit MessagePool(std::size_t capacity, std::size_t contentCapacity = 0);
+
+    /**
+     * This method makes a message, copying the content and the channel into the buffers of a free slot.
+     *
+     * @param content The content of the message.
+     * @param channel The MQTT topic of the message.
+     * @return The message.
+     */
+    std::shared_ptr<Message> acquire(const std::string& content, const std::string& channel);
+
+    /**
+     * This method makes a message, letting the writer append the content and the channel straight into the buffers
+     * of a free slot. The buffers are empty when the writer is called.
+     *
+     * @param write The writer, called as `write(std::string& content, std::string& channel)`.
+     * @return The message.
+     */
+    template <class Writer> std::shared_ptr<Message> acquire(Writer write);
+
+    /**
+     * This is the getter for the number of messages the pool holds.
+     *
+     * @return The capacity of the pool.
+     */
+    std::size_t capacity() const;
+
+    /**
+     * This is the getter for the number of slots that are not taken by a message.
+     *
+     * @return The number of free slots.
+     */
+    std::size_t available() const;
+
+private:
+    // Large enough for the control block of a shared pointer with an empty deleter and the slot allocator
+    static const std::size_t CONTROL_BLOCK_SIZE = 64;
+
+    struct Slot
+    {
+        typename std::aligned_storage<CONTROL_BLOCK_SIZE, alignof(std::max_align_t)>::type controlBlock;
+        Message message{"", ""};
+        Slot* next = nullptr;
+    };
+
+    struct State;
+
+    template <class T> class SlotAllocator;
+
+    Slot* take();
+
+    void giveBack(Slot* slot);
+
+    std::shared_ptr<Message> share(Slot* slot);
+
+    // The slots are shared with the messages, so the messages can outlive the pool
+    std::shared_ptr<State> m_state;
+
+    Counter& m_misses;
+};
+
+template <class Writer> std::shared_ptr<Message> MessagePool::acquire(Writer write)
+{
+    auto slot = take();
+    if (slot == nullptr)
+    {
+        m_misses.increment();
+        auto message = std::make_shared<Message>("", "");
+        write(message->m_content, message->m_channel);
+        return message;
+    }
+
+    try
+    {
+        slot->message.m_content.clear();
+        slot->message.m_channel.clear();
+        slot->message.m_id = Message::nextId();
+        write(slot->message.m_content, slot->message.m_channel);
+    }
+    catch (...)
+    {
+        giveBack(slot);
+        throw;
+    }
+    return share(slot);
+}
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCORE_MESSAGEPOOL_H
@@ -16,6 +16,8 @@
 
 #include "core/model/Reading.h"
 
+#include "core/utilities/StringUtils.h"
+
 #include <algorithm>
 #include <regex>
 #include <sstream>
@@ -30,7 +32,7 @@ const std::string LOCATION_DIVIDER = ",";
 // This is a collection of regex's that can be used to quickly determine if a value can be parsed into any of the types.
 const std::string UNSIGNED_REGEX = "\\d+";
 const std::string INTEGER_REGEX = "-?\\d+";
-const std::string DOUBLE_REGEX = "-?\\d+.\\d+";
+const std::string DOUBLE_REGEX = "-?\\d+.\\d+([eE][-+]?\\d+)?";
 const std::string BOOLEAN_REGEX = "(true|false)";
 
 Reading::Reading(std::string reference, std::string value, std::uint64_t rtcTimestamp)
@@ -39,17 +41,17 @@ Reading::Reading(std::string reference, std::string value, std::uint64_t rtcTime
 }
 
 Reading::Reading(std::string reference, std::uint64_t value, std::uint64_t rtcTimestamp)
-: m_reference(std::move(reference)), m_values({std::to_string(value)}), m_timestamp(rtcTimestamp)
+: m_reference(std::move(reference)), m_values({StringUtils::toString(value)}), m_timestamp(rtcTimestamp)
 {
 }
 
 Reading::Reading(std::string reference, std::int64_t value, std::uint64_t rtcTimestamp)
-: m_reference(std::move(reference)), m_values({std::to_string(value)}), m_timestamp(rtcTimestamp)
+: m_reference(std::move(reference)), m_values({StringUtils::toString(value)}), m_timestamp(rtcTimestamp)
 {
 }
 
 Reading::Reading(std::string reference, std::double_t value, std::uint64_t rtcTimestamp)
-: m_reference(std::move(reference)), m_values({std::to_string(value)}), m_timestamp(rtcTimestamp)
+: m_reference(std::move(reference)), m_values({StringUtils::toString(value)}), m_timestamp(rtcTimestamp)
 {
 }
 
@@ -60,7 +62,7 @@ Reading::Reading(std::string reference, bool value, std::uint64_t rtcTimestamp)
 
 Reading::Reading(std::string reference, Location location, std::uint64_t rtcTimestamp)
 : m_reference(std::move(reference))
-, m_values({std::to_string(location.latitude) + LOCATION_DIVIDER + std::to_string(location.longitude)})
+, m_values({StringUtils::toString(location.latitude) + LOCATION_DIVIDER + StringUtils::toString(location.longitude)})
 , m_timestamp(rtcTimestamp)
 {
 }
@@ -73,22 +75,25 @@ Reading::Reading(std::string reference, std::vector<std::string> values, std::ui
 Reading::Reading(std::string reference, const std::vector<std::uint64_t>& values, std::uint64_t rtcTimestamp)
 : m_reference(std::move(reference)), m_timestamp(rtcTimestamp)
 {
+    m_values.reserve(values.size());
     for (const auto& value : values)
-        m_values.emplace_back(std::to_string(value));
+        m_values.emplace_back(StringUtils::toString(value));
 }
 
 Reading::Reading(std::string reference, const std::vector<std::int64_t>& values, std::uint64_t rtcTimestamp)
 : m_reference(std::move(reference)), m_timestamp(rtcTimestamp)
 {
+    m_values.reserve(values.size());
     for (const auto& value : values)
-        m_values.emplace_back(std::to_string(value));
+        m_values.emplace_back(StringUtils::toString(value));
 }
 
 Reading::Reading(std::string reference, const std::vector<std::double_t>& values, std::uint64_t rtcTimestamp)
 : m_reference(std::move(reference)), m_timestamp(rtcTimestamp)
 {
+    m_values.reserve(values.size());
     for (const auto& value : values)
-        m_values.emplace_back(std::to_string(value));
+        m_values.emplace_back(StringUtils::toString(value));
 }
 
 const std::string& Reading::getReference() const
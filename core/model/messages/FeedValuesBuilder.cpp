@@ -0,0 +1,166 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "core/model/messages/FeedValuesBuilder.h"
+
+#include "core/utilities/StringUtils.h"
+
+#include <iterator>
+#include <utility>
+
+namespace wolkabout
+{
+FeedValuesBuilder::FeedValuesBuilder(std::size_t expectedValues)
+{
+    m_columns.referenceIndices.reserve(expectedValues);
+    m_columns.timestamps.reserve(expectedValues);
+    m_columns.types.reserve(expectedValues);
+    m_columns.values.reserve(expectedValues);
+}
+
+template <typename T>
+FeedValuesBuilder& FeedValuesBuilder::addMulti(const std::string& reference, const std::vector<T>& values,
+                                               std::uint64_t timestamp)
+{
+    auto joined = std::string{};
+    for (auto it = values.cbegin(); it != values.cend(); ++it)
+    {
+        if (it != values.cbegin())
+            joined += ',';
+        joined += StringUtils::toString(*it);
+    }
+    return addString(reference, FeedValueColumns::Type::MULTI, std::move(joined), timestamp);
+}
+
+FeedValuesBuilder& FeedValuesBuilder::add(const std::string& reference, bool value, std::uint64_t timestamp)
+{
+    auto columnValue = FeedValueColumns::Value{};
+    columnValue.boolean = value;
+    return addRow(reference, FeedValueColumns::Type::BOOLEAN, columnValue, timestamp);
+}
+
+FeedValuesBuilder& FeedValuesBuilder::add(const std::string& reference, std::uint64_t value, std::uint64_t timestamp)
+{
+    auto columnValue = FeedValueColumns::Value{};
+    columnValue.unsignedValue = value;
+    return addRow(reference, FeedValueColumns::Type::UNSIGNED, columnValue, timestamp);
+}
+
+FeedValuesBuilder& FeedValuesBuilder::add(const std::string& reference, std::int64_t value, std::uint64_t timestamp)
+{
+    auto columnValue = FeedValueColumns::Value{};
+    columnValue.signedValue = value;
+    return addRow(reference, FeedValueColumns::Type::SIGNED, columnValue, timestamp);
+}
+
+FeedValuesBuilder& FeedValuesBuilder::add(const std::string& reference, std::double_t value, std::uint64_t timestamp)
+{
+    auto columnValue = FeedValueColumns::Value{};
+    columnValue.doubleValue = value;
+    return addRow(reference, FeedValueColumns::Type::DOUBLE, columnValue, timestamp);
+}
+
+FeedValuesBuilder& FeedValuesBuilder::add(const std::string& reference, std::string value, std::uint64_t timestamp)
+{
+    return addString(reference, FeedValueColumns::Type::STRING, std::move(value), timestamp);
+}
+
+FeedValuesBuilder& FeedValuesBuilder::add(const std::string& reference, const char* value, std::uint64_t timestamp)
+{
+    return addString(reference, FeedValueColumns::Type::STRING, std::string{value}, timestamp);
+}
+
+FeedValuesBuilder& FeedValuesBuilder::add(const std::string& reference, const Location& value,
+                                          std::uint64_t timestamp)
+{
+    return addString(reference, FeedValueColumns::Type::STRING,
+                     StringUtils::toString(value.latitude) + "," + StringUtils::toString(value.longitude), timestamp);
+}
+
+FeedValuesBuilder& FeedValuesBuilder::add(const std::string& reference, const std::vector<std::uint64_t>& values,
+                                          std::uint64_t timestamp)
+{
+    return addMulti(reference, values, timestamp);
+}
+
+FeedValuesBuilder& FeedValuesBuilder::add(const std::string& reference, const std::vector<std::int64_t>& values,
+                                          std::uint64_t timestamp)
+{
+    return addMulti(reference, values, timestamp);
+}
+
+FeedValuesBuilder& FeedValuesBuilder::add(const std::string& reference, const std::vector<std::double_t>& values,
+                                          std::uint64_t timestamp)
+{
+    return addMulti(reference, values, timestamp);
+}
+
+FeedValuesBuilder& FeedValuesBuilder::add(const Reading& reading)
+{
+    if (!reading.isMulti())
+        return addString(reading.getReference(), FeedValueColumns::Type::STRING, reading.getStringValue(),
+                         reading.getTimestamp());
+
+    const auto values = reading.getStringValues();
+    auto joined = values.front();
+    for (auto it = std::next(values.cbegin()); it != values.cend(); ++it)
+        joined += "," + *it;
+    return addString(reading.getReference(), FeedValueColumns::Type::MULTI, std::move(joined), reading.getTimestamp());
+}
+
+std::size_t FeedValuesBuilder::size() const
+{
+    return m_columns.size();
+}
+
+FeedValuesMessage FeedValuesBuilder::build()
+{
+    return FeedValuesMessage{*this};
+}
+
+std::uint32_t FeedValuesBuilder::getReferenceIndex(const std::string& reference)
+{
+    const auto it = m_referenceIndices.find(reference);
+    if (it != m_referenceIndices.end())
+        return it->second;
+
+    const auto index = static_cast<std::uint32_t>(m_columns.references.size());
+    m_columns.references.emplace_back(reference);
+    m_referenceIndices.emplace(reference, index);
+    return index;
+}
+
+FeedValuesBuilder& FeedValuesBuilder::addRow(const std::string& reference, FeedValueColumns::Type type,
+                                             FeedValueColumns::Value value, std::uint64_t timestamp)
+{
+    m_columns.referenceIndices.emplace_back(getReferenceIndex(reference));
+    m_columns.timestamps.emplace_back(timestamp);
+    m_columns.types.emplace_back(type);
+    m_columns.values.emplace_back(value);
+    return *this;
+}
+
+FeedValuesBuilder& FeedValuesBuilder::addString(const std::string& reference, FeedValueColumns::Type type,
+                                                std::string value, std::uint64_t timestamp)
+{
+    auto columnValue = FeedValueColumns::Value{};
+    columnValue.stringIndex = m_columns.strings.size();
+    m_columns.strings.emplace_back(std::move(value));
+    return addRow(reference, type, columnValue, timestamp);
+}
+
+}    // namespace wolkabout
@@ -0,0 +1,112 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WOLKABOUTCORE_FEEDVALUESBUILDER_H
+#define WOLKABOUTCORE_FEEDVALUESBUILDER_H
+
+#include "core/Types.h"
+#include "core/model/Reading.h"
+#include "core/model/messages/FeedValuesMessage.h"
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace wolkabout
+{
+/**
+ * This class collects the feed values into columns, for sending a lot of values at once. Unlike the readings, the
+ * values do not carry their own reference and strings, so large batches take a fraction of the memory, and the
+ * protocol serializes the columns directly.
+ */
+class FeedValuesBuilder
+{
+public:
+    /**
+     * Default constructor for the builder.
+     *
+     * @param expectedValues The number of values the columns make place for up front.
+     */
+    explicit FeedValuesBuilder(std::size_t expectedValues = 0);
+
+    FeedValuesBuilder& add(const std::string& reference, bool value, std::uint64_t timestamp = 0);
+
+    FeedValuesBuilder& add(const std::string& reference, std::uint64_t value, std::uint64_t timestamp = 0);
+
+    FeedValuesBuilder& add(const std::string& reference, std::int64_t value, std::uint64_t timestamp = 0);
+
+    FeedValuesBuilder& add(const std::string& reference, std::double_t value, std::uint64_t timestamp = 0);
+
+    FeedValuesBuilder& add(const std::string& reference, std::string value, std::uint64_t timestamp = 0);
+
+    FeedValuesBuilder& add(const std::string& reference, const char* value, std::uint64_t timestamp = 0);
+
+    FeedValuesBuilder& add(const std::string& reference, const Location& value, std::uint64_t timestamp = 0);
+
+    FeedValuesBuilder& add(const std::string& reference, const std::vector<std::uint64_t>& values,
+                           std::uint64_t timestamp = 0);
+
+    FeedValuesBuilder& add(const std::string& reference, const std::vector<std::int64_t>& values,
+                           std::uint64_t timestamp = 0);
+
+    FeedValuesBuilder& add(const std::string& reference, const std::vector<std::double_t>& values,
+                           std::uint64_t timestamp = 0);
+
+    /**
+     * This method adds the value of a reading. The reading values are kept as strings, as the reading has no type.
+     *
+     * @param reading The reading.
+     * @return The builder, for chaining the calls.
+     */
+    FeedValuesBuilder& add(const Reading& reading);
+
+    /**
+     * This is the getter for the number of values in the builder.
+     *
+     * @return The number of values.
+     */
+    std::size_t size() const;
+
+    /**
+     * This method moves the collected values into a message, and leaves the builder empty.
+     *
+     * @return The message with the collected values.
+     */
+    FeedValuesMessage build();
+
+private:
+    friend class FeedValuesMessage;
+
+    std::uint32_t getReferenceIndex(const std::string& reference);
+
+    FeedValuesBuilder& addRow(const std::string& reference, FeedValueColumns::Type type, FeedValueColumns::Value value,
+                              std::uint64_t timestamp);
+
+    FeedValuesBuilder& addString(const std::string& reference, FeedValueColumns::Type type, std::string value,
+                                 std::uint64_t timestamp);
+
+    template <typename T>
+    FeedValuesBuilder& addMulti(const std::string& reference, const std::vector<T>& values, std::uint64_t timestamp);
+
+    FeedValueColumns m_columns;
+    std::unordered_map<std::string, std::uint32_t> m_referenceIndices;
+};
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCORE_FEEDVALUESBUILDER_H
@@ -16,8 +16,39 @@
 
 #include "core/model/messages/FeedValuesMessage.h"
 
+#include "core/model/messages/FeedValuesBuilder.h"
+#include "core/utilities/StringUtils.h"
+
+#include <utility>
+
 namespace wolkabout
 {
+namespace
+{
+Reading toReading(const FeedValueColumns& columns, std::size_t row)
+{
+    const auto& reference = columns.references[columns.referenceIndices[row]];
+    const auto& value = columns.values[row];
+    const auto timestamp = columns.timestamps[row];
+    switch (columns.types[row])
+    {
+    case FeedValueColumns::Type::BOOLEAN:
+        return Reading{reference, value.boolean, timestamp};
+    case FeedValueColumns::Type::UNSIGNED:
+        return Reading{reference, value.unsignedValue, timestamp};
+    case FeedValueColumns::Type::SIGNED:
+        return Reading{reference, value.signedValue, timestamp};
+    case FeedValueColumns::Type::DOUBLE:
+        return Reading{reference, value.doubleValue, timestamp};
+    case FeedValueColumns::Type::MULTI:
+        return Reading{reference, StringUtils::tokenize(columns.strings[value.stringIndex], ","), timestamp};
+    case FeedValueColumns::Type::STRING:
+    default:
+        return Reading{reference, columns.strings[value.stringIndex], timestamp};
+    }
+}
+}    // namespace
+
 FeedValuesMessage::FeedValuesMessage(const std::vector<Reading>& readings)
 {
     for (const auto& reading : readings)
@@ -26,6 +57,27 @@ FeedValuesMessage::FeedValuesMessage(const std::vector<Reading>& readings)
     }
 }
 
+FeedValuesMessage::FeedValuesMessage(FeedValuesBuilder& builder) : m_columns(std::move(builder.m_columns))
+{
+    builder.m_columns = FeedValueColumns{};
+    builder.m_referenceIndices.clear();
+}
+
+FeedValuesMessage::FeedValuesMessage(const FeedValuesMessage& other) : MessageModel(other), m_columns(other.m_columns)
+{
+    // The readings of a message made out of readings are never changed, unlike the ones made out of columns
+    if (m_columns.empty())
+        m_readings = other.m_readings;
+}
+
+FeedValuesMessage::FeedValuesMessage(FeedValuesMessage&& other)
+: MessageModel(other), m_columns(std::move(other.m_columns)), m_readings(std::move(other.m_readings))
+{
+    // The readings are made again only if they were not moved over
+    if (!m_readings.empty() || m_columns.empty())
+        std::call_once(m_readingsMade, [] {});
+}
+
 MessageType FeedValuesMessage::getMessageType() const
 {
     return MessageType::FEED_VALUES;
@@ -33,6 +85,15 @@ MessageType FeedValuesMessage::getMessageType() const
 
 const std::map<std::uint64_t, std::vector<Reading>>& FeedValuesMessage::getReadings() const
 {
+    std::call_once(m_readingsMade, [this] {
+        for (std::size_t row = 0; row < m_columns.size(); ++row)
+            m_readings[m_columns.timestamps[row]].emplace_back(toReading(m_columns, row));
+    });
     return m_readings;
 }
+
+const FeedValueColumns& FeedValuesMessage::getColumns() const
+{
+    return m_columns;
+}
 }    // namespace wolkabout
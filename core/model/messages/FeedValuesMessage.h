@@ -20,23 +20,103 @@
 #include "core/model/Reading.h"
 #include "core/model/messages/MessageModel.h"
 
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 
 namespace wolkabout
 {
+class FeedValuesBuilder;
+
+/**
+ * This is the columnar form of the feed values, as collected by the FeedValuesBuilder. Every value is a row spread over
+ * the columns, every feed reference is kept only once and the rows point to it by index, and the values are kept as
+ * their own type instead of as strings.
+ */
+struct FeedValueColumns
+{
+    enum class Type : std::uint8_t
+    {
+        BOOLEAN,
+        UNSIGNED,
+        SIGNED,
+        DOUBLE,
+        STRING,
+        MULTI
+    };
+
+    /**
+     * The value of a row, as told by its type. The strings and the multi-values, joined by commas, are kept in the
+     * strings column, and the value holds their index.
+     */
+    union Value
+    {
+        bool boolean;
+        std::uint64_t unsignedValue;
+        std::int64_t signedValue;
+        double doubleValue;
+        std::uint64_t stringIndex;
+    };
+
+    std::size_t size() const { return timestamps.size(); }
+
+    bool empty() const { return timestamps.empty(); }
+
+    std::vector<std::string> references;
+    std::vector<std::uint32_t> referenceIndices;
+    std::vector<std::uint64_t> timestamps;
+    std::vector<Type> types;
+    std::vector<Value> values;
+    std::vector<std::string> strings;
+};
+
 class FeedValuesMessage : public MessageModel
 {
 public:
     explicit FeedValuesMessage(const std::vector<Reading>& readings);
 
+    /**
+     * This is the constructor for the feed values collected by the builder, which is left empty. The values stay in
+     * their columns, and are turned into readings only if `getReadings` is called.
+     *
+     * @param builder The builder with the feed values.
+     */
+    explicit FeedValuesMessage(FeedValuesBuilder& builder);
+
+    /**
+     * The copy of a message made out of columns makes its own readings, so a copy can be made while the readings of
+     * the message are being made by another thread.
+     *
+     * @param other The message to copy.
+     */
+    FeedValuesMessage(const FeedValuesMessage& other);
+
+    FeedValuesMessage(FeedValuesMessage&& other);
+
     MessageType getMessageType() const override;
 
+    /**
+     * Default getter for the readings, grouped by their timestamp. For a message made out of columns, the readings are
+     * made by the first call, and the calls made at the same time from other threads wait for them.
+     *
+     * @return The readings mapped by their timestamp.
+     */
     const std::map<std::uint64_t, std::vector<Reading>>& getReadings() const;
 
+    /**
+     * Default getter for the columns. A message made out of readings has no columns.
+     *
+     * @return The columns with the feed values.
+     */
+    const FeedValueColumns& getColumns() const;
+
 private:
-    std::map<std::uint64_t, std::vector<Reading>> m_readings;
+    FeedValueColumns m_columns;
+    mutable std::map<std::uint64_t, std::vector<Reading>> m_readings;
+    mutable std::once_flag m_readingsMade;
 };
 }    // namespace wolkabout
 
@@ -16,33 +16,41 @@
 
 #include "core/model/messages/FileBinaryResponseMessage.h"
 
-#include "core/utilities/ByteUtils.h"
+#include <utility>
 
 namespace wolkabout
 {
-FileBinaryResponseMessage::FileBinaryResponseMessage(const std::string& payload)
+FileBinaryResponseMessage::FileBinaryResponseMessage(std::string payload)
+: FileBinaryResponseMessage(std::make_shared<const Message>(std::move(payload), std::string{}))
 {
-    if (payload.length() > 64)
-    {
-        m_previousHash = payload.substr(0, 32);
-        m_data = ByteUtils::toByteArray(payload.substr(32, payload.length() - 64));
-        m_currentHash = payload.substr(payload.length() - 32);
-    }
 }
 
-const std::string& FileBinaryResponseMessage::getPreviousHash() const
+FileBinaryResponseMessage::FileBinaryResponseMessage(std::shared_ptr<const Message> message)
+: m_message(std::move(message)), m_valid(m_message != nullptr && m_message->getContent().length() > 2 * HASH_LENGTH)
 {
-    return m_previousHash;
 }
 
-const std::vector<std::uint8_t>& FileBinaryResponseMessage::getData() const
+std::string FileBinaryResponseMessage::getPreviousHash() const
 {
-    return m_data;
+    if (!m_valid)
+        return {};
+    return m_message->getContent().substr(0, HASH_LENGTH);
 }
 
-const std::string& FileBinaryResponseMessage::getCurrentHash() const
+ByteView FileBinaryResponseMessage::getData() const
 {
-    return m_currentHash;
+    if (!m_valid)
+        return {};
+    const auto& content = m_message->getContent();
+    return {reinterpret_cast<const Byte*>(content.data()) + HASH_LENGTH, content.length() - 2 * HASH_LENGTH};
+}
+
+std::string FileBinaryResponseMessage::getCurrentHash() const
+{
+    if (!m_valid)
+        return {};
+    const auto& content = m_message->getContent();
+    return content.substr(content.length() - HASH_LENGTH);
 }
 
 MessageType FileBinaryResponseMessage::getMessageType() const
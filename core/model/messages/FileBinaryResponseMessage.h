@@ -17,27 +17,43 @@
 #ifndef WOLKABOUTCORE_FILEBINARYRESPONSEMESSAGE_H
 #define WOLKABOUTCORE_FILEBINARYRESPONSEMESSAGE_H
 
+#include "core/model/Message.h"
 #include "core/model/messages/MessageModel.h"
+#include "core/utilities/ByteUtils.h"
+
+#include <memory>
 
 namespace wolkabout
 {
+/**
+ * This message does not copy the chunk out of the payload. The hashes and the data are read straight out of the
+ * received message, which is kept alive for as long as this message lives.
+ */
 class FileBinaryResponseMessage : public MessageModel
 {
 public:
-    explicit FileBinaryResponseMessage(const std::string& payload);
+    explicit FileBinaryResponseMessage(std::string payload);
 
-    const std::string& getPreviousHash() const;
+    explicit FileBinaryResponseMessage(std::shared_ptr<const Message> message);
 
-    const std::vector<std::uint8_t>& getData() const;
+    std::string getPreviousHash() const;
 
-    const std::string& getCurrentHash() const;
+    /**
+     * Default getter for the chunk data.
+     *
+     * @return A view into the received payload. Valid for as long as this message is alive.
+     */
+    ByteView getData() const;
+
+    std::string getCurrentHash() const;
 
     MessageType getMessageType() const override;
 
 private:
-    std::string m_previousHash;
-    std::vector<std::uint8_t> m_data;
-    std::string m_currentHash;
+    static const std::size_t HASH_LENGTH = 32;
+
+    std::shared_ptr<const Message> m_message;
+    bool m_valid;
 };
 }    // namespace wolkabout
 
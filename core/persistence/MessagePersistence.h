@@ -17,6 +17,8 @@
 #ifndef MESSAGEPERSISTENCE_H
 #define MESSAGEPERSISTENCE_H
 
+#include <chrono>
+#include <cstddef>
 #include <memory>
 
 namespace wolkabout
@@ -55,6 +57,21 @@ public:
      */
     virtual void pop() = 0;
 
+    /**
+     * @brief Removes the given wolkabout::Message, previously returned by front(), if it is still in this storage.
+     * Unlike pop(), this does not remove another wolkabout::Message when the given one was meanwhile removed by
+     * removeOlderThan(). Storages that do not expire wolkabout::Messages can keep this default, which pops the first
+     * wolkabout::Message.
+     *
+     * @param message returned by front()
+     * @return {@code true} if the wolkabout::Message was removed
+     */
+    virtual bool remove(const std::shared_ptr<Message>& /* message */)
+    {
+        pop();
+        return true;
+    }
+
     /**
      * @brief Retrieves, first wolkabout::Message of this storage without removing it from storage.
      *
@@ -69,6 +86,15 @@ public:
      * @return {@code true} if this storage contains no wolkabout::Message
      */
     virtual bool empty() const = 0;
+
+    /**
+     * @brief Removes wolkabout::Messages that were inserted into this storage before the given time. Storages that do
+     * not keep the time of insertion keep all wolkabout::Messages.
+     *
+     * @param time before which the wolkabout::Messages expire
+     * @return number of removed wolkabout::Messages
+     */
+    virtual std::size_t removeOlderThan(std::chrono::system_clock::time_point /* time */) { return 0; }
 };
 }    // namespace wolkabout
 
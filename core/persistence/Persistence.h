@@ -22,6 +22,8 @@
 #include "core/model/Feed.h"
 #include "core/model/Reading.h"
 
+#include <chrono>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -69,6 +71,26 @@ public:
      */
     virtual std::vector<std::shared_ptr<Reading>> getReadings(const std::string& key, std::uint_fast64_t count) = 0;
 
+    /**
+     * @brief Visits first {@code count} wolkabout::Readings of this storage, associated with given {@code key},
+     * without copying them out of the storage. The wolkabout::Readings must not be kept past the call of the
+     * {@code visitor}.
+     *
+     * @param key     of the wolkabout::Readings
+     * @param count   number of items to peek
+     * @param visitor called for every wolkabout::Reading, starting from the head
+     * @return number of visited wolkabout::Readings, which can be less than {@code count} if this storage does not
+     * have requested number of elements
+     */
+    virtual std::size_t visitReadings(const std::string& key, std::uint_fast64_t count,
+                                      const std::function<void(const Reading&)>& visitor)
+    {
+        const auto readings = getReadings(key, count);
+        for (const auto& reading : readings)
+            visitor(*reading);
+        return readings.size();
+    }
+
     /**
      * @brief Removes first {@code count} wolkabout::Readings of this
      * storage, associated with given {@code key}.
@@ -78,6 +100,15 @@ public:
      */
     virtual void removeReadings(const std::string& key, std::uint_fast64_t count) = 0;
 
+    /**
+     * @brief Removes wolkabout::Readings, associated with any key, that were inserted into this storage before the
+     * given time. Storages that do not keep the time of insertion keep all wolkabout::Readings.
+     *
+     * @param time before which the wolkabout::Readings expire
+     * @return number of removed wolkabout::Readings
+     */
+    virtual std::size_t removeReadingsOlderThan(std::chrono::system_clock::time_point /* time */) { return 0; }
+
     /**
      * Returns {@code std::vector<std::string>>} of wolkabout::Readings keys
      * contained in this storage.
@@ -0,0 +1,116 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "core/persistence/RetentionService.h"
+
+#include "core/persistence/MessagePersistence.h"
+#include "core/persistence/Persistence.h"
+#include "core/utilities/Logger.h"
+
+namespace wolkabout
+{
+const std::chrono::milliseconds RetentionService::DEFAULT_CHECK_INTERVAL = std::chrono::minutes{1};
+
+RetentionService::RetentionService(std::chrono::milliseconds checkInterval)
+: m_checkInterval(checkInterval), m_retentionTime(0)
+{
+}
+
+RetentionService::~RetentionService()
+{
+    stop();
+}
+
+void RetentionService::addPersistence(std::shared_ptr<Persistence> persistence)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_persistences.emplace_back(std::move(persistence));
+}
+
+void RetentionService::addMessagePersistence(std::shared_ptr<MessagePersistence> messagePersistence)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_messagePersistences.emplace_back(std::move(messagePersistence));
+}
+
+void RetentionService::setRetentionTime(std::chrono::milliseconds retentionTime)
+{
+    LOG(INFO) << "Retention: Setting retention time " << retentionTime.count() << "ms";
+    m_retentionTime = retentionTime.count();
+}
+
+std::chrono::milliseconds RetentionService::getRetentionTime() const
+{
+    return std::chrono::milliseconds{m_retentionTime.load()};
+}
+
+bool RetentionService::applyParameter(const Parameter& parameter)
+{
+    if (parameter.first != ParameterName::OUTBOUND_DATA_RETENTION_TIME)
+        return false;
+
+    try
+    {
+        const auto minutes = std::stoll(parameter.second);
+        if (minutes < 0)
+        {
+            LOG(WARN) << "Retention: Ignoring negative retention time " << parameter.second;
+            return false;
+        }
+
+        setRetentionTime(std::chrono::minutes{minutes});
+        return true;
+    }
+    catch (...)
+    {
+        LOG(WARN) << "Retention: Ignoring invalid retention time " << parameter.second;
+        return false;
+    }
+}
+
+void RetentionService::start()
+{
+    m_timer.run(m_checkInterval, [this] { removeExpired(); });
+}
+
+void RetentionService::stop()
+{
+    m_timer.stop();
+}
+
+std::size_t RetentionService::removeExpired(std::chrono::system_clock::time_point now)
+{
+    const auto retentionTime = getRetentionTime();
+    if (retentionTime.count() <= 0)
+        return 0;
+
+    const auto expiry = now - retentionTime;
+    auto readings = std::size_t{0};
+    auto messages = std::size_t{0};
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        for (const auto& persistence : m_persistences)
+            readings += persistence->removeReadingsOlderThan(expiry);
+        for (const auto& messagePersistence : m_messagePersistences)
+            messages += messagePersistence->removeOlderThan(expiry);
+    }
+
+    if (readings != 0 || messages != 0)
+        LOG(INFO) << "Retention: Removed " << readings << " expired readings and " << messages << " expired messages";
+    return readings + messages;
+}
+}    // namespace wolkabout
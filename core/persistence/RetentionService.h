@@ -0,0 +1,102 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef RETENTIONSERVICE_H
+#define RETENTIONSERVICE_H
+
+#include "core/Types.h"
+#include "core/utilities/Service.h"
+#include "core/utilities/Timer.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace wolkabout
+{
+class MessagePersistence;
+class Persistence;
+
+/**
+ * @brief The RetentionService class
+ * Periodically removes the readings and messages that were kept in the persistences for longer than the retention
+ * time, so a device that stays offline does not fill up its memory or disk. Every run only looks at the data that
+ * expired since the previous one.
+ */
+class RetentionService : public Service
+{
+public:
+    /**
+     * Default constructor.
+     *
+     * @param checkInterval The interval at which the expired data is removed.
+     */
+    explicit RetentionService(std::chrono::milliseconds checkInterval = DEFAULT_CHECK_INTERVAL);
+
+    ~RetentionService() override;
+
+    void addPersistence(std::shared_ptr<Persistence> persistence);
+
+    void addMessagePersistence(std::shared_ptr<MessagePersistence> messagePersistence);
+
+    /**
+     * This method sets for how long the data is kept.
+     *
+     * @param retentionTime The retention time. Zero means the data is kept until it is removed from the persistence.
+     */
+    void setRetentionTime(std::chrono::milliseconds retentionTime);
+
+    std::chrono::milliseconds getRetentionTime() const;
+
+    /**
+     * This method applies the `OUTBOUND_DATA_RETENTION_TIME` parameter, whose value is the retention time in minutes.
+     *
+     * @param parameter The parameter received from the platform.
+     * @return Whether the parameter was the retention time with a valid value.
+     */
+    bool applyParameter(const Parameter& parameter);
+
+    void start() override;
+
+    void stop() override;
+
+    /**
+     * This method removes the data that expired by the given time from all the persistences.
+     *
+     * @param now The current time.
+     * @return The number of removed readings and messages.
+     */
+    std::size_t removeExpired(std::chrono::system_clock::time_point now = std::chrono::system_clock::now());
+
+    static const std::chrono::milliseconds DEFAULT_CHECK_INTERVAL;
+
+private:
+    const std::chrono::milliseconds m_checkInterval;
+    std::atomic<std::int64_t> m_retentionTime;
+
+    std::mutex m_mutex;
+    std::vector<std::shared_ptr<Persistence>> m_persistences;
+    std::vector<std::shared_ptr<MessagePersistence>> m_messagePersistences;
+
+    Timer m_timer;
+};
+}    // namespace wolkabout
+
+#endif
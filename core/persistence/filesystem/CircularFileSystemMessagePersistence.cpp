@@ -20,12 +20,17 @@
 #include "core/utilities/FileSystemUtils.h"
 #include "core/utilities/Logger.h"
 
+namespace
+{
+const std::string METRIC_BACKEND = "circular_filesystem";
+}    // namespace
+
 namespace wolkabout
 {
 CircularFileSystemMessagePersistence::CircularFileSystemMessagePersistence(const std::string& persistPath,
                                                                            PersistenceMethod method,
                                                                            unsigned sizeLimitBytes)
-: FileSystemMessagePersistence(persistPath, method), m_sizeLimitBytes{sizeLimitBytes}
+: FileSystemMessagePersistence(persistPath, method, METRIC_BACKEND), m_sizeLimitBytes{sizeLimitBytes}
 {
     loadFileSize();
 }
@@ -65,6 +70,31 @@ void CircularFileSystemMessagePersistence::pop()
     m_method == PersistenceMethod::FIFO ? deleteFirstReading() : deleteLastReading();
 }
 
+bool CircularFileSystemMessagePersistence::remove(const std::shared_ptr<Message>& message)
+{
+    std::lock_guard<decltype(m_mutex)> guard{m_mutex};
+
+    const auto size =
+      m_loadedReading.empty() ? 0 : static_cast<unsigned>(FileSystemUtils::getFileSize(readingPath(m_loadedReading)));
+    if (!FileSystemMessagePersistence::remove(message))
+        return false;
+
+    m_totalFileSize = size > m_totalFileSize ? 0 : m_totalFileSize - size;
+    return true;
+}
+
+std::size_t CircularFileSystemMessagePersistence::removeOlderThan(std::chrono::system_clock::time_point time)
+{
+    std::lock_guard<decltype(m_mutex)> guard{m_mutex};
+
+    auto removedBytes = std::uint64_t{0};
+    const auto removed = removeReadingsOlderThan(time, removedBytes);
+
+    m_totalFileSize = removedBytes > m_totalFileSize ? 0 : m_totalFileSize - removedBytes;
+
+    return removed;
+}
+
 void CircularFileSystemMessagePersistence::setSizeLimit(unsigned bytes)
 {
     LOG(INFO) << "Circular Persistence: Setting size limit " << bytes;
@@ -93,9 +123,16 @@ void CircularFileSystemMessagePersistence::checkSizeAndNormalize()
     {
         LOG(INFO) << "Circular Persistence: Size over limit " << m_totalFileSize;
 
+        const auto reading = m_method == PersistenceMethod::FIFO ? lastReading() : firstReading();
+        const auto size = FileSystemUtils::getFileSize(readingPath(reading));
+        const auto count = m_readingFiles.size();
+
         m_method == PersistenceMethod::FIFO ? deleteLastReading() : deleteFirstReading();
+        if (m_readingFiles.size() == count)
+            break;
 
-        loadFileSize();
+        m_droppedMessages.increment();
+        m_totalFileSize = size > m_totalFileSize ? 0 : m_totalFileSize - size;
     }
 }
 }    // namespace wolkabout
@@ -33,6 +33,8 @@ public:
 
     bool push(std::shared_ptr<Message> message) override;
     void pop() override;
+    bool remove(const std::shared_ptr<Message>& message) override;
+    std::size_t removeOlderThan(std::chrono::system_clock::time_point time) override;
 
     void setSizeLimit(unsigned bytes);
 
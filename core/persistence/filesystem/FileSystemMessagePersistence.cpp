@@ -20,23 +20,43 @@
 #include "core/utilities/FileSystemUtils.h"
 #include "core/utilities/Logger.h"
 
+#include <algorithm>
+#include <iterator>
 #include <regex>
 
 namespace
 {
 const std::string READING_FILE_NAME = "reading_";
 const std::string REGEX = READING_FILE_NAME + "(\\d+)";
+const std::string METRIC_BACKEND = "filesystem";
 }    // namespace
 
 namespace wolkabout
 {
 FileSystemMessagePersistence::FileSystemMessagePersistence(std::string persistPath, PersistenceMethod method)
-: m_persister(new MessagePersister()), m_persistPath(std::move(persistPath)), m_method(method), m_messageNum(0)
+: FileSystemMessagePersistence(std::move(persistPath), method, METRIC_BACKEND)
+{
+}
+
+FileSystemMessagePersistence::FileSystemMessagePersistence(std::string persistPath, PersistenceMethod method,
+                                                           const std::string& backend)
+: m_persister(new MessagePersister())
+, m_persistPath(std::move(persistPath))
+, m_method(method)
+, m_messageNum(0)
+, m_persistedMessages(MetricsRegistry::getInstance().gauge(
+    "wolkabout_persisted_messages", "Messages waiting in a persistence", {{"backend", backend}}))
+, m_droppedMessages(MetricsRegistry::getInstance().counter(
+    "wolkabout_persistence_dropped_messages_total", "Messages dropped unsent by a persistence", {{"backend", backend}}))
 {
     initialize();
 }
 
-FileSystemMessagePersistence::~FileSystemMessagePersistence() = default;
+FileSystemMessagePersistence::~FileSystemMessagePersistence()
+{
+    // The files stay on the disk, but this instance stops counting them
+    m_persistedMessages.add(-static_cast<std::int64_t>(m_readingFiles.size()));
+}
 
 bool FileSystemMessagePersistence::push(std::shared_ptr<Message> message)
 {
@@ -79,7 +99,24 @@ std::shared_ptr<Message> FileSystemMessagePersistence::front()
         return nullptr;
     }
 
-    return m_persister->load(messageContent);
+    auto message = std::shared_ptr<Message>{m_persister->load(messageContent)};
+    m_loadedReading = reading;
+    m_loadedMessage = message;
+    return message;
+}
+
+bool FileSystemMessagePersistence::remove(const std::shared_ptr<Message>& message)
+{
+    std::lock_guard<decltype(m_mutex)> guard{m_mutex};
+    if (message == nullptr || m_loadedMessage.lock() != message)
+        return false;
+
+    // The reading is forgotten if it expires after it was loaded, as its file name can be given to a new one
+    const auto reading = std::find(m_readingFiles.begin(), m_readingFiles.end(), m_loadedReading);
+    if (reading == m_readingFiles.end())
+        return false;
+
+    return deleteReading(reading);
 }
 
 bool FileSystemMessagePersistence::empty() const
@@ -88,6 +125,40 @@ bool FileSystemMessagePersistence::empty() const
     return m_readingFiles.empty();
 }
 
+std::size_t FileSystemMessagePersistence::removeOlderThan(std::chrono::system_clock::time_point time)
+{
+    std::lock_guard<decltype(m_mutex)> guard{m_mutex};
+    auto removedBytes = std::uint64_t{0};
+    return removeReadingsOlderThan(time, removedBytes);
+}
+
+std::size_t FileSystemMessagePersistence::removeReadingsOlderThan(std::chrono::system_clock::time_point time,
+                                                                 std::uint64_t& removedBytes)
+{
+    // The readings are numbered in the order they were persisted, so the oldest ones are always at the front
+    auto removed = std::size_t{0};
+    while (!m_readingFiles.empty())
+    {
+        const auto path = readingPath(m_readingFiles.front());
+        if (std::chrono::system_clock::from_time_t(FileSystemUtils::getLastModified(path)) >= time)
+            break;
+
+        const auto size = FileSystemUtils::getFileSize(path);
+        const auto count = m_readingFiles.size();
+        deleteFirstReading();
+        if (m_readingFiles.size() == count)
+            break;
+
+        removedBytes += size;
+        ++removed;
+    }
+
+    if (removed != 0)
+        LOG(INFO) << "Removed " << removed << " expired readings";
+    m_droppedMessages.increment(removed);
+    return removed;
+}
+
 std::string FileSystemMessagePersistence::saveToDisk(const std::shared_ptr<Message>& message)
 {
     const std::string fileName = READING_FILE_NAME + std::to_string(++m_messageNum);
@@ -147,6 +218,7 @@ void FileSystemMessagePersistence::initialize()
             }
 
             std::copy(files.begin(), files.end(), std::back_inserter(m_readingFiles));
+            m_persistedMessages.add(static_cast<std::int64_t>(files.size()));
         }
     }
     else
@@ -161,6 +233,7 @@ void FileSystemMessagePersistence::initialize()
 void FileSystemMessagePersistence::saveReading(const std::string& fileName)
 {
     m_readingFiles.push_back(fileName);
+    m_persistedMessages.increment();
 }
 
 std::string FileSystemMessagePersistence::readingPath(const std::string& readingFileName) const
@@ -170,41 +243,38 @@ std::string FileSystemMessagePersistence::readingPath(const std::string& reading
 
 void FileSystemMessagePersistence::deleteFirstReading()
 {
-    const std::string path = readingPath(m_readingFiles.front());
-
-    LOG(INFO) << "Deleting reading " << m_readingFiles.front();
-    if (FileSystemUtils::deleteFile(path))
-    {
-        m_readingFiles.pop_front();
-
-        if (m_readingFiles.empty())
-        {
-            m_messageNum = 0;
-        }
-    }
-    else
-    {
-        LOG(ERROR) << "Failed to delete readings file " << m_readingFiles.front();
-    }
+    deleteReading(m_readingFiles.begin());
 }
 
 void FileSystemMessagePersistence::deleteLastReading()
 {
-    const std::string path = readingPath(m_readingFiles.back());
+    deleteReading(std::prev(m_readingFiles.end()));
+}
+
+bool FileSystemMessagePersistence::deleteReading(std::list<std::string>::iterator reading)
+{
+    const std::string path = readingPath(*reading);
 
-    LOG(INFO) << "Deleting reading " << m_readingFiles.back();
-    if (FileSystemUtils::deleteFile(path))
+    LOG(INFO) << "Deleting reading " << *reading;
+    if (!FileSystemUtils::deleteFile(path))
     {
-        m_readingFiles.pop_back();
-        if (m_readingFiles.empty())
-        {
-            m_messageNum = 0;
-        }
+        LOG(ERROR) << "Failed to delete readings file " << *reading;
+        return false;
     }
-    else
+
+    if (*reading == m_loadedReading)
+    {
+        m_loadedReading.clear();
+        m_loadedMessage.reset();
+    }
+
+    m_readingFiles.erase(reading);
+    m_persistedMessages.decrement();
+    if (m_readingFiles.empty())
     {
-        LOG(ERROR) << "Failed to delete readings file " << m_readingFiles.front();
+        m_messageNum = 0;
     }
+    return true;
 }
 
 std::string FileSystemMessagePersistence::firstReading()
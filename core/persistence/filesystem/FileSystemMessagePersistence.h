@@ -18,8 +18,11 @@
 #define FILESYSTEMMESSAGEPERSISTENCE_H
 
 #include "core/persistence/MessagePersistence.h"
+#include "core/utilities/Metrics.h"
 
+#include <cstdint>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <queue>
 
@@ -39,15 +42,29 @@ public:
 
     bool push(std::shared_ptr<Message> message) override;
     void pop() override;
+    bool remove(const std::shared_ptr<Message>& message) override;
     std::shared_ptr<Message> front() override;
     bool empty() const override;
+    std::size_t removeOlderThan(std::chrono::system_clock::time_point time) override;
 
 protected:
+    /**
+     * Constructor for the persistences built on this one, whose metrics are labelled by a backend of their own.
+     *
+     * @param persistPath The directory the messages are persisted in.
+     * @param method The order the messages are sent in.
+     * @param backend The backend label of the metrics.
+     */
+    FileSystemMessagePersistence(std::string persistPath, PersistenceMethod method, const std::string& backend);
+
     void initialize();
 
+    std::size_t removeReadingsOlderThan(std::chrono::system_clock::time_point time, std::uint64_t& removedBytes);
+
     void saveReading(const std::string& fileName);
     void deleteFirstReading();
     void deleteLastReading();
+    bool deleteReading(std::list<std::string>::iterator reading);
 
     std::string firstReading();
     std::string lastReading();
@@ -64,6 +81,13 @@ protected:
     PersistenceMethod m_method;
     std::list<std::string> m_readingFiles;
     unsigned long m_messageNum;
+
+    // The reading the message last returned by front() was loaded from
+    std::string m_loadedReading;
+    std::weak_ptr<Message> m_loadedMessage;
+
+    Gauge& m_persistedMessages;
+    Counter& m_droppedMessages;
 };
 }    // namespace wolkabout
 
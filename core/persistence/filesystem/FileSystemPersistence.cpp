@@ -0,0 +1,732 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "core/persistence/filesystem/FileSystemPersistence.h"
+
+#include "core/utilities/ByteUtils.h"
+#include "core/utilities/FileSystemUtils.h"
+#include "core/utilities/Logger.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <iterator>
+#include <regex>
+#include <unistd.h>
+
+namespace
+{
+const std::string READINGS_FILE_PREFIX = "readings_";
+const std::string READINGS_FILE_EXTENSION = ".log";
+const std::string READINGS_FILE_REGEX = READINGS_FILE_PREFIX + "([0-9a-f]*)_(\\d+)\\" + READINGS_FILE_EXTENSION;
+const std::string HEADS_FILE = "readings.heads";
+const std::string ATTRIBUTES_FILE = "attributes";
+const std::string PARAMETERS_FILE = "parameters";
+const std::string TEMPORARY_FILE_EXTENSION = ".part";
+
+// A log is rewritten without the removed readings once they take up this much and at least half of the log
+const std::uint64_t COMPACTION_THRESHOLD = 1024 * 1024;
+const std::size_t COPY_BUFFER_SIZE = 64 * 1024;
+
+/**
+ * Records are a sequence of fields written as "<length>:<bytes>", ended with a new line. The lengths make them safe
+ * for any content, and a record that was cut short by a crash is recognized by its missing end.
+ */
+void appendField(std::string& record, const std::string& field)
+{
+    record += std::to_string(field.size());
+    record += ':';
+    record += field;
+}
+
+bool readRecord(std::istream& stream, std::uint64_t end, std::vector<std::string>& fields)
+{
+    fields.clear();
+    while (true)
+    {
+        const auto next = stream.peek();
+        if (next == std::char_traits<char>::eof())
+            return false;
+        if (next == '\n')
+        {
+            stream.get();
+            return true;
+        }
+
+        auto length = std::uint64_t{0};
+        auto digits = 0;
+        char character = 0;
+        while (stream.get(character) && std::isdigit(static_cast<unsigned char>(character)) && digits < 20)
+        {
+            length = length * 10 + static_cast<std::uint64_t>(character - '0');
+            ++digits;
+        }
+        if (!stream || character != ':' || digits == 0 ||
+            static_cast<std::uint64_t>(stream.tellg()) + length > end)
+            return false;
+
+        auto field = std::string(static_cast<std::size_t>(length), '\0');
+        if (!stream.read(&field[0], static_cast<std::streamsize>(length)))
+            return false;
+        fields.emplace_back(std::move(field));
+    }
+}
+
+bool parseNumber(const std::string& text, std::uint64_t& number)
+{
+    if (text.empty() || !std::all_of(text.cbegin(), text.cend(), [](char c) { return std::isdigit(c) != 0; }))
+        return false;
+
+    try
+    {
+        number = std::stoull(text);
+        return true;
+    }
+    catch (...)
+    {
+        return false;
+    }
+}
+
+std::string toHex(const std::string& text)
+{
+    return wolkabout::ByteUtils::toHexString(wolkabout::ByteUtils::toByteArray(text));
+}
+
+std::string fromHex(const std::string& hex)
+{
+    auto text = std::string{};
+    for (std::size_t i = 0; i + 1 < hex.size(); i += 2)
+        text += static_cast<char>(std::stoi(hex.substr(i, 2), nullptr, 16));
+    return text;
+}
+
+std::uint64_t toMilliseconds(std::chrono::system_clock::time_point time)
+{
+    return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count());
+}
+
+bool writeAll(int descriptor, const std::string& content)
+{
+    auto written = std::size_t{0};
+    while (written < content.size())
+    {
+        const auto result = ::write(descriptor, content.data() + written, content.size() - written);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        written += static_cast<std::size_t>(result);
+    }
+    return true;
+}
+
+/**
+ * The file is written next to its destination, synced, and renamed over it, so a crash leaves either the old or the
+ * new content.
+ */
+bool replaceFile(const std::string& path, const std::string& content)
+{
+    const auto temporaryPath = path + TEMPORARY_FILE_EXTENSION;
+    const auto descriptor = ::open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (descriptor < 0)
+        return false;
+
+    const auto written = writeAll(descriptor, content) && ::fsync(descriptor) == 0;
+    ::close(descriptor);
+    if (!written || std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+    {
+        wolkabout::FileSystemUtils::deleteFile(temporaryPath);
+        return false;
+    }
+    return true;
+}
+
+std::vector<std::vector<std::string>> readRecords(const std::string& path)
+{
+    auto records = std::vector<std::vector<std::string>>{};
+    if (!wolkabout::FileSystemUtils::isFilePresent(path))
+        return records;
+
+    auto stream = std::ifstream{path, std::ios::binary};
+    const auto end = wolkabout::FileSystemUtils::getFileSize(path);
+    auto fields = std::vector<std::string>{};
+    while (readRecord(stream, end, fields))
+        records.emplace_back(fields);
+    return records;
+}
+
+std::string toRecord(const wolkabout::Reading& reading, std::chrono::system_clock::time_point persistedAt)
+{
+    auto record = std::string{};
+    appendField(record, std::to_string(toMilliseconds(persistedAt)));
+    appendField(record, std::to_string(reading.getTimestamp()));
+    appendField(record, reading.getReference());
+    for (const auto& value : reading.getStringValues())
+        appendField(record, value);
+    record += '\n';
+    return record;
+}
+}    // namespace
+
+namespace wolkabout
+{
+const std::size_t FileSystemPersistence::DEFAULT_SYNC_INTERVAL = 100;
+
+FileSystemPersistence::FileSystemPersistence(std::string persistPath, std::size_t syncInterval)
+: m_persistPath(std::move(persistPath))
+, m_syncInterval(std::max<std::size_t>(syncInterval, 1))
+, m_unsyncedReadings(0)
+, m_headsChanged(false)
+{
+    if (!FileSystemUtils::isDirectoryPresent(m_persistPath) && !FileSystemUtils::createDirectory(m_persistPath))
+    {
+        LOG(ERROR) << "Could not create persist directory: " << m_persistPath;
+        return;
+    }
+
+    loadReadings();
+    loadAttributes();
+    loadParameters();
+}
+
+FileSystemPersistence::~FileSystemPersistence()
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    syncReadings();
+    for (auto& pair : m_readings)
+        closeLog(pair.second);
+}
+
+void FileSystemPersistence::sync()
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    syncReadings();
+}
+
+bool FileSystemPersistence::putReading(const std::string& key, const Reading& reading)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto& log = m_readings[key];
+    if (!openLog(key, log))
+        return false;
+
+    const auto record = toRecord(reading, std::chrono::system_clock::now());
+    if (!writeAll(log.descriptor, record))
+    {
+        LOG(ERROR) << "Failed to persist reading for key " << key;
+        // Whatever part of the record got written is cut off, so the next record starts cleanly
+        if (::ftruncate(log.descriptor, static_cast<off_t>(log.size)) != 0)
+            LOG(ERROR) << "Failed to truncate the readings log for key " << key;
+        return false;
+    }
+
+    log.size += record.size();
+    ++log.count;
+    log.unsynced = true;
+    if (++m_unsyncedReadings >= m_syncInterval)
+        syncReadings();
+    return true;
+}
+
+std::vector<std::shared_ptr<Reading>> FileSystemPersistence::getReadings(const std::string& key,
+                                                                         std::uint_fast64_t count)
+{
+    auto readings = std::vector<std::shared_ptr<Reading>>{};
+    visitReadings(key, count,
+                  [&](const Reading& reading) { readings.emplace_back(std::make_shared<Reading>(reading)); });
+    return readings;
+}
+
+std::size_t FileSystemPersistence::visitReadings(const std::string& key, std::uint_fast64_t count,
+                                                 const std::function<void(const Reading&)>& visitor)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    const auto it = m_readings.find(key);
+    if (it == m_readings.cend() || it->second.count == 0 || count == 0)
+        return 0;
+
+    const auto& log = it->second;
+    auto stream = std::ifstream{logPath(key, log.generation), std::ios::binary};
+    stream.seekg(static_cast<std::streamoff>(log.head));
+
+    auto visited = std::size_t{0};
+    auto fields = std::vector<std::string>{};
+    while (visited < count && readRecord(stream, log.size, fields))
+    {
+        auto timestamp = std::uint64_t{0};
+        if (fields.size() < 3 || !parseNumber(fields[1], timestamp))
+        {
+            LOG(ERROR) << "Invalid reading in the readings log for key " << key;
+            break;
+        }
+
+        visitor(Reading{fields[2], std::vector<std::string>(fields.begin() + 3, fields.end()), timestamp});
+        ++visited;
+    }
+    return visited;
+}
+
+void FileSystemPersistence::removeReadings(const std::string& key, std::uint_fast64_t count)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    const auto it = m_readings.find(key);
+    if (it == m_readings.end() || it->second.count == 0 || count == 0)
+        return;
+
+    consumeReadings(it->first, it->second, count, std::chrono::system_clock::time_point::max());
+}
+
+std::size_t FileSystemPersistence::removeReadingsOlderThan(std::chrono::system_clock::time_point time)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto removed = std::size_t{0};
+    for (auto& pair : m_readings)
+    {
+        if (pair.second.count != 0)
+            removed += consumeReadings(pair.first, pair.second, pair.second.count, time);
+    }
+    return removed;
+}
+
+std::vector<std::string> FileSystemPersistence::getReadingsKeys()
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    std::vector<std::string> keys;
+    for (const auto& pair : m_readings)
+    {
+        if (pair.second.count != 0)
+        {
+            keys.push_back(pair.first);
+        }
+    }
+
+    return keys;
+}
+
+bool FileSystemPersistence::putAttribute(const std::string& key, std::shared_ptr<Attribute> attribute)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_attributes[key] = std::move(attribute);
+    saveAttributes();
+    return true;
+}
+
+std::map<std::string, std::shared_ptr<Attribute>> FileSystemPersistence::getAttributes()
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_attributes;
+}
+
+std::shared_ptr<Attribute> FileSystemPersistence::getAttributeUnderKey(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    const auto it = m_attributes.find(key);
+    if (it == m_attributes.cend())
+        return {};
+    return it->second;
+}
+
+void FileSystemPersistence::removeAttributes()
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_attributes.clear();
+    saveAttributes();
+}
+
+void FileSystemPersistence::removeAttributes(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    if (m_attributes.erase(key) != 0)
+        saveAttributes();
+}
+
+std::vector<std::string> FileSystemPersistence::getAttributeKeys()
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto keys = std::vector<std::string>{};
+    keys.reserve(m_attributes.size());
+    std::transform(m_attributes.cbegin(), m_attributes.cend(), std::back_inserter(keys),
+                   [&](const std::pair<const std::string, std::shared_ptr<Attribute>>& pair) { return pair.first; });
+    return keys;
+}
+
+bool FileSystemPersistence::putParameter(const std::string& key, Parameter parameter)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_parameters[key] = std::move(parameter);
+    saveParameters();
+    return true;
+}
+
+std::map<std::string, Parameter> FileSystemPersistence::getParameters()
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_parameters;
+}
+
+Parameter FileSystemPersistence::getParameterForKey(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    const auto it = m_parameters.find(key);
+    if (it == m_parameters.cend())
+        return {};
+    return it->second;
+}
+
+void FileSystemPersistence::removeParameters()
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_parameters.clear();
+    saveParameters();
+}
+
+void FileSystemPersistence::removeParameters(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    if (m_parameters.erase(key) != 0)
+        saveParameters();
+}
+
+std::vector<std::string> FileSystemPersistence::getParameterKeys()
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto keys = std::vector<std::string>{};
+    keys.reserve(m_parameters.size());
+    std::transform(m_parameters.cbegin(), m_parameters.cend(), std::back_inserter(keys),
+                   [&](const std::pair<const std::string, Parameter>& pair) { return pair.first; });
+    return keys;
+}
+
+bool FileSystemPersistence::isEmpty()
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    const auto readingsEmpty =
+      std::all_of(m_readings.cbegin(), m_readings.cend(),
+                  [](const std::pair<const std::string, ReadingsLog>& pair) { return pair.second.count == 0; });
+    return readingsEmpty && m_attributes.empty() && m_parameters.empty();
+}
+
+void FileSystemPersistence::loadReadings()
+{
+    for (const auto& record : readRecords(FileSystemUtils::composePath(HEADS_FILE, m_persistPath)))
+    {
+        auto log = ReadingsLog{};
+        if (record.size() != 3 || !parseNumber(record[1], log.generation) || !parseNumber(record[2], log.head))
+        {
+            LOG(WARN) << "Invalid entry in the readings heads file";
+            continue;
+        }
+        m_readings[record[0]] = log;
+    }
+
+    // Every key keeps the log its head points to, and the logs of interrupted compactions are dropped
+    auto files = std::map<std::string, std::vector<std::pair<std::uint64_t, std::string>>>{};
+    const auto fileRegex = std::regex{READINGS_FILE_REGEX};
+    for (const auto& file : FileSystemUtils::listFiles(m_persistPath))
+    {
+        auto match = std::smatch{};
+        auto generation = std::uint64_t{0};
+        if (std::regex_match(file, match, fileRegex) && parseNumber(match[2].str(), generation))
+            files[fromHex(match[1].str())].emplace_back(generation, file);
+        else if (file.size() > TEMPORARY_FILE_EXTENSION.size() &&
+                 file.compare(file.size() - TEMPORARY_FILE_EXTENSION.size(), std::string::npos,
+                              TEMPORARY_FILE_EXTENSION) == 0)
+            FileSystemUtils::deleteFile(FileSystemUtils::composePath(file, m_persistPath));
+    }
+
+    for (auto& pair : files)
+    {
+        const auto known = m_readings.find(pair.first) != m_readings.cend();
+        auto& log = m_readings[pair.first];
+        if (!known)
+            log.generation = std::min_element(pair.second.cbegin(), pair.second.cend())->first;
+
+        for (const auto& file : pair.second)
+        {
+            if (file.first != log.generation)
+                FileSystemUtils::deleteFile(FileSystemUtils::composePath(file.second, m_persistPath));
+        }
+    }
+
+    for (auto& pair : m_readings)
+    {
+        auto& log = pair.second;
+        const auto path = logPath(pair.first, log.generation);
+        if (!FileSystemUtils::isFilePresent(path))
+        {
+            log.head = 0;
+            continue;
+        }
+
+        log.size = FileSystemUtils::getFileSize(path);
+        log.head = std::min(log.head, log.size);
+
+        auto stream = std::ifstream{path, std::ios::binary};
+        stream.seekg(static_cast<std::streamoff>(log.head));
+        auto end = log.head;
+        auto fields = std::vector<std::string>{};
+        while (readRecord(stream, log.size, fields))
+        {
+            end = static_cast<std::uint64_t>(stream.tellg());
+            ++log.count;
+        }
+
+        if (end != log.size)
+        {
+            LOG(WARN) << "Dropping an incomplete reading at the end of the readings log for key " << pair.first;
+            if (::truncate(path.c_str(), static_cast<off_t>(end)) != 0)
+                LOG(ERROR) << "Failed to truncate the readings log for key " << pair.first;
+            log.size = end;
+        }
+    }
+
+    LOG(INFO) << "Loaded readings for " << m_readings.size() << " keys from " << m_persistPath;
+}
+
+void FileSystemPersistence::loadAttributes()
+{
+    for (const auto& record : readRecords(FileSystemUtils::composePath(ATTRIBUTES_FILE, m_persistPath)))
+    {
+        if (record.size() != 4)
+        {
+            LOG(WARN) << "Invalid entry in the attributes file";
+            continue;
+        }
+        m_attributes[record[0]] = std::make_shared<Attribute>(record[1], dataTypeFromString(record[2]), record[3]);
+    }
+}
+
+void FileSystemPersistence::loadParameters()
+{
+    for (const auto& record : readRecords(FileSystemUtils::composePath(PARAMETERS_FILE, m_persistPath)))
+    {
+        if (record.size() != 3)
+        {
+            LOG(WARN) << "Invalid entry in the parameters file";
+            continue;
+        }
+        m_parameters[record[0]] = Parameter{parameterNameFromString(record[1]), record[2]};
+    }
+}
+
+bool FileSystemPersistence::saveHeads()
+{
+    auto content = std::string{};
+    for (const auto& pair : m_readings)
+    {
+        appendField(content, pair.first);
+        appendField(content, std::to_string(pair.second.generation));
+        appendField(content, std::to_string(pair.second.head));
+        content += '\n';
+    }
+
+    if (!replaceFile(FileSystemUtils::composePath(HEADS_FILE, m_persistPath), content))
+    {
+        LOG(ERROR) << "Failed to save the readings heads in " << m_persistPath;
+        return false;
+    }
+
+    m_headsChanged = false;
+    return true;
+}
+
+void FileSystemPersistence::saveAttributes()
+{
+    auto content = std::string{};
+    for (const auto& pair : m_attributes)
+    {
+        appendField(content, pair.first);
+        appendField(content, pair.second->getName());
+        appendField(content, toString(pair.second->getDataType()));
+        appendField(content, pair.second->getValue());
+        content += '\n';
+    }
+
+    if (!replaceFile(FileSystemUtils::composePath(ATTRIBUTES_FILE, m_persistPath), content))
+        LOG(ERROR) << "Failed to save the attributes in " << m_persistPath;
+}
+
+void FileSystemPersistence::saveParameters()
+{
+    auto content = std::string{};
+    for (const auto& pair : m_parameters)
+    {
+        appendField(content, pair.first);
+        appendField(content, toString(pair.second.first));
+        appendField(content, pair.second.second);
+        content += '\n';
+    }
+
+    if (!replaceFile(FileSystemUtils::composePath(PARAMETERS_FILE, m_persistPath), content))
+        LOG(ERROR) << "Failed to save the parameters in " << m_persistPath;
+}
+
+void FileSystemPersistence::syncReadings()
+{
+    for (auto& pair : m_readings)
+    {
+        auto& log = pair.second;
+        if (!log.unsynced || log.descriptor < 0)
+            continue;
+
+        if (::fsync(log.descriptor) != 0)
+            LOG(ERROR) << "Failed to sync the readings log for key " << pair.first;
+        log.unsynced = false;
+    }
+    m_unsyncedReadings = 0;
+
+    // The heads are saved only after the readings they point past are on the disk
+    if (m_headsChanged)
+        saveHeads();
+}
+
+bool FileSystemPersistence::openLog(const std::string& key, ReadingsLog& log)
+{
+    if (log.descriptor >= 0)
+        return true;
+
+    const auto path = logPath(key, log.generation);
+    log.descriptor = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (log.descriptor < 0)
+    {
+        LOG(ERROR) << "Failed to open the readings log " << path;
+        return false;
+    }
+    return true;
+}
+
+void FileSystemPersistence::closeLog(ReadingsLog& log)
+{
+    if (log.descriptor < 0)
+        return;
+
+    ::close(log.descriptor);
+    log.descriptor = -1;
+}
+
+std::size_t FileSystemPersistence::consumeReadings(const std::string& key, ReadingsLog& log, std::uint64_t count,
+                                                   std::chrono::system_clock::time_point persistedBefore)
+{
+    auto consumed = std::size_t{0};
+    if (count >= log.count && persistedBefore == std::chrono::system_clock::time_point::max())
+    {
+        consumed = static_cast<std::size_t>(log.count);
+        log.head = log.size;
+        log.count = 0;
+    }
+    else
+    {
+        // The readings are appended in the order they were inserted, so the scan stops at the first one to keep
+        const auto limit = toMilliseconds(persistedBefore);
+        auto stream = std::ifstream{logPath(key, log.generation), std::ios::binary};
+        stream.seekg(static_cast<std::streamoff>(log.head));
+
+        auto fields = std::vector<std::string>{};
+        auto persistedAt = std::uint64_t{0};
+        while (consumed < count && readRecord(stream, log.size, fields) && !fields.empty() &&
+               parseNumber(fields[0], persistedAt) && persistedAt < limit)
+        {
+            log.head = static_cast<std::uint64_t>(stream.tellg());
+            --log.count;
+            ++consumed;
+        }
+    }
+
+    if (consumed == 0)
+        return 0;
+    m_headsChanged = true;
+
+    if (log.head == log.size || (log.head >= COMPACTION_THRESHOLD && log.head * 2 >= log.size))
+        compactLog(key, log);
+    return consumed;
+}
+
+void FileSystemPersistence::compactLog(const std::string& key, ReadingsLog& log)
+{
+    const auto path = logPath(key, log.generation);
+    const auto compactedPath = logPath(key, log.generation + 1);
+
+    // The remaining readings are copied into the log of the next generation, which is synced before the heads
+    // switch over to it
+    auto descriptor = -1;
+    if (log.count != 0)
+    {
+        descriptor = ::open(compactedPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+        if (descriptor < 0)
+        {
+            LOG(ERROR) << "Failed to open the readings log " << compactedPath;
+            return;
+        }
+
+        auto stream = std::ifstream{path, std::ios::binary};
+        stream.seekg(static_cast<std::streamoff>(log.head));
+        auto buffer = std::string(COPY_BUFFER_SIZE, '\0');
+        auto copied = true;
+        while (copied && stream.read(&buffer[0], static_cast<std::streamsize>(buffer.size())).gcount() > 0)
+        {
+            buffer.resize(static_cast<std::size_t>(stream.gcount()));
+            copied = writeAll(descriptor, buffer);
+            buffer.resize(COPY_BUFFER_SIZE);
+        }
+
+        if (!copied || ::fsync(descriptor) != 0)
+        {
+            LOG(ERROR) << "Failed to compact the readings log " << path;
+            ::close(descriptor);
+            FileSystemUtils::deleteFile(compactedPath);
+            return;
+        }
+    }
+
+    // The compacted log is used only once the heads on the disk point to it, otherwise a restart would go back to
+    // the old log and lose whatever was appended to the compacted one
+    auto previous = log;
+    ++log.generation;
+    log.size -= log.head;
+    log.head = 0;
+    log.unsynced = false;
+    log.descriptor = -1;
+    if (!saveHeads())
+    {
+        LOG(ERROR) << "Failed to switch over to the compacted readings log " << compactedPath;
+        log = previous;
+        if (descriptor >= 0)
+        {
+            ::close(descriptor);
+            FileSystemUtils::deleteFile(compactedPath);
+        }
+        return;
+    }
+
+    closeLog(previous);
+    log.descriptor = descriptor;
+    FileSystemUtils::deleteFile(path);
+}
+
+std::string FileSystemPersistence::logPath(const std::string& key, std::uint64_t generation) const
+{
+    return FileSystemUtils::composePath(
+      READINGS_FILE_PREFIX + toHex(key) + "_" + std::to_string(generation) + READINGS_FILE_EXTENSION, m_persistPath);
+}
+}    // namespace wolkabout
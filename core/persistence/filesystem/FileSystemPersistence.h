@@ -0,0 +1,145 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef FILESYSTEMPERSISTENCE_H
+#define FILESYSTEMPERSISTENCE_H
+
+#include "core/persistence/Persistence.h"
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace wolkabout
+{
+/**
+ * @brief The FileSystemPersistence class
+ * Persists readings, attributes and parameters on file system, so they outlive a restart of the application.
+ *
+ * Readings of every key are appended to their own log, and removing them only moves the head of the log forward.
+ * Once the consumed readings take up most of a log, the log is rewritten without them. The logs are synced to the
+ * disk after every `syncInterval` readings, on `sync` and on destruction, so a crash loses at most the readings since
+ * the last sync, and readings removed since the last sync can be returned again after a restart. Every reading is
+ * stored with the time it was inserted, which is what `removeReadingsOlderThan` looks at.
+ * Attributes and parameters are rewritten whole on every change.
+ */
+class FileSystemPersistence : public Persistence
+{
+public:
+    /**
+     * Default constructor.
+     *
+     * @param persistPath The directory where the data is kept. It is created if it does not exist.
+     * @param syncInterval The number of readings appended between two syncs to the disk.
+     */
+    explicit FileSystemPersistence(std::string persistPath, std::size_t syncInterval = DEFAULT_SYNC_INTERVAL);
+
+    ~FileSystemPersistence() override;
+
+    /**
+     * This method syncs the appended readings and the heads of the logs to the disk.
+     */
+    void sync();
+
+    bool putReading(const std::string& key, const Reading& reading) override;
+
+    std::vector<std::shared_ptr<Reading>> getReadings(const std::string& key, std::uint_fast64_t count) override;
+
+    std::size_t visitReadings(const std::string& key, std::uint_fast64_t count,
+                              const std::function<void(const Reading&)>& visitor) override;
+
+    void removeReadings(const std::string& key, std::uint_fast64_t count) override;
+
+    std::size_t removeReadingsOlderThan(std::chrono::system_clock::time_point time) override;
+
+    std::vector<std::string> getReadingsKeys() override;
+
+    bool putAttribute(const std::string& key, std::shared_ptr<Attribute> attribute) override;
+
+    std::map<std::string, std::shared_ptr<Attribute>> getAttributes() override;
+
+    std::shared_ptr<Attribute> getAttributeUnderKey(const std::string& key) override;
+
+    void removeAttributes() override;
+
+    void removeAttributes(const std::string& key) override;
+
+    std::vector<std::string> getAttributeKeys() override;
+
+    bool putParameter(const std::string& key, Parameter parameter) override;
+
+    std::map<std::string, Parameter> getParameters() override;
+
+    Parameter getParameterForKey(const std::string& key) override;
+
+    void removeParameters() override;
+
+    void removeParameters(const std::string& key) override;
+
+    std::vector<std::string> getParameterKeys() override;
+
+    bool isEmpty() override;
+
+    static const std::size_t DEFAULT_SYNC_INTERVAL;
+
+private:
+    struct ReadingsLog
+    {
+        // The logs are renamed on every compaction, so a crash in the middle can not mix up the old and the new one
+        std::uint64_t generation = 0;
+        // The offset of the first reading that was not removed
+        std::uint64_t head = 0;
+        std::uint64_t size = 0;
+        std::uint64_t count = 0;
+        int descriptor = -1;
+        bool unsynced = false;
+    };
+
+    void loadReadings();
+    void loadAttributes();
+    void loadParameters();
+
+    bool saveHeads();
+    void saveAttributes();
+    void saveParameters();
+
+    void syncReadings();
+    bool openLog(const std::string& key, ReadingsLog& log);
+    void closeLog(ReadingsLog& log);
+    std::size_t consumeReadings(const std::string& key, ReadingsLog& log, std::uint64_t count,
+                                std::chrono::system_clock::time_point persistedBefore);
+    void compactLog(const std::string& key, ReadingsLog& log);
+    std::string logPath(const std::string& key, std::uint64_t generation) const;
+
+    std::mutex m_mutex;
+
+    const std::string m_persistPath;
+    const std::size_t m_syncInterval;
+    std::size_t m_unsyncedReadings;
+    bool m_headsChanged;
+
+    std::map<std::string, ReadingsLog> m_readings;
+
+    std::map<std::string, std::shared_ptr<Attribute>> m_attributes;
+
+    std::map<std::string, Parameter> m_parameters;
+};
+}    // namespace wolkabout
+
+#endif
@@ -17,11 +17,15 @@
 #include "core/persistence/filesystem/MessagePersister.h"
 
 #include <sstream>
+#include <stdexcept>
 
 namespace
 {
 const std::string DELIMITER = "\n";
-}
+
+// The topics can not hold the '#' wildcard, so the messages persisted without an id are told apart by it
+const char ID_PREFIX = '#';
+}    // namespace
 
 namespace wolkabout
 {
@@ -29,23 +33,51 @@ std::string MessagePersister::save(const wolkabout::Message& message) const
 {
     std::stringstream stream;
 
-    stream << message.getChannel() << DELIMITER << message.getContent();
+    stream << ID_PREFIX << message.getId() << DELIMITER << message.getChannel() << DELIMITER << message.getContent();
 
     return stream.str();
 }
 
 std::unique_ptr<Message> MessagePersister::load(const std::string& text) const
 {
-    const auto pos = text.find(DELIMITER);
+    auto start = std::size_t{0};
+    auto id = std::uint64_t{0};
+    auto hasId = false;
+    if (!text.empty() && text.front() == ID_PREFIX)
+    {
+        const auto idEnd = text.find(DELIMITER);
+        if (idEnd == std::string::npos)
+        {
+            return nullptr;
+        }
+
+        try
+        {
+            id = std::stoull(text.substr(1, idEnd - 1));
+        }
+        catch (const std::exception&)
+        {
+            return nullptr;
+        }
+        hasId = true;
+        start = idEnd + DELIMITER.size();
+    }
+
+    const auto pos = text.find(DELIMITER, start);
 
     if (pos == std::string::npos)
     {
         return nullptr;
     }
 
-    const auto channel = text.substr(0, pos);
+    const auto channel = text.substr(start, pos - start);
     const auto content = text.substr(pos + DELIMITER.size());
 
-    return std::unique_ptr<Message>(new Message(channel, content));
+    // The messages persisted by the older versions get a new id
+    if (!hasId)
+    {
+        return std::unique_ptr<Message>(new Message(content, channel));
+    }
+    return std::unique_ptr<Message>(new Message(content, channel, id));
 }
 }    // namespace wolkabout
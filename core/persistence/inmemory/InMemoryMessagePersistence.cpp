@@ -18,25 +18,62 @@
 
 #include "core/model/Message.h"
 
+namespace
+{
+const wolkabout::MetricLabels METRIC_LABELS = {{"backend", "memory"}};
+}
+
 namespace wolkabout
 {
+InMemoryMessagePersistence::InMemoryMessagePersistence()
+: m_persistedMessages{MetricsRegistry::getInstance().gauge("wolkabout_persisted_messages",
+                                                           "Messages waiting in a persistence", METRIC_LABELS)}
+, m_droppedMessages{MetricsRegistry::getInstance().counter(
+    "wolkabout_persistence_dropped_messages_total", "Messages dropped unsent by a persistence", METRIC_LABELS)}
+{
+}
+
+InMemoryMessagePersistence::~InMemoryMessagePersistence()
+{
+    m_persistedMessages.add(-static_cast<std::int64_t>(m_queue.size()));
+}
+
 bool InMemoryMessagePersistence::push(std::shared_ptr<Message> message)
 {
     std::lock_guard<std::mutex> lg{m_lock};
-    m_queue.push(message);
+    m_queue.push(StoredMessage{std::move(message), std::chrono::system_clock::now()});
+    m_persistedMessages.increment();
     return true;
 }
 
 void InMemoryMessagePersistence::pop()
 {
     std::lock_guard<std::mutex> lg{m_lock};
+    if (m_queue.empty())
+        return;
+
+    m_queue.pop();
+    m_persistedMessages.decrement();
+}
+
+bool InMemoryMessagePersistence::remove(const std::shared_ptr<Message>& message)
+{
+    std::lock_guard<std::mutex> lg{m_lock};
+    if (m_queue.empty() || m_queue.front().message != message)
+        return false;
+
     m_queue.pop();
+    m_persistedMessages.decrement();
+    return true;
 }
 
 std::shared_ptr<Message> InMemoryMessagePersistence::front()
 {
     std::lock_guard<std::mutex> lg{m_lock};
-    return m_queue.front();
+    if (m_queue.empty())
+        return nullptr;
+
+    return m_queue.front().message;
 }
 
 bool InMemoryMessagePersistence::empty() const
@@ -44,4 +81,18 @@ bool InMemoryMessagePersistence::empty() const
     std::lock_guard<std::mutex> lg{m_lock};
     return m_queue.empty();
 }
+
+std::size_t InMemoryMessagePersistence::removeOlderThan(std::chrono::system_clock::time_point time)
+{
+    std::lock_guard<std::mutex> lg{m_lock};
+    auto removed = std::size_t{0};
+    while (!m_queue.empty() && m_queue.front().pushedAt < time)
+    {
+        m_queue.pop();
+        ++removed;
+    }
+    m_persistedMessages.add(-static_cast<std::int64_t>(removed));
+    m_droppedMessages.increment(removed);
+    return removed;
+}
 }    // namespace wolkabout
@@ -18,6 +18,7 @@
 #define INMEMORYMESSAGEPERSISTENCE_H
 
 #include "core/persistence/MessagePersistence.h"
+#include "core/utilities/Metrics.h"
 
 #include <memory>
 #include <mutex>
@@ -28,14 +29,28 @@ namespace wolkabout
 class InMemoryMessagePersistence : public MessagePersistence
 {
 public:
+    InMemoryMessagePersistence();
+    ~InMemoryMessagePersistence() override;
+
     bool push(std::shared_ptr<Message> message) override;
     void pop() override;
+    bool remove(const std::shared_ptr<Message>& message) override;
     std::shared_ptr<Message> front() override;
     bool empty() const override;
+    std::size_t removeOlderThan(std::chrono::system_clock::time_point time) override;
 
 private:
+    struct StoredMessage
+    {
+        std::shared_ptr<Message> message;
+        std::chrono::system_clock::time_point pushedAt;
+    };
+
     mutable std::mutex m_lock;
-    std::queue<std::shared_ptr<Message>> m_queue;
+    std::queue<StoredMessage> m_queue;
+
+    Gauge& m_persistedMessages;
+    Counter& m_droppedMessages;
 };
 }    // namespace wolkabout
 
@@ -14,48 +14,88 @@
  * limitations under the License.
  */
 
+
 #include "core/persistence/inmemory/InMemoryPersistence.h"
 
 #include <algorithm>
+#include <iterator>
 #include <string>
 #include <utility>
 #include <vector>
 
 namespace wolkabout
 {
+InMemoryPersistence::InMemoryPersistence(std::size_t readingsCapacity) : m_readingsCapacity{readingsCapacity} {}
+
+void InMemoryPersistence::setReadingsCapacity(const std::string& key, std::size_t capacity)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    getOrCreateReadingsByKey(key).setCapacity(capacity);
+}
+
 bool InMemoryPersistence::putReading(const std::string& key, const Reading& reading)
 {
-    getOrCreateReadingsByKey(key).push_back(std::make_shared<Reading>(reading));
+    std::lock_guard<std::mutex> lock{m_mutex};
+    getOrCreateReadingsByKey(key).push(StoredReading{reading, std::chrono::system_clock::now()});
     return true;
 }
 
 std::vector<std::shared_ptr<Reading>> InMemoryPersistence::getReadings(const std::string& key, std::uint_fast64_t count)
 {
-    if (m_readings.find(key) == m_readings.end())
-    {
-        return {};
-    }
+    // The readings are kept by value, so the pointers are made for the copies handed out. Use visitReadings to look at
+    // the readings without copying them.
+    auto readings = std::vector<std::shared_ptr<Reading>>{};
+    visitReadings(key, count,
+                  [&](const Reading& reading) { readings.emplace_back(std::make_shared<Reading>(reading)); });
+    return readings;
+}
+
+std::size_t InMemoryPersistence::visitReadings(const std::string& key, std::uint_fast64_t count,
+                                               const std::function<void(const Reading&)>& visitor)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    const auto it = m_readings.find(key);
+    if (it == m_readings.cend())
+        return 0;
 
-    std::vector<std::shared_ptr<Reading>>& readings = m_readings.at(key);
-    auto size = static_cast<uint_fast64_t>(readings.size());
-    return {readings.begin(), readings.begin() + static_cast<std::int64_t>((count < size ? count : size))};
+    const auto& readings = it->second;
+    const auto size = static_cast<std::size_t>(std::min<std::uint_fast64_t>(count, readings.size()));
+    for (std::size_t i = 0; i < size; ++i)
+        visitor(readings.at(i).reading);
+    return size;
 }
 
 void InMemoryPersistence::removeReadings(const std::string& key, uint_fast64_t count)
 {
-    if (m_readings.find(key) == m_readings.end())
-    {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    const auto it = m_readings.find(key);
+    if (it == m_readings.end())
         return;
-    }
 
-    std::vector<std::shared_ptr<Reading>>& readings = getOrCreateReadingsByKey(key);
-    auto size = static_cast<uint_fast64_t>(readings.size());
-    readings.erase(readings.begin(), readings.begin() + static_cast<std::int64_t>((count < size ? count : size)));
-    readings.shrink_to_fit();
+    it->second.pop(static_cast<std::size_t>(std::min<std::uint_fast64_t>(count, it->second.size())));
+}
+
+std::size_t InMemoryPersistence::removeReadingsOlderThan(std::chrono::system_clock::time_point time)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto removed = std::size_t{0};
+    for (auto& pair : m_readings)
+    {
+        // The readings are kept in the order they were inserted, so only the expired ones are looked at
+        auto& readings = pair.second;
+        auto expired = std::size_t{0};
+        while (expired < readings.size() && readings.at(expired).persistedAt < time)
+            ++expired;
+
+        readings.pop(expired);
+        removed += expired;
+    }
+    return removed;
 }
 
 std::vector<std::string> InMemoryPersistence::getReadingsKeys()
 {
+    std::lock_guard<std::mutex> lock{m_mutex};
     std::vector<std::string> keys;
     for (const auto& pair : m_readings)
     {
@@ -70,17 +110,20 @@ std::vector<std::string> InMemoryPersistence::getReadingsKeys()
 
 bool InMemoryPersistence::putAttribute(const std::string& key, std::shared_ptr<Attribute> attribute)
 {
+    std::lock_guard<std::mutex> lock{m_mutex};
     m_attributes.emplace(key, std::move(attribute));
     return true;
 }
 
 std::map<std::string, std::shared_ptr<Attribute>> InMemoryPersistence::getAttributes()
 {
+    std::lock_guard<std::mutex> lock{m_mutex};
     return m_attributes;
 }
 
 std::shared_ptr<Attribute> InMemoryPersistence::getAttributeUnderKey(const std::string& key)
 {
+    std::lock_guard<std::mutex> lock{m_mutex};
     const auto it = m_attributes.find(key);
     if (it == m_attributes.cend())
         return {};
@@ -89,11 +132,13 @@ std::shared_ptr<Attribute> InMemoryPersistence::getAttributeUnderKey(const std::
 
 void InMemoryPersistence::removeAttributes()
 {
+    std::lock_guard<std::mutex> lock{m_mutex};
     m_attributes.clear();
 }
 
 void InMemoryPersistence::removeAttributes(const std::string& key)
 {
+    std::lock_guard<std::mutex> lock{m_mutex};
     const auto it = m_attributes.find(key);
     if (it != m_attributes.cend())
         m_attributes.erase(it);
@@ -101,25 +146,30 @@ void InMemoryPersistence::removeAttributes(const std::string& key)
 
 std::vector<std::string> InMemoryPersistence::getAttributeKeys()
 {
+    std::lock_guard<std::mutex> lock{m_mutex};
     auto keys = std::vector<std::string>{};
-    std::transform(m_attributes.cbegin(), m_attributes.cend(), keys.end(),
-                   [&](const std::pair<std::string, std::shared_ptr<Attribute>>& pair) { return pair.first; });
+    keys.reserve(m_attributes.size());
+    std::transform(m_attributes.cbegin(), m_attributes.cend(), std::back_inserter(keys),
+                   [&](const std::pair<const std::string, std::shared_ptr<Attribute>>& pair) { return pair.first; });
     return keys;
 }
 
 bool InMemoryPersistence::putParameter(const std::string& key, Parameter parameter)
 {
+    std::lock_guard<std::mutex> lock{m_mutex};
     m_parameters.emplace(key, std::move(parameter));
     return true;
 }
 
 std::map<std::string, Parameter> InMemoryPersistence::getParameters()
 {
+    std::lock_guard<std::mutex> lock{m_mutex};
     return m_parameters;
 }
 
 Parameter InMemoryPersistence::getParameterForKey(const std::string& key)
 {
+    std::lock_guard<std::mutex> lock{m_mutex};
     const auto it = m_parameters.find(key);
     if (it == m_parameters.cend())
         return {};
@@ -128,11 +178,13 @@ Parameter InMemoryPersistence::getParameterForKey(const std::string& key)
 
 void InMemoryPersistence::removeParameters()
 {
+    std::lock_guard<std::mutex> lock{m_mutex};
     m_parameters.clear();
 }
 
 void InMemoryPersistence::removeParameters(const std::string& key)
 {
+    std::lock_guard<std::mutex> lock{m_mutex};
     const auto it = m_parameters.find(key);
     if (it != m_parameters.cend())
         m_parameters.erase(it);
@@ -140,24 +192,30 @@ void InMemoryPersistence::removeParameters(const std::string& key)
 
 std::vector<std::string> InMemoryPersistence::getParameterKeys()
 {
+    std::lock_guard<std::mutex> lock{m_mutex};
     auto keys = std::vector<std::string>{};
-    std::transform(m_parameters.cbegin(), m_parameters.cend(), keys.end(),
-                   [&](const std::pair<std::string, Parameter>& pair) { return pair.first; });
+    keys.reserve(m_parameters.size());
+    std::transform(m_parameters.cbegin(), m_parameters.cend(), std::back_inserter(keys),
+                   [&](const std::pair<const std::string, Parameter>& pair) { return pair.first; });
     return keys;
 }
 
-std::vector<std::shared_ptr<Reading>>& InMemoryPersistence::getOrCreateReadingsByKey(const std::string& key)
+RingBuffer<InMemoryPersistence::StoredReading>& InMemoryPersistence::getOrCreateReadingsByKey(const std::string& key)
 {
-    if (m_readings.find(key) == m_readings.end())
-    {
-        m_readings.emplace(std::pair<std::string, std::vector<std::shared_ptr<Reading>>>(key, {}));
-    }
+    auto it = m_readings.find(key);
+    if (it == m_readings.end())
+        it = m_readings.emplace(key, RingBuffer<StoredReading>{m_readingsCapacity}).first;
 
-    return m_readings.at(key);
+    return it->second;
 }
 
 bool InMemoryPersistence::isEmpty()
 {
-    return m_readings.empty() && m_attributes.empty() && m_parameters.empty();
+    std::lock_guard<std::mutex> lock{m_mutex};
+    const auto readingsEmpty = std::all_of(m_readings.cbegin(), m_readings.cend(),
+                                           [](const std::pair<const std::string, RingBuffer<StoredReading>>& pair) {
+                                               return pair.second.empty();
+                                           });
+    return readingsEmpty && m_attributes.empty() && m_parameters.empty();
 }
 }    // namespace wolkabout
@@ -18,6 +18,7 @@
 #define INMEMORYPERSISTENCE_H
 
 #include "core/persistence/Persistence.h"
+#include "core/utilities/RingBuffer.h"
 
 #include <cstdint>
 #include <map>
@@ -27,19 +28,38 @@
 
 namespace wolkabout
 {
-class Reading;
-
 class InMemoryPersistence : public Persistence
 {
 public:
+    /**
+     * Default constructor.
+     *
+     * @param readingsCapacity The number of readings kept under each key. Once a key is full, its oldest readings are
+     * dropped to make room for the new ones. Zero means the readings are not limited.
+     */
+    explicit InMemoryPersistence(std::size_t readingsCapacity = 0);
+
     ~InMemoryPersistence() override = default;
 
+    /**
+     * This method sets the number of readings kept under a single key, overriding the capacity from the constructor.
+     *
+     * @param key The key of the readings.
+     * @param capacity The number of readings. Zero means the readings are not limited.
+     */
+    void setReadingsCapacity(const std::string& key, std::size_t capacity);
+
     bool putReading(const std::string& key, const Reading& reading) override;
 
     std::vector<std::shared_ptr<Reading>> getReadings(const std::string& key, std::uint_fast64_t count) override;
 
+    std::size_t visitReadings(const std::string& key, std::uint_fast64_t count,
+                              const std::function<void(const Reading&)>& visitor) override;
+
     void removeReadings(const std::string& key, std::uint_fast64_t count) override;
 
+    std::size_t removeReadingsOlderThan(std::chrono::system_clock::time_point time) override;
+
     std::vector<std::string> getReadingsKeys() override;
 
     bool putAttribute(const std::string& key, std::shared_ptr<Attribute> attribute) override;
@@ -69,9 +89,18 @@ public:
     bool isEmpty() override;
 
 private:
-    std::vector<std::shared_ptr<Reading>>& getOrCreateReadingsByKey(const std::string& key);
+    struct StoredReading
+    {
+        Reading reading;
+        std::chrono::system_clock::time_point persistedAt;
+    };
+
+    RingBuffer<StoredReading>& getOrCreateReadingsByKey(const std::string& key);
+
+    std::mutex m_mutex;
 
-    std::map<std::string, std::vector<std::shared_ptr<Reading>>> m_readings;
+    std::size_t m_readingsCapacity;
+    std::map<std::string, RingBuffer<StoredReading>> m_readings;
 
     std::map<std::string, std::shared_ptr<Attribute>> m_attributes;
 
@@ -17,6 +17,7 @@
 #ifndef DATAPROTOCOL_H
 #define DATAPROTOCOL_H
 
+#include "core/model/MessagePool.h"
 #include "core/model/messages/AttributeRegistrationMessage.h"
 #include "core/model/messages/DetailsSynchronizationRequestMessage.h"
 #include "core/model/messages/DetailsSynchronizationResponseMessage.h"
@@ -73,6 +74,24 @@ public:
     virtual std::unique_ptr<Message> makeOutboundMessage(const std::string& deviceKey,
                                                          FeedValuesMessage feedValuesMessage) = 0;
 
+    /**
+     * This method is a serialization method to create a send-able MQTT message from a FeedValuesMessage, in a message
+     * taken from the pool. The topic and the payload are written into the buffers the pooled message already has. The
+     * protocols that do not override this make the message the usual way, without the pool. Nothing in the SDK sends
+     * through this overload, it is there for the applications that keep a pool of their own.
+     *
+     * @param deviceKey The device key for which the FeedValuesMessage is regarding.
+     * @param feedValuesMessage The message containing information about new feed values the device is sending.
+     * @param pool The pool the message is taken from.
+     * @return A pooled MqttMessage. `nullptr` if an error has occurred.
+     */
+    virtual std::shared_ptr<Message> makeOutboundMessage(const std::string& deviceKey,
+                                                         const FeedValuesMessage& feedValuesMessage,
+                                                         MessagePool& /* pool */)
+    {
+        return std::shared_ptr<Message>{makeOutboundMessage(deviceKey, feedValuesMessage)};
+    }
+
     /**
      * This method is a serialization method to create a send-able MQTT message from a PullFeedValuesMessage.
      *
@@ -20,6 +20,10 @@
 #include "core/model/messages/GatewaySubdeviceMessage.h"
 #include "core/protocol/Protocol.h"
 
+#include <memory>
+#include <string>
+#include <vector>
+
 namespace wolkabout
 {
 /**
@@ -39,6 +43,40 @@ public:
     virtual std::unique_ptr<Message> makeOutboundMessage(const std::string& deviceKey,
                                                          const GatewaySubdeviceMessage& message) = 0;
 
+    /**
+     * This method is a serialization method to create a single send-able MQTT message from multiple
+     * GatewaySubdeviceMessages. All the messages must be of the same message type, and they will be sent out as a
+     * single array payload. The protocols that do not override this make every message on its own, and join the
+     * arrays they are sent in.
+     *
+     * @param deviceKey The device key of the gateway routing these messages.
+     * @param messages The messages themselves, each containing a message received from a subdevice.
+     * @return A newly generated MqttMessage. `nullptr` if an error has occurred.
+     */
+    virtual std::unique_ptr<Message> makeOutboundMessage(const std::string& deviceKey,
+                                                         const std::vector<GatewaySubdeviceMessage>& messages)
+    {
+        auto payload = std::string{"["};
+        auto channel = std::string{};
+        for (const auto& message : messages)
+        {
+            const auto single = makeOutboundMessage(deviceKey, message);
+            if (single == nullptr || single->getContent().size() < 2 || single->getContent().front() != '[' ||
+                single->getContent().back() != ']' || (!channel.empty() && single->getChannel() != channel))
+                return nullptr;
+
+            if (payload.size() > 1)
+                payload += ',';
+            payload.append(single->getContent(), 1, single->getContent().size() - 2);
+            channel = single->getChannel();
+        }
+        if (channel.empty())
+            return nullptr;
+
+        payload += ']';
+        return std::unique_ptr<Message>{new Message{std::move(payload), std::move(channel)}};
+    }
+
     /**
      * This method is a deserialization method used to parse a MQTT message into a GatewaySubdeviceMessage.
      *
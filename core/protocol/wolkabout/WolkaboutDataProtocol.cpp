@@ -22,8 +22,13 @@
 #include "core/protocol/wolkabout/WolkaboutProtocol.h"
 #include "core/utilities/Logger.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <memory>
 #include <nlohmann/json.hpp>
+#include <numeric>
+#include <sstream>
 #include <string>
 
 using nlohmann::json;
@@ -108,6 +113,307 @@ static void from_json(const json& j, std::vector<Reading>& r)
     }
 }
 
+static json readingValueToJson(const Reading& reading)
+{
+    if (reading.isMulti())
+    {
+        auto string = std::stringstream{};
+        const auto size = reading.getStringValues().size();
+        for (auto i = std::size_t{0}; i < size; ++i)
+            string << reading.getStringValues()[i] << (i < (size - 1) ? "," : "");
+        return string.str();
+    }
+
+    if (reading.isBoolean())
+        return reading.getBoolValue();
+    else if (reading.isUInt())
+        return reading.getUIntValue();
+    else if (reading.isInt())
+        return reading.getIntValue();
+    else if (reading.isDouble())
+        return reading.getDoubleValue();
+    return reading.getStringValue();
+}
+
+static json feedValueToJson(const FeedValueColumns& columns, std::size_t row)
+{
+    const auto& value = columns.values[row];
+    switch (columns.types[row])
+    {
+    case FeedValueColumns::Type::BOOLEAN:
+        return value.boolean;
+    case FeedValueColumns::Type::UNSIGNED:
+        return value.unsignedValue;
+    case FeedValueColumns::Type::SIGNED:
+        return value.signedValue;
+    case FeedValueColumns::Type::DOUBLE:
+        return value.doubleValue;
+    case FeedValueColumns::Type::MULTI:
+        return columns.strings[value.stringIndex];
+    case FeedValueColumns::Type::STRING:
+    default:
+        // The strings are read the same way the reading values are
+        return readingValueToJson(Reading{"", columns.strings[value.stringIndex]});
+    }
+}
+
+static std::vector<std::size_t> feedValuesOrder(const FeedValueColumns& columns)
+{
+    // The rows are grouped by their timestamp, and are only sorted if they were not added in order
+    auto order = std::vector<std::size_t>{};
+    if (!std::is_sorted(columns.timestamps.cbegin(), columns.timestamps.cend()))
+    {
+        order.resize(columns.size());
+        std::iota(order.begin(), order.end(), std::size_t{0});
+        std::stable_sort(order.begin(), order.end(), [&](std::size_t lhs, std::size_t rhs) {
+            return columns.timestamps[lhs] < columns.timestamps[rhs];
+        });
+    }
+    return order;
+}
+
+static json feedValuesToJson(const FeedValueColumns& columns)
+{
+    const auto order = feedValuesOrder(columns);
+    const auto rowAt = [&](std::size_t i) { return order.empty() ? i : order[i]; };
+
+    auto payload = json::array();
+    for (auto i = std::size_t{0}; i < columns.size();)
+    {
+        const auto timestamp = columns.timestamps[rowAt(i)];
+        auto time = json::object();
+        if (timestamp)
+            time[WolkaboutProtocol::TIMESTAMP_KEY] = timestamp;
+        for (; i < columns.size() && columns.timestamps[rowAt(i)] == timestamp; ++i)
+        {
+            const auto row = rowAt(i);
+            time[columns.references[columns.referenceIndices[row]]] = feedValueToJson(columns, row);
+        }
+        payload.emplace_back(std::move(time));
+    }
+    return payload;
+}
+
+static void appendJsonString(std::string& content, const std::string& value)
+{
+    // Escaped the way json::dump escapes the strings, the other characters are written as they are
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+    content.push_back('"');
+    for (const auto character : value)
+    {
+        switch (character)
+        {
+        case '"':
+            content.append("\\\"");
+            break;
+        case '\\':
+            content.append("\\\\");
+            break;
+        case '\b':
+            content.append("\\b");
+            break;
+        case '\f':
+            content.append("\\f");
+            break;
+        case '\n':
+            content.append("\\n");
+            break;
+        case '\r':
+            content.append("\\r");
+            break;
+        case '\t':
+            content.append("\\t");
+            break;
+        default:
+            if (static_cast<unsigned char>(character) < 0x20)
+            {
+                content.append("\\u00");
+                content.push_back(HEX_DIGITS[static_cast<unsigned char>(character) >> 4]);
+                content.push_back(HEX_DIGITS[static_cast<unsigned char>(character) & 0x0F]);
+            }
+            else
+                content.push_back(character);
+        }
+    }
+    content.push_back('"');
+}
+
+static void appendJsonNumber(std::string& content, std::uint64_t value)
+{
+    char digits[20];
+    auto* begin = digits + sizeof(digits);
+    do
+    {
+        *--begin = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    content.append(begin, digits + sizeof(digits));
+}
+
+static void appendJsonNumber(std::string& content, std::int64_t value)
+{
+    if (value < 0)
+    {
+        content.push_back('-');
+        appendJsonNumber(content, std::uint64_t{0} - static_cast<std::uint64_t>(value));
+    }
+    else
+        appendJsonNumber(content, static_cast<std::uint64_t>(value));
+}
+
+static void appendJsonNumber(std::string& content, double value)
+{
+    // The doubles are formatted by the same routine json::dump uses, so both paths write the same digits
+    if (!std::isfinite(value))
+    {
+        content.append("null");
+        return;
+    }
+    char digits[64];
+    content.append(digits, nlohmann::detail::to_chars(digits, digits + sizeof(digits), value));
+}
+
+static void appendJsonValue(std::string& content, const json& value)
+{
+    switch (value.type())
+    {
+    case json::value_t::boolean:
+        content.append(value.get<bool>() ? "true" : "false");
+        break;
+    case json::value_t::number_unsigned:
+        appendJsonNumber(content, value.get<std::uint64_t>());
+        break;
+    case json::value_t::number_integer:
+        appendJsonNumber(content, value.get<std::int64_t>());
+        break;
+    case json::value_t::number_float:
+        appendJsonNumber(content, value.get<double>());
+        break;
+    case json::value_t::string:
+        appendJsonString(content, value.get_ref<const std::string&>());
+        break;
+    default:
+        content.append(value.dump());
+    }
+}
+
+static void appendFeedValue(std::string& content, const FeedValueColumns& columns, std::size_t row)
+{
+    const auto& value = columns.values[row];
+    switch (columns.types[row])
+    {
+    case FeedValueColumns::Type::BOOLEAN:
+        content.append(value.boolean ? "true" : "false");
+        break;
+    case FeedValueColumns::Type::UNSIGNED:
+        appendJsonNumber(content, value.unsignedValue);
+        break;
+    case FeedValueColumns::Type::SIGNED:
+        appendJsonNumber(content, value.signedValue);
+        break;
+    case FeedValueColumns::Type::DOUBLE:
+        appendJsonNumber(content, value.doubleValue);
+        break;
+    case FeedValueColumns::Type::MULTI:
+        appendJsonString(content, columns.strings[value.stringIndex]);
+        break;
+    case FeedValueColumns::Type::STRING:
+    default:
+        // The strings can still turn out to be numbers, so they are read the same way the json path reads them
+        appendJsonValue(content, feedValueToJson(columns, row));
+    }
+}
+
+/**
+ * This writes the columns as the same text `feedValuesToJson(columns).dump()` makes, without building the json for
+ * them. The members of an object are written sorted by their key, and a repeated key keeps its last value, like the
+ * members of a json object.
+ */
+static void appendFeedValues(std::string& content, const FeedValueColumns& columns)
+{
+    const auto order = feedValuesOrder(columns);
+    const auto rowAt = [&](std::size_t i) { return order.empty() ? i : order[i]; };
+    const auto timestampMember = std::numeric_limits<std::size_t>::max();
+    const auto keyOf = [&](std::size_t member) -> const std::string& {
+        return member == timestampMember ? WolkaboutProtocol::TIMESTAMP_KEY :
+                                           columns.references[columns.referenceIndices[member]];
+    };
+
+    auto members = std::vector<std::size_t>{};
+    content.push_back('[');
+    for (auto i = std::size_t{0}; i < columns.size();)
+    {
+        const auto timestamp = columns.timestamps[rowAt(i)];
+        members.clear();
+        if (timestamp)
+            members.emplace_back(timestampMember);
+        for (; i < columns.size() && columns.timestamps[rowAt(i)] == timestamp; ++i)
+            members.emplace_back(rowAt(i));
+        std::stable_sort(members.begin(), members.end(),
+                         [&](std::size_t lhs, std::size_t rhs) { return keyOf(lhs) < keyOf(rhs); });
+
+        if (content.back() != '[')
+            content.push_back(',');
+        content.push_back('{');
+        auto first = true;
+        for (auto m = std::size_t{0}; m < members.size(); ++m)
+        {
+            const auto member = members[m];
+            if (m + 1 < members.size() && keyOf(member) == keyOf(members[m + 1]))
+                continue;
+
+            if (!first)
+                content.push_back(',');
+            first = false;
+            appendJsonString(content, keyOf(member));
+            content.push_back(':');
+            if (member == timestampMember)
+                appendJsonNumber(content, timestamp);
+            else
+                appendFeedValue(content, columns, member);
+        }
+        content.push_back('}');
+    }
+    content.push_back(']');
+}
+
+static json feedValuesToJson(const FeedValuesMessage& feedValuesMessage)
+{
+    // Check that the message is not empty
+    const auto& columns = feedValuesMessage.getColumns();
+    if (columns.empty() && feedValuesMessage.getReadings().empty())
+    {
+        LOG(ERROR) << "Failed to serialize 'FeedValuesMessage' -> The readings map is empty.";
+        return nullptr;
+    }
+
+    // The columns are serialized as they are, without making the readings out of them
+    if (!columns.empty())
+        return feedValuesToJson(columns);
+
+    auto payload = json::array();
+    for (const auto& member : feedValuesMessage.getReadings())
+    {
+        // Check if the map is empty
+        if (member.second.empty())
+        {
+            LOG(ERROR) << "Failed to serialize 'FeedValuesMessage' -> One of the readings map entries is empty.";
+            return nullptr;
+        }
+
+        // Create the object for this time
+        auto time = json();
+        if (member.first)
+            time[WolkaboutProtocol::TIMESTAMP_KEY] = member.first;
+        for (const auto& reading : member.second)
+            time[reading.getReference()] = readingValueToJson(reading);
+
+        // And add it into the array
+        payload += time;
+    }
+    return payload;
+}
+
 static void from_json(const json& j, std::vector<Parameter>& p)
 {
     // Check that the json is an object
@@ -233,65 +539,58 @@ std::unique_ptr<Message> WolkaboutDataProtocol::makeOutboundMessage(const std::s
 {
     LOG(TRACE) << METHOD_INFO;
 
-    // Check that the map is not empty
-    if (feedValuesMessage.getReadings().empty())
+    try
     {
-        LOG(ERROR) << "Failed to serialize 'FeedValuesMessage' -> The readings map is empty.";
+        // Create the content
+        const auto payload = feedValuesToJson(feedValuesMessage);
+        if (payload.is_null())
+            return nullptr;
+
+        // Create the topic
+        const auto topic = WolkaboutProtocol::DEVICE_TO_PLATFORM_DIRECTION + WolkaboutProtocol::CHANNEL_DELIMITER +
+                           deviceKey + WolkaboutProtocol::CHANNEL_DELIMITER +
+                           toString(feedValuesMessage.getMessageType());
+        return std::unique_ptr<Message>(new Message{payload.dump(), topic});
+    }
+    catch (const std::exception& exception)
+    {
+        LOG(ERROR) << "Failed to serialize 'FeedValuesMessage' -> '" << exception.what() << "'.";
         return nullptr;
     }
+}
 
-    // Create the topic
-    const auto topic = WolkaboutProtocol::DEVICE_TO_PLATFORM_DIRECTION + WolkaboutProtocol::CHANNEL_DELIMITER +
-                       deviceKey + WolkaboutProtocol::CHANNEL_DELIMITER + toString(feedValuesMessage.getMessageType());
+std::shared_ptr<Message> WolkaboutDataProtocol::makeOutboundMessage(const std::string& deviceKey,
+                                                                    const FeedValuesMessage& feedValuesMessage,
+                                                                    MessagePool& pool)
+{
+    LOG(TRACE) << METHOD_INFO;
 
     try
     {
-        // Create the content
-        auto payload = json::array();
-        const auto& values = feedValuesMessage.getReadings();
-        for (const auto& member : values)
-        {
-            // Check if the map is empty
-            if (member.second.empty())
-            {
-                LOG(ERROR) << "Failed to serialize 'FeedValuesMessage' -> One of the readings map entries is empty.";
-                return nullptr;
-            }
-
-            // Create the object for this time
-            auto time = json();
-            if (member.first)
-                time[WolkaboutProtocol::TIMESTAMP_KEY] = member.first;
-            for (const auto& reading : member.second)
-            {
-                const auto& key = reading.getReference();
-                if (!reading.isMulti())
-                {
-                    if (reading.isBoolean())
-                        time[key] = reading.getBoolValue();
-                    else if (reading.isUInt())
-                        time[key] = reading.getUIntValue();
-                    else if (reading.isInt())
-                        time[key] = reading.getIntValue();
-                    else if (reading.isDouble())
-                        time[key] = reading.getDoubleValue();
-                    else
-                        time[key] = reading.getStringValue();
-                }
-                else
-                {
-                    auto string = std::stringstream{};
-                    const auto size = reading.getStringValues().size();
-                    for (auto i = std::size_t{0}; i < size; ++i)
-                        string << reading.getStringValues()[i] << (i < (size - 1) ? "," : "");
-                    time[key] = string.str();
-                }
-            }
-
-            // And add it into the array
-            payload += time;
-        }
-        return std::unique_ptr<Message>(new Message{payload.dump(), topic});
+        const auto appendTopic = [&](std::string& channel) {
+            channel.append(WolkaboutProtocol::DEVICE_TO_PLATFORM_DIRECTION)
+              .append(WolkaboutProtocol::CHANNEL_DELIMITER)
+              .append(deviceKey)
+              .append(WolkaboutProtocol::CHANNEL_DELIMITER)
+              .append(toString(feedValuesMessage.getMessageType()));
+        };
+
+        // The columns are written straight into the buffers of the pooled message
+        const auto& columns = feedValuesMessage.getColumns();
+        if (!columns.empty())
+            return pool.acquire([&](std::string& content, std::string& channel) {
+                appendTopic(channel);
+                appendFeedValues(content, columns);
+            });
+
+        // The readings still go through the json
+        const auto payload = feedValuesToJson(feedValuesMessage);
+        if (payload.is_null())
+            return nullptr;
+        return pool.acquire([&](std::string& content, std::string& channel) {
+            appendTopic(channel);
+            content.append(payload.dump());
+        });
     }
     catch (const std::exception& exception)
     {
@@ -463,6 +762,7 @@ std::unique_ptr<FeedValuesMessage> WolkaboutDataProtocol::parseFeedValues(std::s
     catch (const std::exception& exception)
     {
         LOG(ERROR) << "Failed to deserialize 'FeedValues' message -> '" << exception.what() << "'.";
+        WolkaboutProtocol::countParseFailure(*message);
         return nullptr;
     }
 }
@@ -482,6 +782,7 @@ std::unique_ptr<ParametersUpdateMessage> WolkaboutDataProtocol::parseParameters(
     catch (const std::exception& exception)
     {
         LOG(ERROR) << "Failed to deserialize 'Parameters' message -> '" << exception.what() << "'.";
+        WolkaboutProtocol::countParseFailure(*message);
         return nullptr;
     }
 }
@@ -497,6 +798,7 @@ std::unique_ptr<DetailsSynchronizationResponseMessage> WolkaboutDataProtocol::pa
     if (type != MessageType::DETAILS_SYNCHRONIZATION_RESPONSE)
     {
         LOG(ERROR) << errorPrefix << " -> The message is not a 'DetailsSynchronizationResponse' message.";
+        WolkaboutProtocol::countParseFailure(*message);
         return nullptr;
     }
 
@@ -514,6 +816,7 @@ std::unique_ptr<DetailsSynchronizationResponseMessage> WolkaboutDataProtocol::pa
     catch (const std::exception& exception)
     {
         LOG(ERROR) << errorPrefix << " -> '" << exception.what() << "'.";
+        WolkaboutProtocol::countParseFailure(*message);
         return nullptr;
     }
 }
@@ -53,6 +53,10 @@ public:
     std::unique_ptr<Message> makeOutboundMessage(const std::string& deviceKey,
                                                  FeedValuesMessage feedValuesMessage) override;
 
+    std::shared_ptr<Message> makeOutboundMessage(const std::string& deviceKey,
+                                                 const FeedValuesMessage& feedValuesMessage,
+                                                 MessagePool& pool) override;
+
     std::unique_ptr<Message> makeOutboundMessage(const std::string& deviceKey,
                                                  PullFeedValuesMessage pullFeedValuesMessage) override;
 
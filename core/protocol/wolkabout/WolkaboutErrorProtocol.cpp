@@ -71,6 +71,7 @@ std::unique_ptr<ErrorMessage> WolkaboutErrorProtocol::parseError(const std::shar
         if (type != MessageType::ERROR_MESSAGE)
         {
             LOG(ERROR) << errorPrefix << " -> The message is not a 'Error' message.";
+            WolkaboutProtocol::countParseFailure(*message);
             return nullptr;
         }
 
@@ -79,6 +80,7 @@ std::unique_ptr<ErrorMessage> WolkaboutErrorProtocol::parseError(const std::shar
         if (deviceKey.empty())
         {
             LOG(ERROR) << errorPrefix << " -> The device key is empty.";
+            WolkaboutProtocol::countParseFailure(*message);
             return nullptr;
         }
         auto time = std::chrono::system_clock::now();
@@ -89,6 +91,7 @@ std::unique_ptr<ErrorMessage> WolkaboutErrorProtocol::parseError(const std::shar
     catch (const std::exception& exception)
     {
         LOG(ERROR) << errorPrefix << " -> '" << exception.what() << "'.";
+        WolkaboutProtocol::countParseFailure(*message);
         return nullptr;
     }
 }
@@ -227,6 +227,7 @@ std::unique_ptr<FileUploadInitiateMessage> WolkaboutFileManagementProtocol::pars
     if (type != MessageType::FILE_UPLOAD_INIT)
     {
         LOG(ERROR) << errorPrefix << " -> The message is not a 'FileUploadInitiate' message.";
+        WolkaboutProtocol::countParseFailure(*message);
         return nullptr;
     }
 
@@ -245,6 +246,7 @@ std::unique_ptr<FileUploadInitiateMessage> WolkaboutFileManagementProtocol::pars
     catch (const std::exception& exception)
     {
         LOG(ERROR) << errorPrefix << " -> '" << exception.what() << "'.";
+        WolkaboutProtocol::countParseFailure(*message);
         return nullptr;
     }
 }
@@ -260,6 +262,7 @@ std::unique_ptr<FileUploadAbortMessage> WolkaboutFileManagementProtocol::parseFi
     if (type != MessageType::FILE_UPLOAD_ABORT)
     {
         LOG(ERROR) << errorPrefix << " -> The message is not a 'FileUploadAbort' message.";
+        WolkaboutProtocol::countParseFailure(*message);
         return nullptr;
     }
 
@@ -279,11 +282,12 @@ std::unique_ptr<FileBinaryResponseMessage> WolkaboutFileManagementProtocol::pars
     if (type != MessageType::FILE_BINARY_RESPONSE)
     {
         LOG(ERROR) << errorPrefix << " -> The message is not a 'FileBinaryResponse' message.";
+        WolkaboutProtocol::countParseFailure(*message);
         return nullptr;
     }
 
-    // Return the entire payload in the response
-    return std::unique_ptr<FileBinaryResponseMessage>(new FileBinaryResponseMessage(message->getContent()));
+    // The response references the chunk inside the received message, without copying it
+    return std::unique_ptr<FileBinaryResponseMessage>(new FileBinaryResponseMessage(std::move(message)));
 }
 
 std::unique_ptr<FileUrlDownloadInitMessage> WolkaboutFileManagementProtocol::parseFileUrlDownloadInit(
@@ -297,6 +301,7 @@ std::unique_ptr<FileUrlDownloadInitMessage> WolkaboutFileManagementProtocol::par
     if (type != MessageType::FILE_URL_DOWNLOAD_INIT)
     {
         LOG(ERROR) << errorPrefix << " -> The message is not a 'FileUrlDownloadInit' message.";
+        WolkaboutProtocol::countParseFailure(*message);
         return nullptr;
     }
 
@@ -316,6 +321,7 @@ std::unique_ptr<FileUrlDownloadAbortMessage> WolkaboutFileManagementProtocol::pa
     if (type != MessageType::FILE_URL_DOWNLOAD_ABORT)
     {
         LOG(ERROR) << errorPrefix << " -> The message is not a 'FileUrlDownloadAbort' message.";
+        WolkaboutProtocol::countParseFailure(*message);
         return nullptr;
     }
 
@@ -335,6 +341,7 @@ std::unique_ptr<FileListRequestMessage> WolkaboutFileManagementProtocol::parseFi
     if (type != MessageType::FILE_LIST_REQUEST)
     {
         LOG(ERROR) << errorPrefix << " -> The message is not a 'FileListRequest' message.";
+        WolkaboutProtocol::countParseFailure(*message);
         return nullptr;
     }
 
@@ -352,6 +359,7 @@ std::unique_ptr<FileDeleteMessage> WolkaboutFileManagementProtocol::parseFileDel
     if (type != MessageType::FILE_DELETE)
     {
         LOG(ERROR) << errorPrefix << " -> The message is not a 'FileDelete' message.";
+        WolkaboutProtocol::countParseFailure(*message);
         return nullptr;
     }
 
@@ -376,6 +384,7 @@ std::unique_ptr<FileDeleteMessage> WolkaboutFileManagementProtocol::parseFileDel
     catch (const std::exception& exception)
     {
         LOG(ERROR) << errorPrefix << " -> '" << exception.what() << "'.";
+        WolkaboutProtocol::countParseFailure(*message);
         return nullptr;
     }
 }
@@ -390,6 +399,7 @@ std::unique_ptr<FilePurgeMessage> WolkaboutFileManagementProtocol::parseFilePurg
     if (type != MessageType::FILE_PURGE)
     {
         LOG(ERROR) << errorPrefix << " -> The message is not a 'FilePurge' message.";
+        WolkaboutProtocol::countParseFailure(*message);
         return nullptr;
     }
 
@@ -110,6 +110,7 @@ std::unique_ptr<FirmwareUpdateInstallMessage> WolkaboutFirmwareUpdateProtocol::p
     if (type != MessageType::FIRMWARE_UPDATE_INSTALL)
     {
         LOG(ERROR) << errorPrefix << " -> The message is not a 'FirmwareUpdateInstall' message.";
+        WolkaboutProtocol::countParseFailure(*message);
         return nullptr;
     }
 
@@ -129,6 +130,7 @@ std::unique_ptr<FirmwareUpdateAbortMessage> WolkaboutFirmwareUpdateProtocol::par
     if (type != MessageType::FIRMWARE_UPDATE_ABORT)
     {
         LOG(ERROR) << errorPrefix << " -> The message is not a 'FirmwareUpdateAbort' message.";
+        WolkaboutProtocol::countParseFailure(*message);
         return nullptr;
     }
 
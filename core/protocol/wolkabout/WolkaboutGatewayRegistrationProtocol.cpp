@@ -220,6 +220,7 @@ std::unique_ptr<DeviceRegistrationMessage> WolkaboutGatewayRegistrationProtocol:
     if (type != MessageType::DEVICE_REGISTRATION)
     {
         LOG(ERROR) << errorPrefix << " -> The message is not a 'DeviceRegistration' message.";
+        WolkaboutProtocol::countParseFailure(*message);
         return nullptr;
     }
 
@@ -233,6 +234,7 @@ std::unique_ptr<DeviceRegistrationMessage> WolkaboutGatewayRegistrationProtocol:
     catch (const std::exception& exception)
     {
         LOG(ERROR) << errorPrefix << " -> Failed to parse the incoming payload - '" << exception.what() << "'.";
+        WolkaboutProtocol::countParseFailure(*message);
         return nullptr;
     }
 }
@@ -248,6 +250,7 @@ std::unique_ptr<DeviceRemovalMessage> WolkaboutGatewayRegistrationProtocol::pars
     if (type != MessageType::DEVICE_REMOVAL)
     {
         LOG(ERROR) << errorPrefix << " -> The message is not a 'DeviceRemoval' message.";
+        WolkaboutProtocol::countParseFailure(*message);
         return nullptr;
     }
 
@@ -261,6 +264,7 @@ std::unique_ptr<DeviceRemovalMessage> WolkaboutGatewayRegistrationProtocol::pars
             if (key.empty())
             {
                 LOG(ERROR) << errorPrefix << " -> One of the keys in the array is empty!";
+                WolkaboutProtocol::countParseFailure(*message);
                 return nullptr;
             }
         }
@@ -269,6 +273,7 @@ std::unique_ptr<DeviceRemovalMessage> WolkaboutGatewayRegistrationProtocol::pars
     catch (const std::exception& exception)
     {
         LOG(ERROR) << errorPrefix << " -> Failed to parse the incoming payload - '" << exception.what() << "'.";
+        WolkaboutProtocol::countParseFailure(*message);
         return nullptr;
     }
 }
@@ -284,6 +289,7 @@ WolkaboutGatewayRegistrationProtocol::parseRegisteredDevicesRequestMessage(const
     if (type != MessageType::REGISTERED_DEVICES_REQUEST)
     {
         LOG(ERROR) << errorPrefix << " -> The message is not a 'RegisteredDevicesRequest' message.";
+        WolkaboutProtocol::countParseFailure(*message);
         return nullptr;
     }
 
@@ -299,6 +305,7 @@ WolkaboutGatewayRegistrationProtocol::parseRegisteredDevicesRequestMessage(const
     catch (const std::exception& exception)
     {
         LOG(ERROR) << errorPrefix << " -> Failed to parse the incoming payload - '" << exception.what() << "'.";
+        WolkaboutProtocol::countParseFailure(*message);
         return nullptr;
     }
 }
@@ -21,6 +21,7 @@
 #include "core/utilities/StringUtils.h"
 
 #include <nlohmann/json.hpp>
+#include <stdexcept>
 
 using json = nlohmann::json;
 
@@ -39,6 +40,28 @@ static void to_json(json& j, const GatewaySubdeviceMessage& message)
     }
 }
 
+static void appendSubdeviceMessage(std::string& payload, const GatewaySubdeviceMessage& message)
+{
+    // The content is spliced into the payload as-is, so it is only checked for being JSON, without building the json
+    const auto& content = message.getMessage().getContent();
+    const auto deviceKey = json(WolkaboutProtocol::getDeviceKey(message.getMessage())).dump();
+    if (!content.empty())
+    {
+        if (!json::accept(content))
+            throw std::invalid_argument("The content of the sub-message from " + deviceKey + " is not valid JSON.");
+
+        payload += R"({"device":)";
+        payload += deviceKey;
+        payload += R"(,"payload":)";
+        payload += content;
+        payload += '}';
+    }
+    else
+    {
+        payload += deviceKey;
+    }
+}
+
 WolkaboutGatewaySubdeviceProtocol::WolkaboutGatewaySubdeviceProtocol(bool isGateway)
 : m_incomingDirection{isGateway ? WolkaboutProtocol::PLATFORM_TO_GATEWAY_DIRECTION :
                                   WolkaboutProtocol::DEVICE_TO_PLATFORM_DIRECTION}
@@ -107,6 +130,65 @@ std::unique_ptr<Message> WolkaboutGatewaySubdeviceProtocol::makeOutboundMessage(
     }
 }
 
+std::unique_ptr<Message> WolkaboutGatewaySubdeviceProtocol::makeOutboundMessage(
+  const std::string& deviceKey, const std::vector<GatewaySubdeviceMessage>& messages)
+{
+    LOG(TRACE) << METHOD_INFO;
+
+    // Check that there is anything to send
+    if (messages.empty())
+    {
+        LOG(ERROR) << "Failed to generate outbound subdevice message -> There are no sub-messages to send!";
+        return nullptr;
+    }
+
+    // Find the message type of the sub-messages, they all need to be the same
+    auto subMessageType = getMessageType(messages.front().getMessage());
+    if (subMessageType >= MessageType::DEVICE_REGISTRATION)
+    {
+        LOG(ERROR) << "Failed to generate outbound subdevice message -> The sub-message has a type that is invalid for "
+                      "a subdevice to send!";
+        return nullptr;
+    }
+
+    try
+    {
+        // Pre-calculate the size of the payload, so it is allocated only once
+        auto payloadSize = std::size_t{2};
+        for (const auto& message : messages)
+            payloadSize += message.getMessage().getContent().size() + message.getMessage().getChannel().size() + 32;
+        auto payload = std::string{};
+        payload.reserve(payloadSize);
+
+        // Splice every sub-message into the array
+        payload += '[';
+        for (auto it = messages.cbegin(); it != messages.cend(); ++it)
+        {
+            if (getMessageType(it->getMessage()) != subMessageType)
+            {
+                LOG(ERROR) << "Failed to generate outbound subdevice message -> All the sub-messages must have the "
+                              "same message type!";
+                return nullptr;
+            }
+            if (it != messages.cbegin())
+                payload += ',';
+            appendSubdeviceMessage(payload, *it);
+        }
+        payload += ']';
+
+        // Create the message
+        return std::unique_ptr<Message>{
+          new Message{std::move(payload), WolkaboutProtocol::GATEWAY_TO_PLATFORM_DIRECTION +
+                                            WolkaboutProtocol::CHANNEL_DELIMITER + deviceKey +
+                                            WolkaboutProtocol::CHANNEL_DELIMITER + toString(subMessageType)}};
+    }
+    catch (const std::exception& exception)
+    {
+        LOG(ERROR) << "Failed to generate outbound subdevice message -> '" << exception.what() << "'.";
+        return nullptr;
+    }
+}
+
 std::vector<GatewaySubdeviceMessage> WolkaboutGatewaySubdeviceProtocol::parseIncomingSubdeviceMessage(
   std::shared_ptr<Message> message)
 {
@@ -123,16 +205,22 @@ std::vector<GatewaySubdeviceMessage> WolkaboutGatewaySubdeviceProtocol::parseInc
     // Make the lambda expression that will analyze a payload object
     auto extractMessage = [&](const json& j) {
         // Extract necessities to make a message
-        auto payload = j["payload"];
+        const auto& payload = j["payload"];
         auto deviceKey = j["device"].get<std::string>();
+        auto channel = WolkaboutProtocol::PLATFORM_TO_DEVICE_DIRECTION + WolkaboutProtocol::CHANNEL_DELIMITER +
+                       deviceKey + WolkaboutProtocol::CHANNEL_DELIMITER + toString(type);
 
-        // If the payload needs to be transformed, we're going to do it here
-        auto payloadDump = payload.dump();
+        // Binary payloads are decoded straight from the parsed string, without dumping it first
         if (type == MessageType::FILE_BINARY_RESPONSE)
-            payloadDump = StringUtils::base64Decode(WolkaboutProtocol::removeQuotes(payloadDump));
-        messages.emplace_back(Message{payloadDump, WolkaboutProtocol::PLATFORM_TO_DEVICE_DIRECTION +
-                                                     WolkaboutProtocol::CHANNEL_DELIMITER + deviceKey +
-                                                     WolkaboutProtocol::CHANNEL_DELIMITER + toString(type)});
+        {
+            auto decoded = std::string{};
+            StringUtils::base64Decode(payload.get_ref<const std::string&>(), decoded);
+            messages.emplace_back(Message{std::move(decoded), std::move(channel)});
+        }
+        else
+        {
+            messages.emplace_back(Message{payload.dump(), std::move(channel)});
+        }
     };
 
     try
@@ -149,6 +237,7 @@ std::vector<GatewaySubdeviceMessage> WolkaboutGatewaySubdeviceProtocol::parseInc
     catch (const std::exception& exception)
     {
         LOG(ERROR) << "Failed to parse incoming subdevice message -> '" << exception.what() << "'.";
+        WolkaboutProtocol::countParseFailure(*message);
         return messages;
     }
 }
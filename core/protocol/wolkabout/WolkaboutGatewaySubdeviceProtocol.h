@@ -41,6 +41,9 @@ public:
     std::unique_ptr<Message> makeOutboundMessage(const std::string& deviceKey,
                                                  const GatewaySubdeviceMessage& message) override;
 
+    std::unique_ptr<Message> makeOutboundMessage(const std::string& deviceKey,
+                                                 const std::vector<GatewaySubdeviceMessage>& messages) override;
+
     std::vector<GatewaySubdeviceMessage> parseIncomingSubdeviceMessage(std::shared_ptr<Message> message) override;
 
 private:
@@ -65,6 +65,7 @@ std::unique_ptr<PlatformStatusMessage> WolkaboutPlatformStatusProtocol::parsePla
     if (type != MessageType::PLATFORM_CONNECTION_STATUS)
     {
         LOG(ERROR) << errorPrefix << " -> The message is not a 'PlatformStatus' message.";
+        WolkaboutProtocol::countParseFailure(*message);
         return nullptr;
     }
 
@@ -73,6 +74,7 @@ std::unique_ptr<PlatformStatusMessage> WolkaboutPlatformStatusProtocol::parsePla
     if (connectionStatus == ConnectivityStatus::NONE)
     {
         LOG(ERROR) << errorPrefix << " -> The connection status value of the message is not valid.";
+        WolkaboutProtocol::countParseFailure(*message);
         return nullptr;
     }
     return std::unique_ptr<PlatformStatusMessage>(new PlatformStatusMessage(connectionStatus));
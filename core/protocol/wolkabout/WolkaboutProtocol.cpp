@@ -16,6 +16,8 @@
 
 #include "core/protocol/wolkabout/WolkaboutProtocol.h"
 
+#include "core/utilities/Metrics.h"
+
 #include <nlohmann/json-schema.hpp>
 
 using nlohmann::json;
@@ -180,6 +182,14 @@ MessageType WolkaboutProtocol::getMessageType(const Message& message)
     return messageTypeFromString(section);
 }
 
+void WolkaboutProtocol::countParseFailure(const Message& message)
+{
+    MetricsRegistry::getInstance()
+      .counter("wolkabout_protocol_parse_failures_total", "Inbound messages the protocols failed to parse",
+               {{"type", toString(getMessageType(message))}})
+      .increment();
+}
+
 DeviceType WolkaboutProtocol::getDeviceType(const Message& message)
 {
     // Take the topic, and extract its first part
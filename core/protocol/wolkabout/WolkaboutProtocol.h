@@ -89,6 +89,14 @@ public:
      */
     static bool validateJSONPayload(const Message& message);
 
+    /**
+     * This is a helper method that the protocols call for every inbound message they fail to parse. The failures are
+     * counted by the `wolkabout_protocol_parse_failures_total` metric, labelled by the type of the message.
+     *
+     * @param message The message that could not be parsed.
+     */
+    static void countParseFailure(const Message& message);
+
     // Some constants that are used throughout the code.
     static std::string CHANNEL_DELIMITER;
     static std::string DEVICE_TO_PLATFORM_DIRECTION;
@@ -256,6 +256,7 @@ WolkaboutRegistrationProtocol::parseChildrenSynchronizationResponse(const std::s
     if (type != MessageType::CHILDREN_SYNCHRONIZATION_RESPONSE)
     {
         LOG(ERROR) << errorPrefix << " -> The message is not a 'ChildrenSynchronizationResponse' message.";
+        WolkaboutProtocol::countParseFailure(*message);
         return nullptr;
     }
 
@@ -272,6 +273,7 @@ WolkaboutRegistrationProtocol::parseChildrenSynchronizationResponse(const std::s
     catch (const std::exception& exception)
     {
         LOG(ERROR) << errorPrefix << " -> '" << exception.what() << "'.";
+        WolkaboutProtocol::countParseFailure(*message);
         return nullptr;
     }
 }
@@ -287,6 +289,7 @@ std::unique_ptr<DeviceRegistrationResponseMessage> WolkaboutRegistrationProtocol
     if (type != MessageType::DEVICE_REGISTRATION_RESPONSE)
     {
         LOG(ERROR) << errorPrefix << " -> The message is not a 'DeviceRegistrationResponse' message.";
+        WolkaboutProtocol::countParseFailure(*message);
         return nullptr;
     }
 
@@ -297,6 +300,7 @@ std::unique_ptr<DeviceRegistrationResponseMessage> WolkaboutRegistrationProtocol
         if (!j.is_object())
         {
             LOG(ERROR) << errorPrefix << " -> The payload is not a valid JSON object.";
+            WolkaboutProtocol::countParseFailure(*message);
             return nullptr;
         }
 
@@ -311,6 +315,7 @@ std::unique_ptr<DeviceRegistrationResponseMessage> WolkaboutRegistrationProtocol
     catch (const std::exception& exception)
     {
         LOG(ERROR) << errorPrefix << " -> An exception was thrown '" << exception.what() << "'.";
+        WolkaboutProtocol::countParseFailure(*message);
         return nullptr;
     }
 }
@@ -326,6 +331,7 @@ std::unique_ptr<RegisteredDevicesResponseMessage> WolkaboutRegistrationProtocol:
     if (type != MessageType::REGISTERED_DEVICES_RESPONSE)
     {
         LOG(ERROR) << errorPrefix << " -> The message is not a 'RegisteredDeviceResponse' message.";
+        WolkaboutProtocol::countParseFailure(*message);
         return nullptr;
     }
 
@@ -354,6 +360,7 @@ std::unique_ptr<RegisteredDevicesResponseMessage> WolkaboutRegistrationProtocol:
     catch (const std::exception& exception)
     {
         LOG(ERROR) << errorPrefix << " -> An exception was thrown '" << exception.what() << "'.";
+        WolkaboutProtocol::countParseFailure(*message);
         return nullptr;
     }
 }
@@ -41,6 +41,14 @@ public:
 
     bool isEmpty() const;
 
+    /**
+     * This method checks whether both the pushed items and the items waiting to be popped are gone, unlike `isEmpty`
+     * that only looks at the items that can be popped right now.
+     *
+     * @return Whether the buffer holds no items at all.
+     */
+    bool isDrained() const;
+
     void swapBuffers();
 
     void notify();
@@ -123,6 +131,14 @@ template <class T> bool Buffer<T>::isEmpty() const
     return m_popQueue.empty();
 }
 
+template <class T> bool Buffer<T>::isDrained() const
+{
+    std::lock_guard<std::mutex> pushGuard{m_pushLock};
+    std::lock_guard<std::mutex> popGuard{m_popLock};
+
+    return m_pushQueue.empty() && m_popQueue.empty();
+}
+
 template <class T> void Buffer<T>::notify()
 {
     m_condition.notify_one();
@@ -16,9 +16,9 @@
 
 #include "core/utilities/ByteUtils.h"
 
+#include "core/utilities/Hasher.h"
+
 #include <iomanip>
-#include <openssl/md5.h>
-#include <openssl/sha.h>
 #include <random>
 #include <sstream>
 
@@ -98,30 +98,15 @@ std::string ByteUtils::toUUIDString(const ByteArray& data)
 
 ByteArray ByteUtils::hashSHA256(const ByteArray& value)
 {
-    unsigned char digest[SHA256_DIGEST_LENGTH];
-
-    SHA256(&value[0], value.size(), reinterpret_cast<unsigned char*>(&digest));
-
-    ByteArray ret{};
-
-    for (int i = 0; i < SHA256_DIGEST_LENGTH; ++i)
-    {
-        ret.push_back(digest[i]);
-    }
-
-    return ret;
+    Hasher hasher{HashAlgorithm::SHA256};
+    hasher.update(value);
+    return hasher.finalize();
 }
 
 ByteArray ByteUtils::hashMDA5(const ByteArray& value)
 {
-    std::uint8_t hashCStr[MD5_DIGEST_LENGTH];
-    auto context = MD5_CTX();
-    MD5_Init(&context);
-    MD5_Update(&context, value.data(), value.size());
-    MD5_Final(hashCStr, &context);
-    auto hash = ByteArray{};
-    for (auto i = std::uint32_t{0}; i < MD5_DIGEST_LENGTH; ++i)
-        hash.emplace_back(hashCStr[i]);
-    return hash;
+    Hasher hasher{HashAlgorithm::MD5};
+    hasher.update(value);
+    return hasher.finalize();
 }
 }    // namespace wolkabout
@@ -26,6 +26,36 @@ namespace wolkabout
 using Byte = std::uint8_t;
 using ByteArray = std::vector<Byte>;
 
+/**
+ * This is a non-owning view over a contiguous range of bytes.
+ * The owner of the bytes must outlive the view.
+ */
+class ByteView
+{
+public:
+    ByteView() : m_data(nullptr), m_size(0) {}
+
+    ByteView(const Byte* data, std::size_t size) : m_data(data), m_size(size) {}
+
+    ByteView(const ByteArray& data) : m_data(data.data()), m_size(data.size()) {}
+
+    const Byte* data() const { return m_data; }
+
+    std::size_t size() const { return m_size; }
+
+    bool empty() const { return m_size == 0; }
+
+    const Byte* begin() const { return m_data; }
+
+    const Byte* end() const { return m_data + m_size; }
+
+    ByteArray toByteArray() const { return ByteArray(begin(), end()); }
+
+private:
+    const Byte* m_data;
+    std::size_t m_size;
+};
+
 class ByteUtils
 {
 public:
@@ -25,7 +25,10 @@
 namespace wolkabout
 {
 CommandBuffer::CommandBuffer()
-: m_isRunning(true), m_worker(std::unique_ptr<std::thread>(new std::thread(&CommandBuffer::run, this)))
+: m_queuedCommands(MetricsRegistry::getInstance().gauge("wolkabout_command_buffer_commands",
+                                                      "Commands waiting to be executed by a command buffer"))
+, m_isRunning(true)
+, m_worker(std::unique_ptr<std::thread>(new std::thread(&CommandBuffer::run, this)))
 {
 }
 
@@ -39,6 +42,7 @@ void CommandBuffer::pushCommand(const std::shared_ptr<Command>& command)
     std::unique_lock<std::mutex> unique_lock(m_lock);
 
     m_pushCommandQueue.push(command);
+    m_queuedCommands.increment();
 
     notify();
 }
@@ -55,6 +59,12 @@ void CommandBuffer::stop()
     {
         m_worker->join();
     }
+
+    // The commands left behind are never going to be executed
+    std::lock_guard<std::mutex> lg{m_lock};
+    m_queuedCommands.add(-static_cast<std::int64_t>(m_pushCommandQueue.size() + m_popCommandQueue.size()));
+    m_pushCommandQueue = decltype(m_pushCommandQueue){};
+    m_popCommandQueue = decltype(m_popCommandQueue){};
 }
 
 std::shared_ptr<CommandBuffer::Command> CommandBuffer::popCommand()
@@ -66,6 +76,7 @@ std::shared_ptr<CommandBuffer::Command> CommandBuffer::popCommand()
 
     std::shared_ptr<Command> command = m_popCommandQueue.front();
     m_popCommandQueue.pop();
+    m_queuedCommands.decrement();
     return command;
 }
 
@@ -17,6 +17,8 @@
 #ifndef WOLKABOUTCORE_COMMAND_BUFFER_H
 #define WOLKABOUTCORE_COMMAND_BUFFER_H
 
+#include "core/utilities/Metrics.h"
+
 #include <atomic>
 #include <condition_variable>
 #include <functional>
@@ -59,6 +61,8 @@ private:
 
     std::condition_variable m_condition;
 
+    Gauge& m_queuedCommands;
+
     std::atomic_bool m_isRunning;
     std::unique_ptr<std::thread> m_worker;
 };
@@ -18,13 +18,17 @@
 
 #include "Logger.h"
 
+#include <algorithm>
+#include <cstdio>
 #include <dirent.h>
 #include <fstream>
 #include <sys/stat.h>
+#include <zlib.h>
 
 namespace wolkabout
 {
 const char FileSystemUtils::PATH_DELIMITER = '/';
+const std::size_t FileSystemUtils::FILE_BUFFER_SIZE = 64 * 1024;
 
 bool FileSystemUtils::isFilePresent(const std::string& filePath)
 {
@@ -136,8 +140,96 @@ bool FileSystemUtils::readBinaryFileContent(const std::string& filePath, ByteArr
         return false;
     }
 
-    content =
-      ByteUtils::toByteArray(std::string((std::istreambuf_iterator<char>(ifstream)), std::istreambuf_iterator<char>()));
+    // Files like the ones in /proc report no size, so the file is read in chunks until its end. The size of a
+    // regular file is only used to make room for the content up front.
+    struct stat fileStat;
+    content.clear();
+    if (stat(filePath.c_str(), &fileStat) == 0 && fileStat.st_size > 0)
+    {
+        content.reserve(static_cast<std::size_t>(fileStat.st_size));
+    }
+
+    // Read the file straight into the array, without any intermediate copies
+    while (ifstream)
+    {
+        // A full array is only grown if there is more to read
+        if (content.size() == content.capacity() && ifstream.peek() == std::ifstream::traits_type::eof())
+        {
+            break;
+        }
+
+        const auto offset = content.size();
+        content.resize(offset + std::max(FILE_BUFFER_SIZE, content.capacity() - offset));
+        ifstream.read(reinterpret_cast<char*>(content.data() + offset),
+                      static_cast<std::streamsize>(content.size() - offset));
+        content.resize(offset + static_cast<std::size_t>(ifstream.gcount()));
+    }
+
+    return !ifstream.bad();
+}
+
+bool FileSystemUtils::hashFile(const std::string& filePath, HashAlgorithm algorithm, ByteArray& hash)
+{
+    std::ifstream ifstream(filePath, std::ifstream::binary);
+    if (!ifstream.is_open())
+    {
+        return false;
+    }
+
+    try
+    {
+        Hasher hasher{algorithm};
+        auto buffer = ByteArray(FILE_BUFFER_SIZE);
+        while (ifstream)
+        {
+            ifstream.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+            hasher.update(buffer.data(), static_cast<std::size_t>(ifstream.gcount()));
+        }
+        if (ifstream.bad())
+        {
+            return false;
+        }
+
+        hash = hasher.finalize();
+        return true;
+    }
+    catch (const std::exception& exception)
+    {
+        LOG(ERROR) << "Failed to hash the file '" << filePath << "' -> '" << exception.what() << "'.";
+        return false;
+    }
+}
+
+bool FileSystemUtils::compressFile(const std::string& filePath, const std::string& compressedFilePath)
+{
+    std::ifstream ifstream(filePath, std::ifstream::binary);
+    if (!ifstream.is_open())
+    {
+        return false;
+    }
+
+    const auto partialFilePath = compressedFilePath + ".part";
+    gzFile compressed = gzopen(partialFilePath.c_str(), "wb");
+    if (compressed == nullptr)
+    {
+        return false;
+    }
+
+    auto buffer = ByteArray(FILE_BUFFER_SIZE);
+    auto success = true;
+    while (ifstream && success)
+    {
+        ifstream.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        const auto size = static_cast<unsigned>(ifstream.gcount());
+        success = size == 0 || gzwrite(compressed, buffer.data(), size) == static_cast<int>(size);
+    }
+
+    success = gzclose(compressed) == Z_OK && success && !ifstream.bad();
+    if (!success || std::rename(partialFilePath.c_str(), compressedFilePath.c_str()) != 0)
+    {
+        std::remove(partialFilePath.c_str());
+        return false;
+    }
 
     return true;
 }
@@ -18,6 +18,7 @@
 #define WOLKABOUTCORE_FILESYSTEMUTILS_H
 
 #include "core/utilities/ByteUtils.h"
+#include "core/utilities/Hasher.h"
 
 #include <string>
 #include <vector>
@@ -47,8 +48,37 @@ public:
 
     static bool readFileContent(const std::string& filePath, std::string& content);
 
+    /**
+     * This is the method that will read the whole content of a file. The file is read until its end, so the files that
+     * do not report their size, like the ones in /proc, are read whole as well.
+     *
+     * @param filePath The path to the file.
+     * @param content The content of the file.
+     * @return Whether the file was successfully read.
+     */
     static bool readBinaryFileContent(const std::string& filePath, ByteArray& content);
 
+    /**
+     * This is the method that will calculate the hash of a file. The file is streamed through a fixed size buffer, so
+     * the memory usage does not depend on the size of the file.
+     *
+     * @param filePath The path to the file.
+     * @param algorithm The algorithm that will be used to calculate the hash.
+     * @param hash The calculated hash.
+     * @return Whether the file was successfully read and hashed.
+     */
+    static bool hashFile(const std::string& filePath, HashAlgorithm algorithm, ByteArray& hash);
+
+    /**
+     * This is the method that will compress a file into the gzip format. The file is streamed through a fixed size
+     * buffer, and the compressed file only appears under its name once it is complete.
+     *
+     * @param filePath The path to the file.
+     * @param compressedFilePath The path the compressed file will be written to.
+     * @return Whether the file was successfully compressed.
+     */
+    static bool compressFile(const std::string& filePath, const std::string& compressedFilePath);
+
     static std::vector<std::string> listFiles(const std::string& directoryPath);
 
     static std::string composePath(const std::string& fileName, const std::string& directory);
@@ -57,6 +87,7 @@ public:
 
 private:
     static const char PATH_DELIMITER;
+    static const std::size_t FILE_BUFFER_SIZE;
 };
 }    // namespace wolkabout
 
@@ -0,0 +1,71 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/utilities/Hasher.h"
+
+#include <openssl/evp.h>
+
+#include <stdexcept>
+
+namespace wolkabout
+{
+struct Hasher::Context
+{
+    Context() : context(EVP_MD_CTX_new()) {}
+
+    ~Context() { EVP_MD_CTX_free(context); }
+
+    EVP_MD_CTX* context;
+};
+
+Hasher::Hasher(HashAlgorithm algorithm) : m_algorithm(algorithm), m_context(new Context)
+{
+    if (m_context->context == nullptr)
+        throw std::runtime_error("Failed to create the Hasher -> Failed to allocate the hashing context.");
+    reset();
+}
+
+Hasher::~Hasher() = default;
+
+void Hasher::update(const Byte* data, std::size_t size)
+{
+    if (size > 0 && EVP_DigestUpdate(m_context->context, data, size) != 1)
+        throw std::runtime_error("Failed to update the Hasher -> The data could not be hashed.");
+}
+
+void Hasher::update(ByteView data)
+{
+    update(data.data(), data.size());
+}
+
+ByteArray Hasher::finalize()
+{
+    auto hash = ByteArray(EVP_MAX_MD_SIZE);
+    auto length = 0u;
+    if (EVP_DigestFinal_ex(m_context->context, hash.data(), &length) != 1)
+        throw std::runtime_error("Failed to finalize the Hasher -> The hash could not be calculated.");
+    hash.resize(length);
+    reset();
+    return hash;
+}
+
+void Hasher::reset()
+{
+    const auto type = m_algorithm == HashAlgorithm::MD5 ? EVP_md5() : EVP_sha256();
+    if (EVP_DigestInit_ex(m_context->context, type, nullptr) != 1)
+        throw std::runtime_error("Failed to initialize the Hasher -> The hashing algorithm is not available.");
+}
+}    // namespace wolkabout
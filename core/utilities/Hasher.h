@@ -0,0 +1,90 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WOLKABOUTCORE_HASHER_H
+#define WOLKABOUTCORE_HASHER_H
+
+#include "core/utilities/ByteUtils.h"
+
+#include <memory>
+
+namespace wolkabout
+{
+enum class HashAlgorithm
+{
+    MD5,
+    SHA256
+};
+
+/**
+ * This is an incremental hasher. Data can be fed into it piece by piece, so large files or transfers can be hashed
+ * without ever being held in memory as a whole.
+ */
+class Hasher
+{
+public:
+    /**
+     * Default constructor for the hasher.
+     *
+     * @param algorithm The algorithm that will be used to calculate the hash.
+     */
+    explicit Hasher(HashAlgorithm algorithm);
+
+    /**
+     * Overridden destructor. Releases the underlying hashing context.
+     */
+    ~Hasher();
+
+    Hasher(const Hasher&) = delete;
+    Hasher& operator=(const Hasher&) = delete;
+
+    /**
+     * This method feeds more data into the hash.
+     *
+     * @param data The pointer to the data.
+     * @param size The size of the data.
+     * @throw std::runtime_error If the data could not be hashed.
+     */
+    void update(const Byte* data, std::size_t size);
+
+    /**
+     * This method feeds more data into the hash.
+     *
+     * @param data The data to be added.
+     * @throw std::runtime_error If the data could not be hashed.
+     */
+    void update(ByteView data);
+
+    /**
+     * This method finishes the calculation and returns the hash. The hasher is reset afterwards, so it can be reused to
+     * calculate a new hash.
+     *
+     * @return The calculated hash.
+     * @throw std::runtime_error If the hash could not be calculated.
+     */
+    ByteArray finalize();
+
+private:
+    void reset();
+
+    HashAlgorithm m_algorithm;
+
+    struct Context;
+    std::unique_ptr<Context> m_context;
+};
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCORE_HASHER_H
@@ -0,0 +1,273 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/utilities/LogBuffer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <unistd.h>
+
+namespace
+{
+/**
+ * Every log is stored as the size of its operands, the level, the timestamp in microseconds, and the operands.
+ */
+const std::size_t HEADER_SIZE = sizeof(std::uint32_t) + sizeof(std::uint8_t) + sizeof(std::int64_t);
+
+const char* const LEVEL_NAMES[] = {"T", "D", "I", "W", "E", "O"};
+
+char* putDigits(char* destination, std::int64_t value, int digits)
+{
+    for (auto i = digits - 1; i >= 0; --i)
+    {
+        destination[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    return destination + digits;
+}
+
+/**
+ * This formats the timestamp the same way `format` does, but in UTC, with only integer arithmetic.
+ */
+std::size_t formatUtc(std::int64_t timestamp, char* destination)
+{
+    const std::int64_t SECONDS_PER_DAY = 86400;
+
+    auto seconds = timestamp / 1000000;
+    auto days = seconds / SECONDS_PER_DAY;
+    seconds %= SECONDS_PER_DAY;
+    if (seconds < 0)
+    {
+        seconds += SECONDS_PER_DAY;
+        --days;
+    }
+
+    // The civil date of the day since the epoch, with the years starting in March
+    days += 719468;
+    const auto era = (days >= 0 ? days : days - 146096) / 146097;
+    const auto dayOfEra = days - era * 146097;
+    const auto yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const auto dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const auto shiftedMonth = (5 * dayOfYear + 2) / 153;
+    const auto day = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+    const auto month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+    const auto year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+
+    auto position = putDigits(destination, month, 2);
+    *position++ = '/';
+    position = putDigits(position, day, 2);
+    *position++ = '/';
+    position = putDigits(position, year, 4);
+    *position++ = ' ';
+    position = putDigits(position, seconds / 3600, 2);
+    *position++ = ':';
+    position = putDigits(position, seconds / 60 % 60, 2);
+    *position++ = ':';
+    position = putDigits(position, seconds % 60, 2);
+    return static_cast<std::size_t>(position - destination);
+}
+
+void writeAll(int descriptor, const char* data, std::size_t size)
+{
+    while (size > 0)
+    {
+        const auto written = ::write(descriptor, data, size);
+        if (written <= 0)
+        {
+            return;
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+}
+}    // namespace
+
+namespace wolkabout
+{
+const std::size_t LogBuffer::DEFAULT_CAPACITY;
+
+LogBuffer::LogBuffer(std::size_t capacity) : m_data(capacity), m_head{0}, m_used{0}, m_count{0} {}
+
+void LogBuffer::push(const Log& log)
+{
+    push(log, std::chrono::system_clock::now());
+}
+
+void LogBuffer::push(const Log& log, std::chrono::system_clock::time_point time)
+{
+    const auto& arguments = log.getArguments();
+    const auto size = HEADER_SIZE + arguments.size();
+    if (size > m_data.size())
+    {
+        return;
+    }
+
+    const auto argumentsSize = static_cast<std::uint32_t>(arguments.size());
+    const auto level = static_cast<std::uint8_t>(log.getLogLevel());
+    const auto timestamp = static_cast<std::int64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count());
+
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    // Overwrite the oldest logs until there is enough space
+    while (m_data.size() - m_used < size)
+    {
+        const auto oldest = recordSize(m_head);
+        m_head = (m_head + oldest) % m_data.size();
+        m_used -= oldest;
+        --m_count;
+    }
+
+    auto position = (m_head + m_used) % m_data.size();
+    write(position, &argumentsSize, sizeof(argumentsSize));
+    position = (position + sizeof(argumentsSize)) % m_data.size();
+    write(position, &level, sizeof(level));
+    position = (position + sizeof(level)) % m_data.size();
+    write(position, &timestamp, sizeof(timestamp));
+    position = (position + sizeof(timestamp)) % m_data.size();
+    write(position, arguments.data(), arguments.size());
+
+    m_used += size;
+    ++m_count;
+}
+
+std::vector<std::string> LogBuffer::format() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    auto lines = std::vector<std::string>{};
+    lines.reserve(m_count);
+
+    auto arguments = std::string{};
+    auto position = m_head;
+    for (std::size_t i = 0; i < m_count; ++i)
+    {
+        auto argumentsSize = std::uint32_t{0};
+        auto level = std::uint8_t{0};
+        auto timestamp = std::int64_t{0};
+        read(position, &argumentsSize, sizeof(argumentsSize));
+        read((position + sizeof(argumentsSize)) % m_data.size(), &level, sizeof(level));
+        read((position + sizeof(argumentsSize) + sizeof(level)) % m_data.size(), &timestamp, sizeof(timestamp));
+        arguments.resize(argumentsSize);
+        read((position + HEADER_SIZE) % m_data.size(), &arguments[0], argumentsSize);
+        position = (position + HEADER_SIZE + argumentsSize) % m_data.size();
+
+        const auto seconds = static_cast<std::time_t>(timestamp / 1000000);
+        std::tm time{};
+        localtime_r(&seconds, &time);
+        char date[32];
+        const auto dateLength = std::strftime(date, sizeof(date), "%m/%d/%Y %H:%M:%S", &time);
+
+        auto line = std::string{"["};
+        line.append(date, dateLength);
+        line += "] [";
+        line += LEVEL_NAMES[level < sizeof(LEVEL_NAMES) / sizeof(LEVEL_NAMES[0]) ? level : 0];
+        line += "] ";
+        line += Log::format(arguments.data(), arguments.size());
+        line += '\n';
+        lines.emplace_back(std::move(line));
+    }
+
+    return lines;
+}
+
+bool LogBuffer::dump(int descriptor) const
+{
+    std::unique_lock<std::mutex> lock{m_mutex, std::try_to_lock};
+    if (!lock.owns_lock())
+    {
+        const char skipped[] = "The log buffer was being written into, it is not written out\n";
+        writeAll(descriptor, skipped, sizeof(skipped) - 1);
+        return false;
+    }
+
+    // Only a single log can wrap around the end of the buffer, and it is copied here
+    char wrapped[4096];
+
+    auto position = m_head;
+    for (std::size_t i = 0; i < m_count; ++i)
+    {
+        auto argumentsSize = std::uint32_t{0};
+        auto level = std::uint8_t{0};
+        auto timestamp = std::int64_t{0};
+        read(position, &argumentsSize, sizeof(argumentsSize));
+        read((position + sizeof(argumentsSize)) % m_data.size(), &level, sizeof(level));
+        read((position + sizeof(argumentsSize) + sizeof(level)) % m_data.size(), &timestamp, sizeof(timestamp));
+
+        char header[40] = "[";
+        auto headerLength = 1 + formatUtc(timestamp, header + 1);
+        const char* levelName = LEVEL_NAMES[level < sizeof(LEVEL_NAMES) / sizeof(LEVEL_NAMES[0]) ? level : 0];
+        header[headerLength++] = ']';
+        header[headerLength++] = ' ';
+        header[headerLength++] = '[';
+        header[headerLength++] = levelName[0];
+        header[headerLength++] = ']';
+        header[headerLength++] = ' ';
+        writeAll(descriptor, header, headerLength);
+
+        // The operands are read in place, unless they wrap around the end of the buffer
+        const auto start = (position + HEADER_SIZE) % m_data.size();
+        if (start + argumentsSize <= m_data.size())
+        {
+            Log::write(descriptor, &m_data[start], argumentsSize);
+        }
+        else if (argumentsSize <= sizeof(wrapped))
+        {
+            read(start, wrapped, argumentsSize);
+            Log::write(descriptor, wrapped, argumentsSize);
+        }
+        else
+        {
+            const char truncated[] = "...";
+            writeAll(descriptor, truncated, sizeof(truncated) - 1);
+        }
+        writeAll(descriptor, "\n", 1);
+
+        position = (position + HEADER_SIZE + argumentsSize) % m_data.size();
+    }
+
+    return true;
+}
+
+std::size_t LogBuffer::size() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_count;
+}
+
+void LogBuffer::write(std::size_t position, const void* data, std::size_t size)
+{
+    const auto first = std::min(size, m_data.size() - position);
+    std::memcpy(&m_data[position], data, first);
+    std::memcpy(&m_data[0], static_cast<const char*>(data) + first, size - first);
+}
+
+void LogBuffer::read(std::size_t position, void* data, std::size_t size) const
+{
+    const auto first = std::min(size, m_data.size() - position);
+    std::memcpy(data, &m_data[position], first);
+    std::memcpy(static_cast<char*>(data) + first, &m_data[0], size - first);
+}
+
+std::size_t LogBuffer::recordSize(std::size_t position) const
+{
+    auto argumentsSize = std::uint32_t{0};
+    read(position, &argumentsSize, sizeof(argumentsSize));
+    return HEADER_SIZE + argumentsSize;
+}
+}    // namespace wolkabout
@@ -0,0 +1,104 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WOLKABOUTCORE_LOGBUFFER_H
+#define WOLKABOUTCORE_LOGBUFFER_H
+
+#include "core/utilities/Logger.h"
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace wolkabout
+{
+/**
+ * This is a ring buffer of the most recent logs. The logs are kept in the binary form they were recorded in, as the
+ * level, the timestamp and the raw operands, and are only formatted once the buffer is read. Once the buffer is full,
+ * the oldest logs are overwritten.
+ */
+class LogBuffer
+{
+public:
+    /**
+     * The default capacity of the buffer, enough for around a hundred thousand short logs.
+     */
+    static const std::size_t DEFAULT_CAPACITY = 4 * 1024 * 1024;
+
+    /**
+     * Default constructor for the log buffer.
+     *
+     * @param capacity The amount of bytes the buffer will hold.
+     */
+    explicit LogBuffer(std::size_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * This method places a log into the buffer, timestamped with the current time.
+     *
+     * @param log The log to be stored.
+     */
+    void push(const Log& log);
+
+    /**
+     * This method places a log into the buffer. Logs larger than the whole buffer are dropped.
+     *
+     * @param log The log to be stored.
+     * @param time The time the log was made at.
+     */
+    void push(const Log& log, std::chrono::system_clock::time_point time);
+
+    /**
+     * This method formats the logs in the buffer, from the oldest to the newest.
+     *
+     * @return The formatted logs, in the form the console logs are written in, but with the full year.
+     */
+    std::vector<std::string> format() const;
+
+    /**
+     * This method writes the logs in the buffer into a file descriptor, from the oldest to the newest. Nothing is
+     * allocated, and the buffer is skipped instead of waited for if it is being written into, so this can be called
+     * from a signal handler. The times are written in UTC, as the local time zone can not be looked up safely.
+     *
+     * @param descriptor The file descriptor the logs are written into.
+     * @return Whether the logs were written, false if the buffer was being written into.
+     */
+    bool dump(int descriptor) const;
+
+    /**
+     * This method returns the amount of logs in the buffer.
+     *
+     * @return The amount of logs.
+     */
+    std::size_t size() const;
+
+private:
+    void write(std::size_t position, const void* data, std::size_t size);
+    void read(std::size_t position, void* data, std::size_t size) const;
+
+    std::size_t recordSize(std::size_t position) const;
+
+    mutable std::mutex m_mutex;
+
+    std::vector<char> m_data;
+    std::size_t m_head;
+    std::size_t m_used;
+    std::size_t m_count;
+};
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCORE_LOGBUFFER_H
@@ -0,0 +1,139 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/utilities/LogLimiter.h"
+
+namespace wolkabout
+{
+const std::size_t LogLimiter::LEVEL_COUNT;
+
+LogLimiter::LogLimiter() : m_rateLimits{}, m_collapse{}, m_lastLevel{LogLevel::OFF}, m_repeated{0} {}
+
+void LogLimiter::setRateLimit(LogLevel level, std::size_t logs, std::chrono::milliseconds period)
+{
+    if (level == LogLevel::OFF)
+        return;
+
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_rateLimits[static_cast<std::size_t>(level)] = RateLimit{logs, period};
+}
+
+void LogLimiter::setCollapseRepeated(LogLevel level, bool collapse)
+{
+    if (level == LogLevel::OFF)
+        return;
+
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_collapse[static_cast<std::size_t>(level)] = collapse;
+}
+
+std::vector<Log> LogLimiter::filter(const Log& log, std::chrono::steady_clock::time_point now)
+{
+    auto output = std::vector<Log>{};
+    if (log.getLogLevel() == LogLevel::OFF)
+        return output;
+
+    std::lock_guard<std::mutex> lock{m_mutex};
+    if (passesRateLimit(log, now, output) && passesCollapse(log, output))
+        output.emplace_back(log);
+    return output;
+}
+
+bool LogLimiter::passesRateLimit(const Log& log, std::chrono::steady_clock::time_point now, std::vector<Log>& output)
+{
+    const auto& limit = m_rateLimits[static_cast<std::size_t>(log.getLogLevel())];
+    if (limit.logs == 0 || log.getFile() == nullptr)
+        return true;
+
+    const auto source = std::make_pair(log.getFile(), log.getLine());
+    auto& site = m_callSites[source];
+    if (site.logged == 0 || now - site.windowStart >= limit.period)
+    {
+        if (site.suppressed > 0)
+            output.emplace_back(suppressedSummary(log.getLogLevel(), source, site.suppressed));
+
+        site = CallSite{now, 0, 0, log.getLogLevel()};
+    }
+
+    if (site.logged < limit.logs)
+    {
+        ++site.logged;
+        return true;
+    }
+
+    ++site.suppressed;
+    return false;
+}
+
+bool LogLimiter::passesCollapse(const Log& log, std::vector<Log>& output)
+{
+    if (m_collapse[static_cast<std::size_t>(log.getLogLevel())] && log.getLogLevel() == m_lastLevel &&
+        log.getArguments() == m_lastArguments)
+    {
+        ++m_repeated;
+        return false;
+    }
+
+    takeRepeatedSummary(output);
+    m_lastLevel = log.getLogLevel();
+    m_lastArguments = log.getArguments();
+    return true;
+}
+
+std::vector<Log> LogLimiter::takeSummaries(std::chrono::steady_clock::time_point now, bool all)
+{
+    auto output = std::vector<Log>{};
+
+    std::lock_guard<std::mutex> lock{m_mutex};
+    takeRepeatedSummary(output);
+    for (auto& callSite : m_callSites)
+    {
+        auto& site = callSite.second;
+        if (site.suppressed == 0)
+            continue;
+
+        // A call site past its period starts a new one with its next log, just like when the summary is made by it
+        const auto ended = now - site.windowStart >= m_rateLimits[static_cast<std::size_t>(site.level)].period;
+        if (!ended && !all)
+            continue;
+
+        output.emplace_back(suppressedSummary(site.level, callSite.first, site.suppressed));
+        site.suppressed = 0;
+        if (ended)
+            site.logged = 0;
+    }
+    return output;
+}
+
+Log LogLimiter::suppressedSummary(LogLevel level, const std::pair<const char*, int>& source, std::size_t suppressed)
+{
+    auto summary = Log{level};
+    summary << "Suppressed " << suppressed << " logs from " << source.first << ":" << source.second;
+    return summary;
+}
+
+void LogLimiter::takeRepeatedSummary(std::vector<Log>& output)
+{
+    // The last log is kept, so the logs identical to it are still collapsed after the summary
+    if (m_repeated > 0)
+    {
+        auto summary = Log{m_lastLevel};
+        summary << "Last message repeated " << m_repeated << " times";
+        output.emplace_back(std::move(summary));
+        m_repeated = 0;
+    }
+}
+}    // namespace wolkabout
@@ -0,0 +1,115 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WOLKABOUTCORE_LOGLIMITER_H
+#define WOLKABOUTCORE_LOGLIMITER_H
+
+#include "core/utilities/Logger.h"
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace wolkabout
+{
+/**
+ * This class keeps log storms out of the outputs. It limits the amount of logs a single `LOG` call site can make in a
+ * period of time, and collapses consecutive identical logs into a single "Last message repeated N times" log. Both are
+ * configured per log level, and are disabled by default.
+ */
+class LogLimiter
+{
+public:
+    LogLimiter();
+
+    /**
+     * This method limits the amount of logs of a level a single call site can make.
+     *
+     * @param level The log level that is limited.
+     * @param logs The amount of logs a call site can make in the period. Zero disables the limit.
+     * @param period The period the amount of logs is counted in.
+     */
+    void setRateLimit(LogLevel level, std::size_t logs, std::chrono::milliseconds period);
+
+    /**
+     * This method sets whether consecutive identical logs of a level are collapsed into a single log.
+     *
+     * @param level The log level.
+     * @param collapse Whether the logs are collapsed.
+     */
+    void setCollapseRepeated(LogLevel level, bool collapse);
+
+    /**
+     * This method decides which logs get written out instead of the log. Those are the summaries of the logs that were
+     * held back before it, and the log itself, unless it is held back too.
+     *
+     * @param log The new log.
+     * @param now The current time.
+     * @return The logs that should be written out, in order.
+     */
+    std::vector<Log> filter(const Log& log, std::chrono::steady_clock::time_point now);
+
+    /**
+     * This method returns the summaries of the logs that were held back, which would otherwise wait for a later log.
+     * The logs suppressed at a call site are summarized once its period has passed, and the repeated logs right away.
+     *
+     * @param now The current time.
+     * @param all Whether the logs suppressed at the call sites still in their period are summarized too.
+     * @return The summaries, in order.
+     */
+    std::vector<Log> takeSummaries(std::chrono::steady_clock::time_point now, bool all);
+
+private:
+    struct RateLimit
+    {
+        std::size_t logs;
+        std::chrono::steady_clock::duration period;
+    };
+
+    struct CallSite
+    {
+        std::chrono::steady_clock::time_point windowStart;
+        std::size_t logged;
+        std::size_t suppressed;
+        LogLevel level;
+    };
+
+    static const std::size_t LEVEL_COUNT = static_cast<std::size_t>(LogLevel::OFF);
+
+    bool passesRateLimit(const Log& log, std::chrono::steady_clock::time_point now, std::vector<Log>& output);
+    bool passesCollapse(const Log& log, std::vector<Log>& output);
+
+    static Log suppressedSummary(LogLevel level, const std::pair<const char*, int>& source, std::size_t suppressed);
+    void takeRepeatedSummary(std::vector<Log>& output);
+
+    std::mutex m_mutex;
+
+    RateLimit m_rateLimits[LEVEL_COUNT];
+    bool m_collapse[LEVEL_COUNT];
+
+    std::map<std::pair<const char*, int>, CallSite> m_callSites;
+
+    LogLevel m_lastLevel;
+    std::string m_lastArguments;
+    std::size_t m_repeated;
+};
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCORE_LOGLIMITER_H
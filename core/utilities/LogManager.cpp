@@ -4,16 +4,43 @@
 
 #include "LogManager.h"
 
+#include "ByteUtils.h"
 #include "FileSystemUtils.h"
 #include "Logger.h"
 #include "StringUtils.h"
 #include "Timer.h"
 
 #include <algorithm>
+#include <cerrno>
+#include <climits>
 #include <ctime>
+#include <cstdio>
+#include <dirent.h>
 #include <exception>
 #include <functional>
 #include <iostream>
+#include <poll.h>
+#include <sstream>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_set>
+#include <utime.h>
+
+namespace
+{
+const std::chrono::milliseconds WATCH_COALESCE_PERIOD{250};
+const std::size_t EVENT_BUFFER_SIZE = 4096;
+const std::chrono::minutes COMPRESS_INTERVAL{1};
+const std::chrono::minutes COMPRESS_QUIET_PERIOD{10};
+const std::string COMPRESSED_EXTENSION = ".gz";
+const std::string UPLOAD_MANIFEST_FILE = ".upload_manifest";
+const std::string UPLOAD_MANIFEST_TEMPORARY_FILE = UPLOAD_MANIFEST_FILE + ".part";
+const std::chrono::seconds UPLOAD_PAUSE_CHECK_INTERVAL{1};
+const std::chrono::milliseconds UPLOAD_RETRY_BACKOFF{250};
+const unsigned MAX_UPLOAD_INTERRUPTIONS = 4;
+}    // namespace
 
 namespace wolkabout
 {
@@ -24,6 +51,13 @@ LogManager::LogManager(const std::string& logDirectory, const std::string& logEx
 : m_logDirectory(logDirectory)
 , m_logExtension(logExtension)
 , m_maxSize(maxSize)
+, m_compressLogs(false)
+, m_reindex(true)
+, m_inotifyDescriptor(-1)
+, m_watchStopDescriptor(-1)
+, m_overflowUnfixed(false)
+, m_uploadBandwidth(0)
+, m_uploadStopped(false)
 , m_running(false)
 , m_deleteEvery(deleteEvery)
 , m_deleteAfter(deleteStaleAfter)
@@ -38,6 +72,7 @@ LogManager::LogManager(const std::string& logDirectory, const std::string& logEx
 LogManager::~LogManager()
 {
     stop();
+    stopWatching();
 }
 
 bool LogManager::isRunning()
@@ -59,7 +94,15 @@ void LogManager::start()
 
     m_running = true;
 
-    if (m_maxSize > 0)
+    {
+        std::lock_guard<std::mutex> lock{m_uploadWaitMutex};
+        m_uploadStopped = false;
+    }
+
+    startWatching();
+
+    // Without the directory watch, the overflow is checked periodically
+    if (m_maxSize > 0 && m_inotifyDescriptor < 0)
         m_overflowTimer.run(std::chrono::minutes(5), [&] { checkLogOverflow(); });
 
     if (m_deleteEvery != std::chrono::hours(0))
@@ -67,6 +110,9 @@ void LogManager::start()
 
     if (m_uploadEvery != std::chrono::hours(0) && m_logUploader)
         m_uploadTimer.run(m_uploadEvery, [&] { uploadLogs(); });
+
+    if (m_compressLogs)
+        m_compressTimer.run(COMPRESS_INTERVAL, [&] { compressLogs(); });
 }
 
 void LogManager::stop()
@@ -76,9 +122,19 @@ void LogManager::stop()
 
     m_running = false;
 
+    // An upload waiting for the pause or the bandwidth is woken up, so the timer can be stopped
+    {
+        std::lock_guard<std::mutex> lock{m_uploadWaitMutex};
+        m_uploadStopped = true;
+    }
+    m_uploadWaitCondition.notify_all();
+
     m_uploadTimer.stop();
     m_deleteTimer.stop();
     m_overflowTimer.stop();
+    m_compressTimer.stop();
+
+    stopWatching();
 }
 
 const std::string& LogManager::getLogDirectory() const
@@ -95,6 +151,10 @@ void LogManager::setLogDirectory(const std::string& logDirectory)
     {
         restart();
     }
+    else if (m_running)
+    {
+        startWatching();
+    }
 }
 
 int LogManager::getMaxSize() const
@@ -176,6 +236,10 @@ void LogManager::setLogExtension(const std::string& logExtension)
     {
         restart();
     }
+    else if (m_running)
+    {
+        startWatching();
+    }
 }
 
 void LogManager::setLogUploader(const std::shared_ptr<wolkabout::LogUploader>& logUploader)
@@ -183,6 +247,43 @@ void LogManager::setLogUploader(const std::shared_ptr<wolkabout::LogUploader>& l
     m_logUploader = logUploader;
 }
 
+bool LogManager::getCompressLogs() const
+{
+    return m_compressLogs;
+}
+
+std::uint64_t LogManager::getUploadBandwidth() const
+{
+    return m_uploadBandwidth;
+}
+
+void LogManager::setUploadBandwidth(std::uint64_t bytesPerSecond)
+{
+    m_uploadBandwidth = bytesPerSecond;
+
+    if (m_logUploader)
+        m_logUploader->setBandwidthLimit(bytesPerSecond);
+}
+
+void LogManager::setUploadPaused(std::function<bool()> uploadPaused)
+{
+    {
+        std::lock_guard<std::mutex> lock{m_uploadWaitMutex};
+        m_uploadPaused = std::move(uploadPaused);
+    }
+    m_uploadWaitCondition.notify_all();
+}
+
+void LogManager::setCompressLogs(bool compressLogs)
+{
+    m_compressLogs = compressLogs;
+
+    if (m_running)
+    {
+        restart();
+    }
+}
+
 std::vector<std::string> LogManager::getLogsToDelete()
 {
     std::vector<std::string> logFiles;
@@ -193,23 +294,19 @@ std::vector<std::string> LogManager::getLogsToDelete()
         return logFiles;
     }
 
-    logFiles = getLogFileNames();
-
-    logFiles.erase(std::remove_if(logFiles.begin(), logFiles.end(),
-                                  [&](const std::string& file) -> bool {
-                                      return std::chrono::duration<double>(std::difftime(
-                                               std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()),
-                                               FileSystemUtils::getLastModified(
-                                                 FileSystemUtils::composePath(file, m_logDirectory)))) < m_deleteAfter;
-                                  }),
-                   logFiles.end());
+    const auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    for (const auto& logFile : getLogFiles())
+    {
+        if (std::chrono::duration<double>(std::difftime(now, logFile.second.lastModified)) >= m_deleteAfter)
+            logFiles.emplace_back(logFile.first);
+    }
 
     return logFiles;
 }
 
-std::vector<std::string> LogManager::getLogsToUpload()
+std::vector<std::pair<std::string, LogManager::LogFile>> LogManager::getLogsToUpload()
 {
-    std::vector<std::string> logFiles;
+    std::vector<std::pair<std::string, LogFile>> logFiles;
 
     if (!m_logUploader)
     {
@@ -223,30 +320,48 @@ std::vector<std::string> LogManager::getLogsToUpload()
         return logFiles;
     }
 
-    logFiles = getLogFileNames();
-
-    std::vector<std::string> remoteFiles = m_logUploader->getRemoteLogs();
+    loadUploadManifest();
 
-    for (auto log : remoteFiles)
+    std::vector<std::pair<std::string, LogFile>> unknownFiles;
+    const auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    for (const auto& logFile : getLogFiles())
     {
-        log = wolkabout::StringUtils::removePrefix(log, m_logDirectory + "/");
+        if (std::chrono::duration<double>(std::difftime(now, logFile.second.lastModified)) < m_uploadAfter)
+            continue;
+
+        if (m_uploadManifest.find(logFile.first) == m_uploadManifest.end())
+            unknownFiles.emplace_back(logFile);
+        else if (!isUploaded(logFile.first, logFile.second))
+            logFiles.emplace_back(logFile);
     }
 
-    logFiles.erase(std::remove_if(logFiles.begin(), logFiles.end(),
-                                  [&](const std::string& file) -> bool {
-                                      return std::find(remoteFiles.begin(), remoteFiles.end(), file) !=
-                                             remoteFiles.end();
-                                  }),
-                   logFiles.end());
+    if (unknownFiles.empty())
+        return logFiles;
+
+    // Only the logs missing from the manifest need the remote listing, which is limited to the log directory of this
+    // device, as the devices sharing the remote server are told apart by the prefix of the remote names
+    const auto prefix = m_logUploader->getRemoteName(m_logDirectory + "/");
+    std::unordered_map<std::string, std::uint64_t> remoteFiles;
+    for (const auto& remoteFile : m_logUploader->getRemoteLogSizes(prefix))
+        remoteFiles.emplace(wolkabout::StringUtils::removePrefix(remoteFile.first, prefix), remoteFile.second);
+
+    auto manifestChanged = false;
+    for (const auto& logFile : unknownFiles)
+    {
+        // A remote log with the same name, but a different size, is an older or a partial upload of the log
+        const auto remoteFile = remoteFiles.find(logFile.first);
+        if (remoteFile == remoteFiles.end() || remoteFile->second != logFile.second.size)
+        {
+            logFiles.emplace_back(logFile);
+            continue;
+        }
+
+        markUploaded(logFile.first, logFile.second);
+        manifestChanged = true;
+    }
 
-    logFiles.erase(std::remove_if(logFiles.begin(), logFiles.end(),
-                                  [&](const std::string& file) -> bool {
-                                      return std::chrono::duration<double>(std::difftime(
-                                               std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()),
-                                               FileSystemUtils::getLastModified(
-                                                 FileSystemUtils::composePath(file, m_logDirectory)))) < m_uploadAfter;
-                                  }),
-                   logFiles.end());
+    if (manifestChanged)
+        saveUploadManifest();
 
     return logFiles;
 }
@@ -254,16 +369,367 @@ std::vector<std::string> LogManager::getLogsToUpload()
 std::vector<std::string> LogManager::getLogFileNames()
 {
     std::vector<std::string> logFiles;
+    for (const auto& logFile : getLogFiles())
+        logFiles.emplace_back(logFile.first);
+    return logFiles;
+}
+
+std::vector<std::pair<std::string, LogManager::LogFile>> LogManager::getLogFiles()
+{
+    std::lock_guard<std::mutex> lock{m_logFilesMutex};
+
+    if (m_inotifyDescriptor < 0 || m_reindex)
+    {
+        indexLogFiles();
+    }
+
+    std::vector<std::pair<std::string, LogFile>> logFiles;
+    logFiles.reserve(m_logFiles.size());
+    for (auto it = m_logFiles.begin(); it != m_logFiles.end();)
+    {
+        auto& logFile = it->second;
+        if (logFile.stale)
+        {
+            struct stat fileInfo;
+            if (stat(FileSystemUtils::composePath(it->first, m_logDirectory).c_str(), &fileInfo) != 0)
+            {
+                it = m_logFiles.erase(it);
+                continue;
+            }
+
+            logFile = LogFile{static_cast<std::uint64_t>(fileInfo.st_size), fileInfo.st_mtime, false};
+        }
+
+        logFiles.emplace_back(it->first, logFile);
+        ++it;
+    }
 
-    logFiles = FileSystemUtils::listFiles(m_logDirectory);
-    logFiles.erase(std::remove_if(logFiles.begin(), logFiles.end(),
-                                  [&](const std::string& file) -> bool {
-                                      return !wolkabout::StringUtils::endsWith(file, m_logExtension);
-                                  }),
-                   logFiles.end());
     return logFiles;
 }
 
+void LogManager::indexLogFiles()
+{
+    m_logFiles.clear();
+    for (const auto& file : FileSystemUtils::listFiles(m_logDirectory))
+    {
+        if (isLogFile(file))
+            m_logFiles.emplace(file, LogFile{0, 0, true});
+    }
+
+    m_reindex = false;
+}
+
+bool LogManager::isLogFile(const std::string& fileName) const
+{
+    if (wolkabout::StringUtils::startsWith(fileName, UPLOAD_MANIFEST_FILE))
+        return false;
+
+    return wolkabout::StringUtils::endsWith(fileName, m_logExtension) ||
+           wolkabout::StringUtils::endsWith(fileName, m_logExtension + COMPRESSED_EXTENSION);
+}
+
+bool LogManager::isCompressed(const std::string& fileName)
+{
+    return wolkabout::StringUtils::endsWith(fileName, COMPRESSED_EXTENSION);
+}
+
+void LogManager::loadUploadManifest()
+{
+    if (m_uploadManifestDirectory == m_logDirectory)
+        return;
+
+    m_uploadManifest.clear();
+    m_uploadManifestDirectory = m_logDirectory;
+
+    std::string content;
+    const auto path = FileSystemUtils::composePath(UPLOAD_MANIFEST_FILE, m_logDirectory);
+    if (!FileSystemUtils::isFilePresent(path) || !FileSystemUtils::readFileContent(path, content))
+        return;
+
+    // Every line holds the hash, size and modification time of an uploaded log, followed by its name
+    std::istringstream stream{content};
+    std::string line;
+    while (std::getline(stream, line))
+    {
+        std::istringstream lineStream{line};
+        UploadedLog uploadedLog;
+        std::string name;
+        if (!(lineStream >> uploadedLog.hash >> uploadedLog.size >> uploadedLog.lastModified) ||
+            !std::getline(lineStream >> std::ws, name) || name.empty())
+        {
+            LOG(WARN) << "Ignoring malformed upload manifest entry '" << line << "'";
+            continue;
+        }
+
+        if (uploadedLog.hash == "-")
+            uploadedLog.hash.clear();
+        m_uploadManifest[name] = uploadedLog;
+    }
+}
+
+void LogManager::saveUploadManifest()
+{
+    // Logs that no longer exist are dropped from the manifest
+    std::unordered_set<std::string> logFiles;
+    for (const auto& logFile : getLogFiles())
+        logFiles.emplace(logFile.first);
+
+    std::string content;
+    for (auto it = m_uploadManifest.begin(); it != m_uploadManifest.end();)
+    {
+        if (logFiles.find(it->first) == logFiles.end())
+        {
+            it = m_uploadManifest.erase(it);
+            continue;
+        }
+
+        content += (it->second.hash.empty() ? "-" : it->second.hash) + " " + std::to_string(it->second.size) + " " +
+                   std::to_string(it->second.lastModified) + " " + it->first + "\n";
+        ++it;
+    }
+
+    // The manifest is replaced at once, so a crash can not leave it half written
+    const auto path = FileSystemUtils::composePath(UPLOAD_MANIFEST_FILE, m_logDirectory);
+    const auto temporaryPath = FileSystemUtils::composePath(UPLOAD_MANIFEST_TEMPORARY_FILE, m_logDirectory);
+    if (!FileSystemUtils::createFileWithContent(temporaryPath, content) ||
+        std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+    {
+        LOG(WARN) << "Failed to save the upload manifest '" << path << "'";
+        FileSystemUtils::deleteFile(temporaryPath);
+    }
+}
+
+bool LogManager::isUploaded(const std::string& name, const LogFile& logFile)
+{
+    const auto it = m_uploadManifest.find(name);
+    if (it == m_uploadManifest.end() || it->second.size != logFile.size)
+        return false;
+
+    if (it->second.lastModified == logFile.lastModified)
+        return true;
+
+    // The log was touched, but it is the same log if the content did not change
+    if (it->second.hash.empty() || it->second.hash != hashLog(name))
+        return false;
+
+    it->second.lastModified = logFile.lastModified;
+    return true;
+}
+
+void LogManager::markUploaded(const std::string& name, const LogFile& logFile)
+{
+    m_uploadManifest[name] = UploadedLog{logFile.size, logFile.lastModified, hashLog(name)};
+}
+
+bool LogManager::isUploadPaused()
+{
+    std::function<bool()> uploadPaused;
+    {
+        std::lock_guard<std::mutex> lock{m_uploadWaitMutex};
+        uploadPaused = m_uploadPaused;
+    }
+
+    return uploadPaused && uploadPaused();
+}
+
+bool LogManager::waitWhileUploadPaused()
+{
+    if (!isUploadPaused())
+        return true;
+
+    LOG(INFO) << "Log uploads are paused";
+    do
+    {
+        std::unique_lock<std::mutex> lock{m_uploadWaitMutex};
+        if (m_uploadWaitCondition.wait_for(lock, UPLOAD_PAUSE_CHECK_INTERVAL, [this] { return m_uploadStopped; }))
+            return false;
+    } while (isUploadPaused());
+
+    LOG(INFO) << "Log uploads are resumed";
+    return true;
+}
+
+bool LogManager::waitBeforeUploadRetry(unsigned interruptions)
+{
+    // The last interrupted attempt is followed by one that can not be interrupted, so there is no point in waiting
+    if (interruptions >= MAX_UPLOAD_INTERRUPTIONS)
+        return true;
+
+    const auto backoff = UPLOAD_RETRY_BACKOFF * (1u << (interruptions - 1));
+    std::unique_lock<std::mutex> lock{m_uploadWaitMutex};
+    return !m_uploadWaitCondition.wait_for(lock, backoff, [this] { return m_uploadStopped; });
+}
+
+void LogManager::waitForUploadBandwidth(std::uint64_t size, std::chrono::steady_clock::time_point started)
+{
+    const auto bandwidth = m_uploadBandwidth.load();
+    if (bandwidth == 0)
+        return;
+
+    // The next upload starts only once this one would have taken its time at the full allowed rate
+    const auto duration = std::chrono::duration<double>(static_cast<double>(size) / static_cast<double>(bandwidth));
+    const auto end = started + std::chrono::duration_cast<std::chrono::steady_clock::duration>(duration);
+
+    std::unique_lock<std::mutex> lock{m_uploadWaitMutex};
+    m_uploadWaitCondition.wait_until(lock, end, [this] { return m_uploadStopped; });
+}
+
+std::string LogManager::hashLog(const std::string& name) const
+{
+    ByteArray hash;
+    if (!FileSystemUtils::hashFile(FileSystemUtils::composePath(name, m_logDirectory), HashAlgorithm::MD5, hash))
+        return "";
+
+    return ByteUtils::toHexString(hash);
+}
+
+void LogManager::startWatching()
+{
+    stopWatching();
+
+    const auto descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (descriptor < 0)
+    {
+        LOG(WARN) << "Failed to watch the log directory, it will be checked periodically";
+        return;
+    }
+
+    if (inotify_add_watch(descriptor, m_logDirectory.c_str(),
+                          IN_CREATE | IN_MODIFY | IN_CLOSE_WRITE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO) < 0)
+    {
+        LOG(WARN) << "Failed to watch the log directory '" << m_logDirectory << "', it will be checked periodically";
+        close(descriptor);
+        return;
+    }
+
+    const auto stopDescriptor = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (stopDescriptor < 0)
+    {
+        LOG(WARN) << "Failed to watch the log directory, it will be checked periodically";
+        close(descriptor);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock{m_logFilesMutex};
+        m_inotifyDescriptor = descriptor;
+        m_reindex = true;
+    }
+
+    m_watchStopDescriptor = stopDescriptor;
+    m_watcher.reset(new std::thread(&LogManager::watchLogDirectory, this));
+}
+
+void LogManager::stopWatching()
+{
+    if (m_watcher)
+    {
+        const auto stop = std::uint64_t{1};
+        if (write(m_watchStopDescriptor, &stop, sizeof(stop)) < 0)
+            LOG(ERROR) << "Failed to stop watching the log directory";
+        m_watcher->join();
+        m_watcher.reset();
+
+        close(m_watchStopDescriptor);
+        m_watchStopDescriptor = -1;
+    }
+
+    std::lock_guard<std::mutex> lock{m_logFilesMutex};
+    if (m_inotifyDescriptor >= 0)
+    {
+        close(m_inotifyDescriptor);
+        m_inotifyDescriptor = -1;
+    }
+}
+
+void LogManager::watchLogDirectory()
+{
+    // The descriptors are opened before the watcher is started, and closed only once it is joined
+    pollfd descriptors[] = {{m_inotifyDescriptor, POLLIN, 0}, {m_watchStopDescriptor, POLLIN, 0}};
+    auto& stopDescriptor = descriptors[1];
+
+    while (true)
+    {
+        if (poll(descriptors, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            LOG(ERROR) << "Failed to wait for the log directory events, the directory is no longer watched";
+            return;
+        }
+
+        if (stopDescriptor.revents != 0)
+            return;
+
+        // Every write into a log makes an event, so the events are let to pile up for a moment and handled together
+        if (poll(&stopDescriptor, 1, static_cast<int>(WATCH_COALESCE_PERIOD.count())) > 0)
+            return;
+
+        const auto events = readLogDirectoryEvents();
+        if (events != 0)
+            checkLogOverflowAfter(events);
+    }
+}
+
+std::uint32_t LogManager::readLogDirectoryEvents()
+{
+    alignas(inotify_event) char buffer[EVENT_BUFFER_SIZE];
+
+    std::lock_guard<std::mutex> lock{m_logFilesMutex};
+
+    auto events = std::uint32_t{0};
+    auto length = ssize_t{0};
+    while ((length = read(m_inotifyDescriptor, buffer, sizeof(buffer))) > 0)
+    {
+        for (auto position = std::size_t{0}; position < static_cast<std::size_t>(length);)
+        {
+            const auto& event = *reinterpret_cast<const inotify_event*>(buffer + position);
+            position += sizeof(inotify_event) + event.len;
+            events |= event.mask;
+
+            // Events were lost, so the whole directory has to be indexed again
+            if (event.mask & IN_Q_OVERFLOW)
+            {
+                m_reindex = true;
+                continue;
+            }
+
+            if (event.len == 0 || !isLogFile(event.name))
+                continue;
+
+            if (event.mask & (IN_DELETE | IN_MOVED_FROM))
+                m_logFiles.erase(event.name);
+            else
+                m_logFiles[event.name].stale = true;
+        }
+    }
+
+    return events;
+}
+
+void LogManager::checkLogOverflowAfter(std::uint32_t events)
+{
+    if (m_maxSize <= 0)
+        return;
+
+    // Only a new log can change the outcome of a check that failed, as the writes into the logs only make them bigger
+    if (m_overflowUnfixed && !(events & (IN_CREATE | IN_MOVED_TO | IN_Q_OVERFLOW)))
+        return;
+
+    const auto maxSize = static_cast<std::uint64_t>(m_maxSize);
+    if (getTotalLogSize() <= maxSize)
+    {
+        m_overflowUnfixed = false;
+        return;
+    }
+
+    checkLogOverflow();
+    m_overflowUnfixed = getTotalLogSize() > maxSize;
+    if (m_overflowUnfixed)
+        LOG(WARN) << "Log overflow is not checked again until a new log is created";
+}
+
 const std::chrono::hours& LogManager::getUploadAfter() const
 {
     return m_uploadAfter;
@@ -295,17 +761,57 @@ void LogManager::uploadLogs()
 
     LOG(INFO) << "Start uploading log files";
 
-    std::vector<std::string> logs = getLogsToUpload();
+    std::lock_guard<std::mutex> lock{m_uploadMutex};
+    auto logs = getLogsToUpload();
+
+    // The newest logs are the most likely to be looked at, so they are uploaded first
+    std::sort(logs.begin(), logs.end(),
+              [](const std::pair<std::string, LogFile>& lhs, const std::pair<std::string, LogFile>& rhs) {
+                  return lhs.second.lastModified > rhs.second.lastModified;
+              });
+
+    m_logUploader->setBandwidthLimit(m_uploadBandwidth);
 
-    for (auto& log : logs)
+    auto manifestChanged = false;
+    auto interruptions = 0u;
+    for (auto it = logs.begin(); it != logs.end();)
     {
-        LOG(INFO) << "Uploading '" << log << "'";
-        if (!m_logUploader->upload(FileSystemUtils::composePath(log, m_logDirectory)))
+        if (!waitWhileUploadPaused())
+            break;
+
+        // A pause that keeps coming back would otherwise interrupt the same log forever, so after a few interruptions
+        // the log is uploaded regardless
+        const auto interruptible = interruptions < MAX_UPLOAD_INTERRUPTIONS;
+        const auto started = std::chrono::steady_clock::now();
+        LOG(INFO) << "Uploading '" << it->first << "'";
+        if (!m_logUploader->upload(FileSystemUtils::composePath(it->first, m_logDirectory),
+                                   [this, interruptible] { return interruptible && isUploadPaused(); }))
         {
-            LOG(WARN) << "Failed to upload '" << log << "'";
+            // An interrupted upload is attempted again once the pause is over
+            if (interruptible && isUploadPaused())
+            {
+                LOG(INFO) << "Upload of '" << it->first << "' paused";
+                if (!waitBeforeUploadRetry(++interruptions))
+                    break;
+                continue;
+            }
+
+            LOG(WARN) << "Failed to upload '" << it->first << "'";
+            interruptions = 0;
+            ++it;
+            continue;
         }
+
+        markUploaded(it->first, it->second);
+        manifestChanged = true;
+        waitForUploadBandwidth(it->second.size, started);
+        interruptions = 0;
+        ++it;
     }
 
+    if (manifestChanged)
+        saveUploadManifest();
+
     LOG(INFO) << "Ended uploading log files";
 }
 
@@ -342,55 +848,123 @@ void LogManager::checkLogOverflow()
 
     LOG(INFO) << "Checking for log overflow";
 
-    int retryCounter = 0;
-    double logSize = getTotalLogSize();
+    auto logFiles = getLogFiles();
+    auto logSize = std::uint64_t{0};
+    for (const auto& logFile : logFiles)
+        logSize += logFile.second.size;
+
+    const auto maxSize = static_cast<std::uint64_t>(m_maxSize);
+    if (logSize <= maxSize)
+        return;
 
-    while (logSize > m_maxSize)
+    LOG(WARN) << "Log overflow detected, deleting the oldest logs";
+
+    // Delete the oldest logs in a single pass, until the logs fit
+    std::sort(logFiles.begin(), logFiles.end(),
+              [](const std::pair<std::string, LogFile>& left, const std::pair<std::string, LogFile>& right) {
+                  return left.second.lastModified < right.second.lastModified;
+              });
+
+    int retryCounter = 0;
+    for (const auto& logFile : logFiles)
     {
-        if (retryCounter >= 3)
-        {
-            LOG(ERROR) << "Failed to correct log overflow, aborting.";
+        if (logSize <= maxSize)
             break;
-        }
-        LOG(WARN) << "Log overflow detected, attempting to delete oldest log";
-        std::vector<std::string> logs = getLogFileNames();
-        std::vector<std::pair<std::string, double>> logsWithAge(logs.size());
 
-        for (auto& log : logs)
+        LOG(INFO) << "Deleting oldest log file: " << logFile.first;
+        if (!wolkabout::FileSystemUtils::deleteFile(FileSystemUtils::composePath(logFile.first, m_logDirectory)))
         {
-            logsWithAge.emplace_back(std::make_pair(
-              log, std::difftime(
-                     std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()),
-                     wolkabout::FileSystemUtils::getLastModified(FileSystemUtils::composePath(log, m_logDirectory)))));
+            LOG(ERROR) << "Failed to delete log file: " << logFile.first;
+            if (++retryCounter >= 3)
+            {
+                LOG(ERROR) << "Failed to correct log overflow, aborting.";
+                break;
+            }
+            continue;
         }
 
-        std::sort(logsWithAge.begin(), logsWithAge.end(),
-                  [](const std::pair<std::string, int>& left, const std::pair<std::string, int>& right) {
-                      return left.second > right.second;
-                  });
+        logSize -= logFile.second.size;
+
+        std::lock_guard<std::mutex> lock{m_logFilesMutex};
+        m_logFiles.erase(logFile.first);
+    }
+}
+
+void LogManager::compressLogs()
+{
+    const auto logFiles = getLogFiles();
+    if (logFiles.empty())
+        return;
 
-        const std::string oldLog = logsWithAge.begin()->first;
+    const auto activeLog =
+      std::max_element(logFiles.begin(), logFiles.end(),
+                       [](const std::pair<std::string, LogFile>& left, const std::pair<std::string, LogFile>& right) {
+                           return left.second.lastModified < right.second.lastModified;
+                       });
 
-        LOG(INFO) << "Deleting oldest log file: " << oldLog;
+    // Every logger writes into a file of its own, so besides the newest log, the logs this process has open and the
+    // logs written into lately are left alone, as another process could still be writing into them
+    const auto openFiles = getOpenFiles();
+    const auto quietSince =
+      std::chrono::system_clock::to_time_t(std::chrono::system_clock::now() - COMPRESS_QUIET_PERIOD);
 
-        if (!wolkabout::FileSystemUtils::deleteFile(FileSystemUtils::composePath(oldLog, m_logDirectory)))
+    for (auto it = logFiles.begin(); it != logFiles.end(); ++it)
+    {
+        if (it == activeLog || isCompressed(it->first) || it->second.lastModified > quietSince)
+            continue;
+
+        const auto path = FileSystemUtils::composePath(it->first, m_logDirectory);
+        const auto compressedPath = path + COMPRESSED_EXTENSION;
+        char resolvedPath[PATH_MAX];
+        if (realpath(path.c_str(), resolvedPath) != nullptr && openFiles.count(resolvedPath) != 0)
+            continue;
+
+        LOG(DEBUG) << "Compressing '" << it->first << "'";
+        if (!FileSystemUtils::compressFile(path, compressedPath))
         {
-            LOG(ERROR) << "Failed to delete log file: " << oldLog;
-            retryCounter++;
+            LOG(WARN) << "Failed to compress log '" << it->first << "'";
+            continue;
         }
-        logSize = getTotalLogSize();
+
+        // Keep the modification time, so the age of the log does not change
+        struct utimbuf times
+        {
+            it->second.lastModified, it->second.lastModified
+        };
+        utime(compressedPath.c_str(), &times);
+        FileSystemUtils::deleteFile(path);
+
+        std::lock_guard<std::mutex> lock{m_logFilesMutex};
+        m_logFiles.erase(it->first);
+        m_logFiles[it->first + COMPRESSED_EXTENSION] = LogFile{0, 0, true};
     }
 }
 
-double LogManager::getTotalLogSize()
+std::unordered_set<std::string> LogManager::getOpenFiles()
 {
-    std::vector<std::string> logs = getLogFileNames();
-    double logSize = 0;
+    auto openFiles = std::unordered_set<std::string>{};
+    const auto descriptors = opendir("/proc/self/fd");
+    if (descriptors == nullptr)
+        return openFiles;
 
-    for (auto& log : logs)
+    for (auto entry = readdir(descriptors); entry != nullptr; entry = readdir(descriptors))
     {
-        logSize += wolkabout::FileSystemUtils::getFileSize(FileSystemUtils::composePath(log, m_logDirectory));
+        const auto link = std::string{"/proc/self/fd/"} + entry->d_name;
+        char target[PATH_MAX];
+        const auto length = readlink(link.c_str(), target, sizeof(target) - 1);
+        if (length > 0)
+            openFiles.emplace(target, static_cast<std::size_t>(length));
     }
+
+    closedir(descriptors);
+    return openFiles;
+}
+
+std::uint64_t LogManager::getTotalLogSize()
+{
+    std::uint64_t logSize = 0;
+    for (const auto& logFile : getLogFiles())
+        logSize += logFile.second.size;
     return logSize;
 }
 }    // namespace wolkabout
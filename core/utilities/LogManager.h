@@ -10,8 +10,18 @@
 
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace wolkabout
@@ -33,10 +43,22 @@ public:
     void stop();
     void restart();
 
+    /**
+     * This method uploads the logs that were not uploaded yet, starting with the newest ones. The uploads wait while
+     * they are paused, and keep to the bandwidth limit if one is set.
+     */
     void uploadLogs();
     void deleteOldLogs();
     void checkLogOverflow();
 
+    /**
+     * This method compresses the rotated log files into the gzip format. The log files that could still be written to
+     * are left as is: the most recently modified one, the ones this process has open, and the ones modified in the
+     * last few minutes. The compressed files are uploaded and count towards the maximum size instead of the original
+     * ones.
+     */
+    void compressLogs();
+
     const std::string& getLogDirectory() const;
     void setLogDirectory(const std::string& logDirectory);
     int getMaxSize() const;
@@ -60,18 +82,149 @@ public:
     const std::string& getLogExtension() const;
     void setLogExtension(const std::string& logExtension);
     void setLogUploader(const std::shared_ptr<wolkabout::LogUploader>& logUploader);
+    bool getCompressLogs() const;
+    void setCompressLogs(bool compressLogs);
+
+    /**
+     * Default getter for the upload bandwidth limit.
+     *
+     * @return The maximum upload rate in bytes per second, 0 if there is no limit.
+     */
+    std::uint64_t getUploadBandwidth() const;
+
+    /**
+     * This method limits the rate the logs are uploaded at, leaving the rest of the link to the other traffic. The
+     * limit is passed to the log uploader, and the log manager also waits between the uploads to keep to it.
+     *
+     * @param bytesPerSecond The maximum upload rate in bytes per second, 0 for no limit.
+     */
+    void setUploadBandwidth(std::uint64_t bytesPerSecond);
+
+    /**
+     * This method sets the check that pauses the uploads, for example while the connectivity service has messages
+     * waiting to be published. An upload in progress is interrupted, and continued once the pause is over. Every
+     * interruption of the same log doubles the wait before it is attempted again, and once the log was interrupted a
+     * few times in a row, it is uploaded without being interrupted, so a pause that keeps coming back can not hold it
+     * back forever.
+     *
+     * @param uploadPaused Returns true while the uploads should be paused, or nullptr to never pause.
+     */
+    void setUploadPaused(std::function<bool()> uploadPaused);
 
 private:
-    std::vector<std::string> getLogsToUpload();
+    struct LogFile
+    {
+        std::uint64_t size;
+        std::time_t lastModified;
+        bool stale;
+    };
+
+    struct UploadedLog
+    {
+        std::uint64_t size;
+        std::time_t lastModified;
+        std::string hash;
+    };
+
+    /**
+     * This method returns the logs old enough to be uploaded that were not uploaded yet. The logs are checked against
+     * the upload manifest first, and the remote logs are listed only for the logs the manifest does not know about. A
+     * remote log counts as the upload of a log only if it has the same name, under the key prefix of the uploader,
+     * and the same size.
+     *
+     * @return The log files to upload, with their size and the time they were last modified at.
+     */
+    std::vector<std::pair<std::string, LogFile>> getLogsToUpload();
     std::vector<std::string> getLogsToDelete();
     std::vector<std::string> getLogFileNames();
-    double getTotalLogSize();
+    std::uint64_t getTotalLogSize();
+
+    /**
+     * This method returns the files this process has open, for example the log files its loggers are writing into.
+     *
+     * @return The resolved paths of the open files.
+     */
+    static std::unordered_set<std::string> getOpenFiles();
+
+    /**
+     * This method returns the log files from the index, refreshing the files that have changed since the last call.
+     * Without a directory watch, the whole directory is indexed again.
+     *
+     * @return The log files, with their size and the time they were last modified at.
+     */
+    std::vector<std::pair<std::string, LogFile>> getLogFiles();
+
+    void startWatching();
+    void stopWatching();
+
+    /**
+     * This method is run by the watcher thread. It blocks until there are events in the log directory, and updates
+     * the index and checks the overflow with them, until the watch is stopped.
+     */
+    void watchLogDirectory();
+
+    /**
+     * This method reads the pending events of the log directory, and updates the index with them.
+     *
+     * @return The events that were read, or zero if there were none.
+     */
+    std::uint32_t readLogDirectoryEvents();
+
+    /**
+     * This method checks the overflow after the watcher read events from the log directory. Once a check could not
+     * bring the logs under the limit, the writes into the logs, the manager's own logs among them, are not checked
+     * again until a log is created or moved into the directory.
+     *
+     * @param events The events read from the log directory.
+     */
+    void checkLogOverflowAfter(std::uint32_t events);
+    void indexLogFiles();
+    bool isLogFile(const std::string& fileName) const;
+    static bool isCompressed(const std::string& fileName);
+
+    void loadUploadManifest();
+    void saveUploadManifest();
+    bool isUploaded(const std::string& name, const LogFile& logFile);
+    void markUploaded(const std::string& name, const LogFile& logFile);
+    std::string hashLog(const std::string& name) const;
+
+    bool isUploadPaused();
+    bool waitWhileUploadPaused();
+
+    /**
+     * This method waits before an interrupted upload is attempted again, longer for every interruption in a row.
+     *
+     * @param interruptions The number of times in a row the upload was interrupted.
+     * @return Whether the upload should be attempted again, false if the uploads were stopped in the meantime.
+     */
+    bool waitBeforeUploadRetry(unsigned interruptions);
+    void waitForUploadBandwidth(std::uint64_t size, std::chrono::steady_clock::time_point started);
 
     std::string m_logDirectory;
     std::string m_logExtension;
     int m_maxSize;
+    bool m_compressLogs;
+
+    std::mutex m_logFilesMutex;
+    std::map<std::string, LogFile> m_logFiles;
+    bool m_reindex;
+    int m_inotifyDescriptor;
+    int m_watchStopDescriptor;
+    std::unique_ptr<std::thread> m_watcher;
+    bool m_overflowUnfixed;
+
+    std::mutex m_uploadMutex;
+    std::unordered_map<std::string, UploadedLog> m_uploadManifest;
+    std::string m_uploadManifestDirectory;
+
+    std::atomic<std::uint64_t> m_uploadBandwidth;
+    std::mutex m_uploadWaitMutex;
+    std::condition_variable m_uploadWaitCondition;
+    std::function<bool()> m_uploadPaused;
+    bool m_uploadStopped;
 
     wolkabout::Timer m_overflowTimer;
+    wolkabout::Timer m_compressTimer;
     wolkabout::Timer m_deleteTimer;
     wolkabout::Timer m_uploadTimer;
     std::atomic_bool m_running;
@@ -4,6 +4,9 @@
 #ifndef WOLKABOUTCORE_LOGUPLOADER_H
 #define WOLKABOUTCORE_LOGUPLOADER_H
 
+#include <cstdint>
+#include <functional>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -24,11 +27,52 @@ public:
      */
     virtual bool upload(const std::string& pathToLogFile) = 0;
 
+    /**
+     * @brief Attempt to upload a log file to a remote server, giving up early once asked to. The uploaders that can
+     * resume an interrupted upload should override this, the default uploads the whole file at once.
+     * @param pathToLogFile Path where the log file is located on the file system
+     * @param interrupted Returns true once the upload should stop and be continued later
+     * @return Success of the operation, false if the upload was interrupted
+     */
+    virtual bool upload(const std::string& pathToLogFile, const std::function<bool()>& interrupted)
+    {
+        return !interrupted() && upload(pathToLogFile);
+    }
+
+    /**
+     * @brief Limit the rate the files are uploaded at. The uploaders that can not limit it ignore this.
+     * @param bytesPerSecond The maximum upload rate, 0 for no limit
+     */
+    virtual void setBandwidthLimit(std::uint64_t /* bytesPerSecond */) {}
+
     /**
      * @brief Get all the name of log files that are present on the remote server
      * @return Vector of file names as string
      */
     virtual std::vector<std::string> getRemoteLogs() = 0;
+
+    /**
+     * @brief Get the sizes of the log files that are present on the remote server and start with a prefix. The
+     * uploaders that can not tell the sizes of the remote files return none, and the logs are uploaded again.
+     * @param prefix The prefix of the remote file names
+     * @return The sizes of the remote files, by their names
+     */
+    virtual std::map<std::string, std::uint64_t> getRemoteLogSizes(const std::string& /* prefix */) { return {}; }
+
+    /**
+     * @brief Set the prefix of the names the files are given on the remote server. The devices that share a remote
+     * server have the same log directory and log names, so every device should use a prefix of its own, like its
+     * device key. The uploaders that can not name the remote files ignore this.
+     * @param keyPrefix The prefix, empty for none
+     */
+    virtual void setKeyPrefix(const std::string& /* keyPrefix */) {}
+
+    /**
+     * @brief Get the name a file is given on the remote server.
+     * @param pathToLogFile Path where the log file is located on the file system
+     * @return The name of the remote file
+     */
+    virtual std::string getRemoteName(const std::string& pathToLogFile) const { return pathToLogFile; }
 };
 }    // namespace wolkabout
 
@@ -16,23 +16,177 @@
 
 #include "core/utilities/Logger.h"
 
+#include "core/utilities/LogBuffer.h"
+#include "core/utilities/LogLimiter.h"
+#include "core/utilities/Timer.h"
+
 #include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <exception>
 #include <iostream>
+#include <spdlog/async.h>
 #include <spdlog/common.h>
 #include <spdlog/details/file_helper.h>
+#include <spdlog/sinks/base_sink.h>
 #include <spdlog/sinks/daily_file_sink.h>
-#include <spdlog/sinks/ringbuffer_sink.h>
 #include <spdlog/sinks/stdout_sinks.h>
 #include <spdlog/spdlog.h>
+#include <unistd.h>
 
 namespace
 {
-const unsigned BURRER_LOG_SIZE = 2500;
+bool initialized = false;
+
+// The actions the crash handler took over, by the signal, and the terminate handler it took over
+struct sigaction previousCrashActions[NSIG];
+std::terminate_handler previousTerminateHandler = nullptr;
+
+template <typename T> T readArgument(const char* arguments, std::size_t& position)
+{
+    T value;
+    std::memcpy(&value, arguments + position, sizeof(T));
+    position += sizeof(T);
+    return value;
+}
+
+// The writers below are async-signal-safe, they only format into the stack and call write(2)
+void writeAll(int descriptor, const char* data, std::size_t size)
+{
+    while (size > 0)
+    {
+        const auto written = ::write(descriptor, data, size);
+        if (written <= 0)
+        {
+            return;
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+}
+
+void writeUnsigned(int descriptor, std::uint64_t value, std::size_t minimumDigits = 1)
+{
+    char digits[20];
+    auto count = std::size_t{0};
+    do
+    {
+        digits[sizeof(digits) - ++count] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0 || count < minimumDigits);
+    writeAll(descriptor, digits + sizeof(digits) - count, count);
+}
+
+void writeSigned(int descriptor, std::int64_t value)
+{
+    if (value < 0)
+    {
+        writeAll(descriptor, "-", 1);
+    }
+    writeUnsigned(descriptor, value < 0 ? 0 - static_cast<std::uint64_t>(value) : static_cast<std::uint64_t>(value));
+}
+
+void writeFloating(int descriptor, double value)
+{
+    const std::uint64_t DECIMALS = 1000000;
+
+    if (std::isnan(value))
+    {
+        writeAll(descriptor, "nan", 3);
+        return;
+    }
+    if (std::signbit(value))
+    {
+        writeAll(descriptor, "-", 1);
+        value = -value;
+    }
+    if (std::isinf(value))
+    {
+        writeAll(descriptor, "inf", 3);
+        return;
+    }
+
+    // The values that do not fit the integer part are written in the scientific notation
+    auto exponent = 0;
+    while (value >= 1e18)
+    {
+        value /= 10;
+        ++exponent;
+    }
+
+    auto integer = static_cast<std::uint64_t>(value);
+    auto fraction = static_cast<std::uint64_t>((value - static_cast<double>(integer)) * DECIMALS + 0.5);
+    if (fraction >= DECIMALS)
+    {
+        ++integer;
+        fraction -= DECIMALS;
+    }
+
+    writeUnsigned(descriptor, integer);
+    if (fraction != 0)
+    {
+        auto digits = std::size_t{6};
+        while (fraction % 10 == 0)
+        {
+            fraction /= 10;
+            --digits;
+        }
+        writeAll(descriptor, ".", 1);
+        writeUnsigned(descriptor, fraction, digits);
+    }
+    if (exponent != 0)
+    {
+        writeAll(descriptor, "e+", 2);
+        writeUnsigned(descriptor, static_cast<std::uint64_t>(exponent));
+    }
 }
+}    // namespace
 
 namespace wolkabout
 {
 std::unique_ptr<Logger> Logger::m_instance;
+std::atomic<LogLevel> Logger::m_level{LogLevel::TRACE};
+const std::size_t Logger::ASYNC_QUEUE_SIZE;
+constexpr std::chrono::seconds Logger::ASYNC_FLUSH_TIMEOUT;
+constexpr std::chrono::seconds Logger::LIMITER_SUMMARY_INTERVAL;
+
+/**
+ * This sink writes nothing, it only gets the markers `Logger::flush` queues behind the flushes of the outputs. The
+ * writer thread goes through the queue in order, so once a marker arrives, everything queued before it is written out.
+ */
+class LogFlushSink : public spdlog::sinks::base_sink<std::mutex>
+{
+public:
+    void flush(spdlog::logger& markerLogger, std::chrono::milliseconds timeout)
+    {
+        auto marker = std::uint64_t{0};
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            marker = ++m_queued;
+        }
+        markerLogger.log(spdlog::level::critical, "");
+
+        // The markers queued after this one can only arrive after it, so counting them is enough
+        std::unique_lock<std::mutex> lock{mutex_};
+        m_arrived.wait_for(lock, timeout, [&] { return m_arrivals >= marker; });
+    }
+
+protected:
+    void sink_it_(const spdlog::details::log_msg& /* message */) override
+    {
+        ++m_arrivals;
+        m_arrived.notify_all();
+    }
+
+    void flush_() override {}
+
+private:
+    std::uint64_t m_queued = 0;
+    std::uint64_t m_arrivals = 0;
+    std::condition_variable m_arrived;
+};
 
 struct custom_filename_calculator
 {
@@ -48,6 +202,15 @@ struct custom_filename_calculator
     }
 };
 
+Logger::Logger() : m_limiterTimer{new Timer} {}
+
+Logger::~Logger()
+{
+    // The logs held back by the limits are summarized while the outputs are still there
+    m_limiterTimer->stop();
+    writeLimiterSummaries(true);
+}
+
 void Logger::set(std::unique_ptr<Logger> logger)
 {
     m_instance = std::move(logger);
@@ -62,13 +225,12 @@ Logger& Logger::getInstance()
 
 void Logger::init(LogLevel level, Type type, const std::string& filePathWithExtension)
 {
-    static bool runOnce = false;
-    if (runOnce)
+    if (initialized)
     {
         return;
     }
 
-    runOnce = true;
+    initialized = true;
 
     if (type & Type::CONSOLE)
     {
@@ -88,6 +250,79 @@ void Logger::init(LogLevel level, Type type, const std::string& filePathWithExte
     setupLoggerParams(level);
 }
 
+void Logger::initAsync(LogLevel level, Type type, const std::string& filePathWithExtension, std::size_t queueSize,
+                       OverflowPolicy policy)
+{
+    if (initialized)
+    {
+        return;
+    }
+
+    getInstance().enableAsync(queueSize, policy);
+    init(level, type, filePathWithExtension);
+}
+
+void Logger::installCrashHandler()
+{
+    struct sigaction action = {};
+    action.sa_sigaction = &Logger::onCrash;
+    action.sa_flags = SA_SIGINFO;
+    sigemptyset(&action.sa_mask);
+    for (const auto signal : {SIGSEGV, SIGABRT, SIGFPE, SIGILL, SIGBUS})
+    {
+        // Installing the handler again must not take the handler over from itself
+        struct sigaction current = {};
+        if (sigaction(signal, nullptr, &current) == 0 && (current.sa_flags & SA_SIGINFO) &&
+            current.sa_sigaction == &Logger::onCrash)
+        {
+            continue;
+        }
+
+        sigaction(signal, &action, &previousCrashActions[signal]);
+    }
+
+    const auto previous = std::set_terminate(&Logger::onTerminate);
+    if (previous != &Logger::onTerminate)
+    {
+        previousTerminateHandler = previous;
+    }
+}
+
+void Logger::setLevel(LogLevel level)
+{
+    m_level.store(level, std::memory_order_relaxed);
+
+    // The outputs filter the logs on their own too, so they have to follow the level
+    switch (level)
+    {
+    case LogLevel::TRACE:
+    {
+        spdlog::set_level(spdlog::level::trace);
+        break;
+    }
+    case LogLevel::DEBUG:
+    {
+        spdlog::set_level(spdlog::level::debug);
+        break;
+    }
+    case LogLevel::INFO:
+    {
+        spdlog::set_level(spdlog::level::info);
+        break;
+    }
+    case LogLevel::ERROR:
+    default:
+    {
+        spdlog::set_level(spdlog::level::err);
+    }
+    }
+}
+
+LogLevel Logger::getLevel()
+{
+    return m_level.load(std::memory_order_relaxed);
+}
+
 void Logger::operator+=(const Log& log)
 {
     logEntry(log);
@@ -95,51 +330,215 @@ void Logger::operator+=(const Log& log)
 
 void Logger::logEntry(const Log& log)
 {
-    if (m_fileLogger)
+    auto limiter = std::shared_ptr<LogLimiter>{};
     {
-        logMessage(log, *m_fileLogger);
+        std::lock_guard<std::mutex> lock{m_limiterMutex};
+        limiter = m_limiter;
     }
 
-    if (m_consoleLogger)
+    if (!limiter)
+    {
+        return write(log);
+    }
+
+    for (const auto& entry : limiter->filter(log, std::chrono::steady_clock::now()))
     {
-        logMessage(log, *m_consoleLogger);
+        write(entry);
     }
+}
+
+void Logger::setRateLimit(LogLevel level, std::size_t logs, std::chrono::milliseconds period)
+{
+    limiter().setRateLimit(level, logs, period);
+}
+
+void Logger::setCollapseRepeated(LogLevel level, bool collapse)
+{
+    limiter().setCollapseRepeated(level, collapse);
+}
+
+LogLimiter& Logger::limiter()
+{
+    std::lock_guard<std::mutex> lock{m_limiterMutex};
+    if (!m_limiter)
+    {
+        m_limiter = std::make_shared<LogLimiter>();
 
-    if (m_bufferLogger)
+        // The summaries are otherwise only written once the call sites log again, which never happens after a storm
+        m_limiterTimer->run(LIMITER_SUMMARY_INTERVAL, [this] { writeLimiterSummaries(false); });
+    }
+
+    return *m_limiter;
+}
+
+void Logger::writeLimiterSummaries(bool all)
+{
+    auto limiter = std::shared_ptr<LogLimiter>{};
+    {
+        std::lock_guard<std::mutex> lock{m_limiterMutex};
+        limiter = m_limiter;
+    }
+
+    if (!limiter)
+    {
+        return;
+    }
+
+    for (const auto& summary : limiter->takeSummaries(std::chrono::steady_clock::now(), all))
+    {
+        write(summary);
+    }
+}
+
+void Logger::write(const Log& log)
+{
+    if (m_buffer && log.getLogLevel() != LogLevel::OFF)
+    {
+        m_buffer->push(log);
+    }
+
+    if (!m_fileLogger && !m_consoleLogger)
+    {
+        return;
+    }
+
+    const auto message = log.getMessage();
+    if (m_fileLogger)
+    {
+        logMessage(log.getLogLevel(), message, *m_fileLogger);
+    }
+
+    if (m_consoleLogger)
     {
-        logMessage(log, *m_bufferLogger);
+        logMessage(log.getLogLevel(), message, *m_consoleLogger);
     }
 }
 
 std::vector<std::string> Logger::buffer()
 {
-    if (!m_bufferSink)
+    if (!m_buffer)
     {
         return {};
     }
 
-    return m_bufferSink->last_formatted();
+    return m_buffer->format();
 }
 
-void Logger::logMessage(const Log& log, spdlog::logger& logger)
+void Logger::flush()
 {
-    switch (log.getLogLevel())
+    writeLimiterSummaries(true);
+
+    for (const auto& logger : {m_fileLogger, m_consoleLogger})
+    {
+        if (logger)
+        {
+            logger->flush();
+        }
+    }
+
+    if (m_flushLogger)
+    {
+        m_flushSink->flush(*m_flushLogger, ASYNC_FLUSH_TIMEOUT);
+    }
+}
+
+std::size_t Logger::droppedLogs() const
+{
+    if (!m_threadPool)
+    {
+        return 0;
+    }
+
+    return m_threadPool->overrun_counter();
+}
+
+void Logger::enableAsync(std::size_t queueSize, OverflowPolicy policy)
+{
+    m_threadPool = std::make_shared<spdlog::details::thread_pool>(queueSize, 1);
+    m_flushSink = std::make_shared<LogFlushSink>();
+    m_flushLogger = std::make_shared<spdlog::async_logger>("WolkSDK_flushLogger", m_flushSink, m_threadPool,
+                                                           spdlog::async_overflow_policy::block);
+    m_overflowPolicy = policy;
+}
+
+std::shared_ptr<spdlog::logger> Logger::createLogger(const std::string& name, std::shared_ptr<spdlog::sinks::sink> sink)
+{
+    auto logger = std::shared_ptr<spdlog::logger>{};
+    if (m_threadPool)
+    {
+        const auto policy = m_overflowPolicy == OverflowPolicy::DROP ? spdlog::async_overflow_policy::overrun_oldest :
+                                                                       spdlog::async_overflow_policy::block;
+        logger = std::make_shared<spdlog::async_logger>(name, std::move(sink), m_threadPool, policy);
+    }
+    else
+    {
+        logger = std::make_shared<spdlog::logger>(name, std::move(sink));
+    }
+
+    spdlog::initialize_logger(logger);
+    return logger;
+}
+
+void Logger::onCrash(int signal, siginfo_t* info, void* context)
+{
+    // Flushing the outputs or formatting the logs could deadlock on a lock held by the crashed thread
+    if (m_instance && m_instance->m_buffer)
+    {
+        m_instance->m_buffer->dump(STDERR_FILENO);
+    }
+
+    // The previous action is put back, so the signal ends up there even if the previous handler returns. A previous
+    // handler is called right away, to get the information about the original signal.
+    const auto& previous = previousCrashActions[signal];
+    sigaction(signal, &previous, nullptr);
+    if ((previous.sa_flags & SA_SIGINFO) && previous.sa_sigaction != nullptr)
+    {
+        previous.sa_sigaction(signal, info, context);
+    }
+    else if (!(previous.sa_flags & SA_SIGINFO) && previous.sa_handler != SIG_DFL && previous.sa_handler != SIG_IGN)
+    {
+        previous.sa_handler(signal);
+    }
+    else
+    {
+        std::raise(signal);
+    }
+}
+
+void Logger::onTerminate()
+{
+    // Unlike in a signal handler, the writer thread can still be waited on, so the queued logs are written out
+    if (m_instance)
+    {
+        m_instance->flush();
+    }
+
+    if (previousTerminateHandler)
+    {
+        previousTerminateHandler();
+    }
+    std::abort();
+}
+
+void Logger::logMessage(LogLevel level, const std::string& message, spdlog::logger& logger)
+{
+    switch (level)
     {
     case LogLevel::ERROR:
     {
-        return logger.error(log.getMessage());
+        return logger.error(message);
     }
     case LogLevel::INFO:
     {
-        return logger.info(log.getMessage());
+        return logger.info(message);
     }
     case LogLevel::DEBUG:
     {
-        return logger.debug(log.getMessage());
+        return logger.debug(message);
     }
     case LogLevel::TRACE:
     {
-        return logger.trace(log.getMessage());
+        return logger.trace(message);
     }
     }
 }
@@ -150,18 +549,15 @@ void Logger::setupFileLogger(const std::string& filePathWithExtension)
 
     try
     {
-        instance.m_fileLogger = spdlog::synchronous_factory::template create<
-          spdlog::sinks::daily_file_sink<std::mutex, custom_filename_calculator>>("WolkSDK_fileLogger",
-                                                                                  filePathWithExtension, 0, 0);
+        auto sink = std::make_shared<spdlog::sinks::daily_file_sink<std::mutex, custom_filename_calculator>>(
+          filePathWithExtension, 0, 0);
+        instance.m_fileLogger = instance.createLogger("WolkSDK_fileLogger", std::move(sink));
     }
     catch (spdlog::spdlog_ex& e)
     {
         if (instance.m_consoleLogger)
         {
-            Log log(LogLevel::ERROR);
-            log << e.what();
-
-            instance.logMessage(log, *instance.m_consoleLogger);
+            instance.logMessage(LogLevel::ERROR, e.what(), *instance.m_consoleLogger);
         }
         else
         {
@@ -174,17 +570,16 @@ void Logger::setupConsoleLogger()
 {
     auto& instance = getInstance();
 
-    instance.m_consoleLogger = spdlog::stdout_logger_mt("WolkSDK_consoleLogger");
+    instance.m_consoleLogger =
+      instance.createLogger("WolkSDK_consoleLogger", std::make_shared<spdlog::sinks::stdout_sink_mt>());
 }
 
 void Logger::setupBufferLogger()
 {
     auto& instance = getInstance();
 
-    instance.m_bufferLogger = spdlog::synchronous_factory::template create<spdlog::sinks::ringbuffer_sink<std::mutex>>(
-      "bufferLogger", BURRER_LOG_SIZE);
-    instance.m_bufferSink =
-      dynamic_cast<spdlog::sinks::ringbuffer_sink<std::mutex>*>(instance.m_bufferLogger->sinks().at(0).get());
+    // The buffer is always written synchronously, so it contains every log made before `buffer` is called
+    instance.m_buffer = std::make_shared<LogBuffer>();
 }
 
 void Logger::setupLoggerParams(LogLevel level)
@@ -193,33 +588,10 @@ void Logger::setupLoggerParams(LogLevel level)
     spdlog::flush_on(spdlog::level::info);
 
     spdlog::set_pattern("[%D %H:%M:%S] [%L] %v");
-
-    switch (level)
-    {
-    case LogLevel::TRACE:
-    {
-        spdlog::set_level(spdlog::level::trace);
-        break;
-    }
-    case LogLevel::DEBUG:
-    {
-        spdlog::set_level(spdlog::level::debug);
-        break;
-    }
-    case LogLevel::INFO:
-    {
-        spdlog::set_level(spdlog::level::info);
-        break;
-    }
-    case LogLevel::ERROR:
-    default:
-    {
-        spdlog::set_level(spdlog::level::err);
-    }
-    }
+    setLevel(level);
 }
 
-Log::Log(LogLevel level) : m_level{level}, m_message{""} {}
+Log::Log(LogLevel level) : m_level{level}, m_file{nullptr}, m_line{0} {}
 
 LogLevel Log::getLogLevel() const
 {
@@ -228,17 +600,190 @@ LogLevel Log::getLogLevel() const
 
 std::string Log::getMessage() const
 {
-    return m_message.str();
+    return format(m_arguments.data(), m_arguments.size());
 }
 
-LOG::LOG(wolkabout::LogLevel level, bool doLog) : m_log(level), m_doLog(doLog) {}
+void Log::setSource(const char* file, int line)
+{
+    m_file = file;
+    m_line = line;
+}
 
-LOG::~LOG()
+const char* Log::getFile() const
 {
-    if (m_doLog)
+    return m_file;
+}
+
+int Log::getLine() const
+{
+    return m_line;
+}
+
+const std::string& Log::getArguments() const
+{
+    return m_arguments;
+}
+
+std::string Log::format(const char* arguments, std::size_t size)
+{
+    std::ostringstream stream;
+
+    auto position = std::size_t{0};
+    while (position < size)
     {
-        wolkabout::Logger::getInstance() += m_log;
+        switch (static_cast<Argument>(arguments[position++]))
+        {
+        case Argument::CHARACTER:
+        {
+            stream << readArgument<char>(arguments, position);
+            break;
+        }
+        case Argument::SIGNED:
+        {
+            stream << readArgument<std::int64_t>(arguments, position);
+            break;
+        }
+        case Argument::UNSIGNED:
+        {
+            stream << readArgument<std::uint64_t>(arguments, position);
+            break;
+        }
+        case Argument::FLOATING:
+        {
+            stream << readArgument<double>(arguments, position);
+            break;
+        }
+        case Argument::STRING:
+        {
+            const auto length = readArgument<std::uint32_t>(arguments, position);
+            stream.write(arguments + position, static_cast<std::streamsize>(length));
+            position += length;
+            break;
+        }
+        case Argument::MANIPULATOR:
+        {
+            stream << readArgument<std::ios_base& (*)(std::ios_base&)>(arguments, position);
+            break;
+        }
+        case Argument::BOOLEAN:
+        {
+            stream << readArgument<bool>(arguments, position);
+            break;
+        }
+        case Argument::WIDTH:
+        {
+            stream.width(static_cast<std::streamsize>(readArgument<std::int64_t>(arguments, position)));
+            break;
+        }
+        case Argument::PRECISION:
+        {
+            stream.precision(static_cast<std::streamsize>(readArgument<std::int64_t>(arguments, position)));
+            break;
+        }
+        case Argument::FILL:
+        {
+            stream.fill(readArgument<char>(arguments, position));
+            break;
+        }
+        default:
+        {
+            return stream.str();
+        }
+        }
     }
+
+    return stream.str();
+}
+
+void Log::write(int descriptor, const char* arguments, std::size_t size)
+{
+    auto position = std::size_t{0};
+    while (position < size)
+    {
+        switch (static_cast<Argument>(arguments[position++]))
+        {
+        case Argument::CHARACTER:
+        {
+            const auto character = readArgument<char>(arguments, position);
+            writeAll(descriptor, &character, 1);
+            break;
+        }
+        case Argument::SIGNED:
+        {
+            writeSigned(descriptor, readArgument<std::int64_t>(arguments, position));
+            break;
+        }
+        case Argument::UNSIGNED:
+        {
+            writeUnsigned(descriptor, readArgument<std::uint64_t>(arguments, position));
+            break;
+        }
+        case Argument::FLOATING:
+        {
+            writeFloating(descriptor, readArgument<double>(arguments, position));
+            break;
+        }
+        case Argument::STRING:
+        {
+            const auto length = readArgument<std::uint32_t>(arguments, position);
+            writeAll(descriptor, arguments + position, length);
+            position += length;
+            break;
+        }
+        case Argument::MANIPULATOR:
+        {
+            position += sizeof(std::ios_base & (*)(std::ios_base&));
+            break;
+        }
+        case Argument::BOOLEAN:
+        {
+            writeUnsigned(descriptor, readArgument<bool>(arguments, position) ? 1 : 0);
+            break;
+        }
+        case Argument::WIDTH:
+        case Argument::PRECISION:
+        {
+            position += sizeof(std::int64_t);
+            break;
+        }
+        case Argument::FILL:
+        {
+            position += sizeof(char);
+            break;
+        }
+        default:
+        {
+            return;
+        }
+        }
+    }
+}
+
+void Log::appendString(const char* data, std::size_t size)
+{
+    const auto length = static_cast<std::uint32_t>(size);
+    append(Argument::STRING, length);
+    m_arguments.append(data, length);
+}
+
+void Log::record(const char* value, ArgumentTag<Argument::STRING>)
+{
+    if (value == nullptr)
+    {
+        return appendString("", 0);
+    }
+
+    appendString(value, std::strlen(value));
+}
+
+void Log::record(const std::string& value, ArgumentTag<Argument::STRING>)
+{
+    appendString(value.data(), value.size());
+}
+
+void Log::record(std::ios_base& (*manipulator)(std::ios_base&), ArgumentTag<Argument::MANIPULATOR>)
+{
+    append(Argument::MANIPULATOR, manipulator);
 }
 
 wolkabout::LogLevel from_string(std::string level)
@@ -17,6 +17,13 @@
 #ifndef WOLKABOUTCORE_LOGGER_H
 #define WOLKABOUTCORE_LOGGER_H
 
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <ios>
 #include <memory>
 #include <mutex>
 #include <sstream>
@@ -27,15 +34,23 @@
 namespace spdlog
 {
 class logger;
+namespace details
+{
+class thread_pool;
+}
 namespace sinks
 {
-template <typename T> class ringbuffer_sink;
+class sink;
 }
 }    // namespace spdlog
 
 namespace wolkabout
 {
 class Log;
+class LogBuffer;
+class LogFlushSink;
+class LogLimiter;
+class Timer;
 
 enum class LogLevel
 {
@@ -65,7 +80,22 @@ public:
         BUFFER = 4
     };
 
-    virtual ~Logger() = default;
+    /**
+     * This enum describes what the asynchronous logger does with a new log when its queue is full.
+     */
+    enum class OverflowPolicy
+    {
+        BLOCK,
+        DROP
+    };
+
+    static const std::size_t ASYNC_QUEUE_SIZE = 8192;
+    static constexpr std::chrono::seconds ASYNC_FLUSH_TIMEOUT{5};
+    static constexpr std::chrono::seconds LIMITER_SUMMARY_INTERVAL{1};
+
+    Logger();
+
+    virtual ~Logger();
 
     static void set(std::unique_ptr<Logger> logger);
 
@@ -73,14 +103,103 @@ public:
 
     static void init(LogLevel level, Type type, const std::string& filePathWithExtension = "");
 
+    /**
+     * This method initializes the logger the same way `init` does, but the console and file logs are only placed in a
+     * bounded queue on the calling thread, and are written out by a dedicated writer thread.
+     *
+     * @param level The lowest log level that will be logged.
+     * @param type The outputs of the logger.
+     * @param filePathWithExtension The path of the log file, if the file output is used.
+     * @param queueSize The amount of logs that can wait for the writer thread.
+     * @param policy What happens with a new log when the queue is full. Dropping discards the oldest log in the queue.
+     */
+    static void initAsync(LogLevel level, Type type, const std::string& filePathWithExtension = "",
+                          std::size_t queueSize = ASYNC_QUEUE_SIZE, OverflowPolicy policy = OverflowPolicy::BLOCK);
+
+    /**
+     * This method installs handlers for the fatal signals that write the logs held by the log buffer into the standard
+     * error before the application terminates. The handlers only do what is safe to do in a signal handler, so the
+     * logs still queued for the asynchronous outputs are lost, and the buffer is skipped if the crash happened while
+     * it was being written into. The signal is then handed to the handler that was installed before.
+     *
+     * A terminate handler is installed too, which flushes all the outputs, the queued logs included, before calling
+     * the terminate handler that was installed before.
+     */
+    static void installCrashHandler();
+
+    /**
+     * This method checks whether logs of a level are going to be logged at all. The `LOG` macro checks this before any
+     * formatting is done, so disabled logs only cost a single branch.
+     *
+     * @param level The level of the log.
+     * @return Whether the log would be logged.
+     */
+    static bool isEnabled(LogLevel level)
+    {
+        return level != LogLevel::OFF && level >= m_level.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * This method changes the lowest log level that will be logged.
+     *
+     * @param level The new log level.
+     */
+    static void setLevel(LogLevel level);
+
+    static LogLevel getLevel();
+
     void operator+=(const Log& log);
 
     virtual void logEntry(const Log& log);
 
     std::vector<std::string> buffer();
 
+    /**
+     * This method writes out the summaries of the logs held back by the limits, and flushes all the outputs. For the
+     * asynchronous outputs, this waits until the writer thread has written
+     * out all the logs queued before this call, or until `ASYNC_FLUSH_TIMEOUT` passes.
+     */
+    void flush();
+
+    /**
+     * This method returns the amount of logs that were dropped because the asynchronous queue was full.
+     *
+     * @return The amount of dropped logs.
+     */
+    std::size_t droppedLogs() const;
+
+    /**
+     * This method limits the amount of logs of a level a single `LOG` call site can make. The amount of logs held back
+     * is logged once the call site logs in the next period, or within `LIMITER_SUMMARY_INTERVAL` after the period if
+     * the call site stops logging.
+     *
+     * @param level The log level that is limited.
+     * @param logs The amount of logs a call site can make in the period. Zero disables the limit.
+     * @param period The period the amount of logs is counted in.
+     */
+    void setRateLimit(LogLevel level, std::size_t logs, std::chrono::milliseconds period);
+
+    /**
+     * This method sets whether consecutive identical logs of a level are collapsed into a single
+     * "Last message repeated N times" log.
+     *
+     * @param level The log level.
+     * @param collapse Whether the logs are collapsed.
+     */
+    void setCollapseRepeated(LogLevel level, bool collapse);
+
 private:
-    void logMessage(const Log& log, spdlog::logger& logger);
+    void write(const Log& log);
+    LogLimiter& limiter();
+    void writeLimiterSummaries(bool all);
+
+    void logMessage(LogLevel level, const std::string& message, spdlog::logger& logger);
+
+    void enableAsync(std::size_t queueSize, OverflowPolicy policy);
+    std::shared_ptr<spdlog::logger> createLogger(const std::string& name, std::shared_ptr<spdlog::sinks::sink> sink);
+
+    static void onCrash(int signal, siginfo_t* info, void* context);
+    static void onTerminate();
 
     static void setupFileLogger(const std::string& filePathWithExtension);
     static void setupConsoleLogger();
@@ -88,11 +207,22 @@ private:
     static void setupLoggerParams(LogLevel level);
 
     static std::unique_ptr<Logger> m_instance;
+    static std::atomic<LogLevel> m_level;
+
+    std::shared_ptr<spdlog::details::thread_pool> m_threadPool = nullptr;
+    std::shared_ptr<LogFlushSink> m_flushSink = nullptr;
+    std::shared_ptr<spdlog::logger> m_flushLogger = nullptr;
+    OverflowPolicy m_overflowPolicy = OverflowPolicy::BLOCK;
 
     std::shared_ptr<spdlog::logger> m_fileLogger = nullptr;
     std::shared_ptr<spdlog::logger> m_consoleLogger = nullptr;
-    std::shared_ptr<spdlog::logger> m_bufferLogger = nullptr;
-    spdlog::sinks::ringbuffer_sink<std::mutex>* m_bufferSink = nullptr;
+    std::shared_ptr<LogBuffer> m_buffer = nullptr;
+
+    std::mutex m_limiterMutex;
+    std::shared_ptr<LogLimiter> m_limiter = nullptr;
+
+    // Destroyed first, as it writes through the limiter and the outputs
+    std::unique_ptr<Timer> m_limiterTimer;
 };
 
 inline constexpr Logger::Type operator|(Logger::Type a, Logger::Type b)
@@ -105,6 +235,13 @@ inline constexpr bool operator&(Logger::Type a, Logger::Type b)
     return static_cast<int>(a) & static_cast<int>(b);
 }
 
+/**
+ * The log records the operands in a compact binary form, and formats them into the message only once the message is
+ * needed. The operands that are not booleans, numbers, characters, strings or stream manipulators are formatted right
+ * away, on a stream of their own, so the manipulators before them do not apply to them. Besides the manipulators that
+ * take no arguments, `std::setw`, `std::setprecision` and `std::setfill` are kept, while the other manipulators from
+ * `<iomanip>` are ignored.
+ */
 class Log
 {
 public:
@@ -116,22 +253,168 @@ public:
 
     std::string getMessage() const;
 
+    /**
+     * This method sets the call site the log was made at.
+     *
+     * @param file The source file, expected to be a string literal.
+     * @param line The line in the source file.
+     */
+    void setSource(const char* file, int line);
+
+    const char* getFile() const;
+
+    int getLine() const;
+
+    /**
+     * This method returns the operands of the log in the binary form.
+     *
+     * @return The recorded operands.
+     */
+    const std::string& getArguments() const;
+
+    /**
+     * This method formats the operands recorded in the binary form into the log message.
+     *
+     * @param arguments The recorded operands.
+     * @param size The size of the recorded operands.
+     * @return The log message.
+     */
+    static std::string format(const char* arguments, std::size_t size);
+
+    /**
+     * This method writes the operands recorded in the binary form straight into a file descriptor. Nothing is
+     * allocated or locked, so this can be called from a signal handler. The floating point operands are written with
+     * at most six decimals, and the manipulators are ignored.
+     *
+     * @param descriptor The file descriptor the log message is written into.
+     * @param arguments The recorded operands.
+     * @param size The size of the recorded operands.
+     */
+    static void write(int descriptor, const char* arguments, std::size_t size);
+
 private:
+    enum class Argument : char
+    {
+        CHARACTER,
+        SIGNED,
+        UNSIGNED,
+        FLOATING,
+        STRING,
+        MANIPULATOR,
+        FORMATTED,
+        BOOLEAN,
+        WIDTH,
+        PRECISION,
+        FILL
+    };
+
+    template <Argument type> using ArgumentTag = std::integral_constant<Argument, type>;
+
+    template <typename T>
+    using ArgumentOf = ArgumentTag<
+      std::is_same<T, bool>::value ? Argument::BOOLEAN
+      : std::is_same<T, char>::value || std::is_same<T, signed char>::value || std::is_same<T, unsigned char>::value
+        ? Argument::CHARACTER
+      : std::is_integral<T>::value && std::is_signed<T>::value ? Argument::SIGNED
+      : std::is_integral<T>::value ? Argument::UNSIGNED
+      : std::is_same<T, float>::value || std::is_same<T, double>::value ? Argument::FLOATING
+      : std::is_convertible<T, const char*>::value || std::is_same<T, std::string>::value ? Argument::STRING
+      : std::is_same<T, std::ios_base& (*)(std::ios_base&)>::value ? Argument::MANIPULATOR
+      : std::is_same<T, decltype(std::setw(0))>::value ? Argument::WIDTH
+      : std::is_same<T, decltype(std::setprecision(0))>::value ? Argument::PRECISION
+      : std::is_same<T, decltype(std::setfill(' '))>::value ? Argument::FILL
+      : Argument::FORMATTED>;
+
+    template <typename T> void append(Argument type, T value)
+    {
+        m_arguments.push_back(static_cast<char>(type));
+        m_arguments.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void appendString(const char* data, std::size_t size);
+
+    void record(bool value, ArgumentTag<Argument::BOOLEAN>) { append(Argument::BOOLEAN, value); }
+
+    template <typename T> void record(T value, ArgumentTag<Argument::CHARACTER>)
+    {
+        append(Argument::CHARACTER, static_cast<char>(value));
+    }
+
+    template <typename T> void record(T value, ArgumentTag<Argument::SIGNED>)
+    {
+        append(Argument::SIGNED, static_cast<std::int64_t>(value));
+    }
+
+    template <typename T> void record(T value, ArgumentTag<Argument::UNSIGNED>)
+    {
+        append(Argument::UNSIGNED, static_cast<std::uint64_t>(value));
+    }
+
+    template <typename T> void record(T value, ArgumentTag<Argument::FLOATING>)
+    {
+        append(Argument::FLOATING, static_cast<double>(value));
+    }
+
+    void record(const char* value, ArgumentTag<Argument::STRING>);
+
+    void record(const std::string& value, ArgumentTag<Argument::STRING>);
+
+    void record(std::ios_base& (*manipulator)(std::ios_base&), ArgumentTag<Argument::MANIPULATOR>);
+
+    // The values of the manipulators from <iomanip> are read back from a stream they are applied to
+    template <typename T> void record(T manipulator, ArgumentTag<Argument::WIDTH>)
+    {
+        std::ostream stream{nullptr};
+        stream << manipulator;
+        append(Argument::WIDTH, static_cast<std::int64_t>(stream.width()));
+    }
+
+    template <typename T> void record(T manipulator, ArgumentTag<Argument::PRECISION>)
+    {
+        std::ostream stream{nullptr};
+        stream << manipulator;
+        append(Argument::PRECISION, static_cast<std::int64_t>(stream.precision()));
+    }
+
+    template <typename T> void record(T manipulator, ArgumentTag<Argument::FILL>)
+    {
+        std::ostream stream{nullptr};
+        stream << manipulator;
+        append(Argument::FILL, stream.fill());
+    }
+
+    template <typename T> void record(const T& value, ArgumentTag<Argument::FORMATTED>)
+    {
+        std::ostringstream stream;
+        stream << value;
+        record(stream.str(), ArgumentTag<Argument::STRING>{});
+    }
+
     const LogLevel m_level;
-    std::stringstream m_message;
+    std::string m_arguments;
+
+    const char* m_file;
+    int m_line;
 };
 
 template <typename T> Log& Log::operator<<(T value)
 {
-    m_message << value;
+    record(value, ArgumentOf<T>{});
     return *this;
 }
 
 class LOG
 {
 public:
-    explicit LOG(wolkabout::LogLevel level, bool doLog = true);
-    virtual ~LOG();
+    explicit LOG(wolkabout::LogLevel level, bool doLog = true) : m_log(level), m_doLog(doLog) {}
+
+    virtual ~LOG()
+    {
+        if (m_doLog)
+        {
+            wolkabout::Logger::getInstance() += m_log;
+        }
+    }
 
     template <typename T> LOG& operator<<(T value)
     {
@@ -139,6 +422,12 @@ public:
         return *this;
     }
 
+    LOG& from(const char* file, int line)
+    {
+        m_log.setSource(file, line);
+        return *this;
+    }
+
 private:
     wolkabout::Log m_log;
     bool m_doLog;
@@ -157,9 +446,37 @@ constexpr auto INFO = wolkabout::LogLevel::INFO;
 constexpr auto WARN = wolkabout::LogLevel::WARN;
 constexpr auto ERROR = wolkabout::LogLevel::ERROR;
 
+/**
+ * This is used by the `LOG` macro to turn the log stream into a `void` expression, so it can be used in a conditional.
+ */
+class LogVoidify
+{
+public:
+    void operator&(const LOG&) {}
+};
+
 #ifndef METHOD_INFO
 #define METHOD_INFO __PRETTY_FUNCTION__
 #endif
 }    // namespace wolkabout
 
+/**
+ * The lowest log level that is compiled in. Logs with a lower level are removed entirely by the compiler.
+ * 0 - TRACE, 1 - DEBUG, 2 - INFO, 3 - WARN, 4 - ERROR.
+ */
+#ifndef WOLKABOUT_LOG_MIN_LEVEL
+#define WOLKABOUT_LOG_MIN_LEVEL 0
+#endif
+
+#define WOLKABOUT_LOG_LEVEL_ARGUMENT(level, ...) level
+
+/**
+ * The log level is checked before the message is formatted, so the operands of a disabled log are never evaluated.
+ */
+#define LOG(...)                                                                                                      \
+    (static_cast<int>(WOLKABOUT_LOG_LEVEL_ARGUMENT(__VA_ARGS__, unused)) < WOLKABOUT_LOG_MIN_LEVEL ||                 \
+     !wolkabout::Logger::isEnabled(WOLKABOUT_LOG_LEVEL_ARGUMENT(__VA_ARGS__, unused))) ?                              \
+      (void)0 :                                                                                                       \
+      wolkabout::LogVoidify() & wolkabout::LOG(__VA_ARGS__).from(__FILE__, __LINE__)
+
 #endif    // WOLKABOUTCORE_LOGGER_H
@@ -0,0 +1,325 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/utilities/Metrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace
+{
+const std::vector<double> EXPORTED_QUANTILES = {0.5, 0.9, 0.99, 0.999};
+
+std::string escape(const std::string& value)
+{
+    auto escaped = std::string{};
+    escaped.reserve(value.size());
+    for (const auto character : value)
+    {
+        switch (character)
+        {
+        case '"':
+            escaped += "\\\"";
+            break;
+        case '\\':
+            escaped += "\\\\";
+            break;
+        case '\n':
+            escaped += "\\n";
+            break;
+        default:
+            escaped += character;
+        }
+    }
+    return escaped;
+}
+
+std::string key(const std::string& name, const wolkabout::MetricLabels& labels)
+{
+    auto key = name;
+    for (const auto& label : labels)
+        key += '\0' + label.first + '\0' + label.second;
+    return key;
+}
+
+/**
+ * Formats the labels as `{name="value",...}`, with an extra label appended when it is given.
+ */
+std::string prometheusLabels(const wolkabout::MetricLabels& labels, const std::string& extraName = "",
+                             const std::string& extraValue = "")
+{
+    auto pairs = std::vector<std::string>{};
+    for (const auto& label : labels)
+        pairs.emplace_back(label.first + "=\"" + escape(label.second) + "\"");
+    if (!extraName.empty())
+        pairs.emplace_back(extraName + "=\"" + extraValue + "\"");
+    if (pairs.empty())
+        return "";
+
+    auto formatted = std::string{"{"};
+    for (std::size_t i = 0; i < pairs.size(); ++i)
+        formatted += (i == 0 ? "" : ",") + pairs[i];
+    return formatted + "}";
+}
+
+void prometheusHeader(std::ostringstream& stream, std::string& lastName, const std::string& name,
+                      const std::string& help, const std::string& type)
+{
+    // A metric with several sets of labels is described only once
+    if (name == lastName)
+        return;
+
+    lastName = name;
+    stream << "# HELP " << name << " " << help << "\n# TYPE " << name << " " << type << "\n";
+}
+
+std::string jsonLabels(const wolkabout::MetricLabels& labels)
+{
+    auto formatted = std::string{"{"};
+    for (const auto& label : labels)
+    {
+        formatted += formatted.size() == 1 ? "\"" : ",\"";
+        formatted += escape(label.first) + "\":\"" + escape(label.second) + "\"";
+    }
+    return formatted + "}";
+}
+
+template <class Sample> void jsonHeader(std::ostringstream& stream, const Sample& sample)
+{
+    stream << "{\"name\":\"" << escape(sample.name) << "\",\"labels\":" << jsonLabels(sample.labels) << ",\"help\":\""
+           << escape(sample.help) << "\"";
+}
+}    // namespace
+
+namespace wolkabout
+{
+const std::size_t Histogram::SUB_BUCKET_BITS;
+const std::size_t Histogram::SUB_BUCKETS;
+const std::size_t Histogram::BUCKETS;
+
+Histogram::Histogram() : m_count{0}, m_sum{0}, m_max{0}
+{
+    for (auto& bucket : m_buckets)
+        bucket.store(0, std::memory_order_relaxed);
+}
+
+void Histogram::record(std::uint64_t value)
+{
+    m_buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+
+    auto max = m_max.load(std::memory_order_relaxed);
+    while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+void Histogram::recordSince(std::chrono::steady_clock::time_point start)
+{
+    const auto elapsed =
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    record(elapsed > 0 ? static_cast<std::uint64_t>(elapsed) : 0);
+}
+
+std::size_t Histogram::bucketIndex(std::uint64_t value)
+{
+    if (value < SUB_BUCKETS)
+        return static_cast<std::size_t>(value);
+
+    const auto exponent = static_cast<std::size_t>(63 - __builtin_clzll(value));
+    const auto subBucket = static_cast<std::size_t>(value >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+    return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + subBucket;
+}
+
+std::uint64_t Histogram::bucketUpperBound(std::size_t index)
+{
+    if (index < SUB_BUCKETS)
+        return index;
+
+    const auto shift = index / SUB_BUCKETS - 1;
+    const auto lowerBound = static_cast<std::uint64_t>(SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+    return lowerBound + ((std::uint64_t{1} << shift) - 1);
+}
+
+std::uint64_t HistogramSample::valueAt(double quantile) const
+{
+    if (count == 0)
+        return 0;
+
+    const auto rank = static_cast<std::uint64_t>(std::ceil(quantile * static_cast<double>(count)));
+    auto seen = std::uint64_t{0};
+    for (const auto& bucket : buckets)
+    {
+        seen += bucket.second;
+        if (seen >= rank)
+            return std::min(bucket.first, max);
+    }
+    return max;
+}
+
+MetricsRegistry& MetricsRegistry::getInstance()
+{
+    static MetricsRegistry registry;
+    return registry;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help, const MetricLabels& labels)
+{
+    return find(m_counters, name, help, labels);
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help, const MetricLabels& labels)
+{
+    return find(m_gauges, name, help, labels);
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help, const MetricLabels& labels)
+{
+    return find(m_histograms, name, help, labels);
+}
+
+template <class T>
+T& MetricsRegistry::find(std::map<std::string, Entry<T>>& entries, const std::string& name, const std::string& help,
+                         const MetricLabels& labels)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto& entry = entries[key(name, labels)];
+    if (entry.metric == nullptr)
+    {
+        entry.name = name;
+        entry.labels = labels;
+        entry.help = help;
+        entry.metric.reset(new T);
+    }
+    return *entry.metric;
+}
+
+MetricsSnapshot MetricsRegistry::snapshot() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto snapshot = MetricsSnapshot{};
+
+    for (const auto& pair : m_counters)
+    {
+        const auto& entry = pair.second;
+        snapshot.counters.emplace_back(CounterSample{entry.name, entry.labels, entry.help, entry.metric->value()});
+    }
+
+    for (const auto& pair : m_gauges)
+    {
+        const auto& entry = pair.second;
+        snapshot.gauges.emplace_back(GaugeSample{entry.name, entry.labels, entry.help, entry.metric->value()});
+    }
+
+    for (const auto& pair : m_histograms)
+    {
+        const auto& entry = pair.second;
+        auto sample = HistogramSample{entry.name, entry.labels, entry.help, 0, entry.metric->sum(),
+                                      entry.metric->max(), {}};
+        // The count is summed up from the buckets, so the quantiles agree with it while values are being recorded
+        for (std::size_t i = 0; i < Histogram::BUCKETS; ++i)
+        {
+            const auto count = entry.metric->bucketCount(i);
+            if (count == 0)
+                continue;
+
+            sample.buckets.emplace_back(Histogram::bucketUpperBound(i), count);
+            sample.count += count;
+        }
+        snapshot.histograms.emplace_back(std::move(sample));
+    }
+
+    return snapshot;
+}
+
+std::string MetricsRegistry::toPrometheus(const MetricsSnapshot& snapshot)
+{
+    auto stream = std::ostringstream{};
+    auto lastName = std::string{};
+
+    for (const auto& counter : snapshot.counters)
+    {
+        prometheusHeader(stream, lastName, counter.name, counter.help, "counter");
+        stream << counter.name << prometheusLabels(counter.labels) << " " << counter.value << "\n";
+    }
+
+    for (const auto& gauge : snapshot.gauges)
+    {
+        prometheusHeader(stream, lastName, gauge.name, gauge.help, "gauge");
+        stream << gauge.name << prometheusLabels(gauge.labels) << " " << gauge.value << "\n";
+    }
+
+    for (const auto& histogram : snapshot.histograms)
+    {
+        prometheusHeader(stream, lastName, histogram.name, histogram.help, "summary");
+        for (const auto quantile : EXPORTED_QUANTILES)
+        {
+            auto formatted = std::ostringstream{};
+            formatted << quantile;
+            stream << histogram.name << prometheusLabels(histogram.labels, "quantile", formatted.str()) << " "
+                   << histogram.valueAt(quantile) << "\n";
+        }
+        stream << histogram.name << "_sum" << prometheusLabels(histogram.labels) << " " << histogram.sum << "\n";
+        stream << histogram.name << "_count" << prometheusLabels(histogram.labels) << " " << histogram.count << "\n";
+    }
+
+    return stream.str();
+}
+
+std::string MetricsRegistry::toJson(const MetricsSnapshot& snapshot)
+{
+    auto stream = std::ostringstream{};
+
+    stream << "{\"counters\":[";
+    for (std::size_t i = 0; i < snapshot.counters.size(); ++i)
+    {
+        stream << (i == 0 ? "" : ",");
+        jsonHeader(stream, snapshot.counters[i]);
+        stream << ",\"value\":" << snapshot.counters[i].value << "}";
+    }
+
+    stream << "],\"gauges\":[";
+    for (std::size_t i = 0; i < snapshot.gauges.size(); ++i)
+    {
+        stream << (i == 0 ? "" : ",");
+        jsonHeader(stream, snapshot.gauges[i]);
+        stream << ",\"value\":" << snapshot.gauges[i].value << "}";
+    }
+
+    stream << "],\"histograms\":[";
+    for (std::size_t i = 0; i < snapshot.histograms.size(); ++i)
+    {
+        const auto& histogram = snapshot.histograms[i];
+        stream << (i == 0 ? "" : ",");
+        jsonHeader(stream, histogram);
+        stream << ",\"count\":" << histogram.count << ",\"sum\":" << histogram.sum << ",\"max\":" << histogram.max
+               << ",\"p50\":" << histogram.valueAt(0.5) << ",\"p90\":" << histogram.valueAt(0.9)
+               << ",\"p99\":" << histogram.valueAt(0.99) << ",\"p999\":" << histogram.valueAt(0.999)
+               << ",\"buckets\":[";
+        for (std::size_t j = 0; j < histogram.buckets.size(); ++j)
+        {
+            stream << (j == 0 ? "" : ",") << "{\"le\":" << histogram.buckets[j].first
+                   << ",\"count\":" << histogram.buckets[j].second << "}";
+        }
+        stream << "]}";
+    }
+    stream << "]}";
+
+    return stream.str();
+}
+}    // namespace wolkabout
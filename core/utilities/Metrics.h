@@ -0,0 +1,217 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WOLKABOUTCORE_METRICS_H
+#define WOLKABOUTCORE_METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace wolkabout
+{
+using MetricLabels = std::map<std::string, std::string>;
+
+/**
+ * A value that only ever goes up, like the number of published messages.
+ */
+class Counter
+{
+public:
+    Counter() : m_value{0} {}
+
+    void increment(std::uint64_t amount = 1) { m_value.fetch_add(amount, std::memory_order_relaxed); }
+
+    std::uint64_t value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::uint64_t> m_value;
+};
+
+/**
+ * A value that goes up and down, like the number of messages waiting in a queue.
+ */
+class Gauge
+{
+public:
+    Gauge() : m_value{0} {}
+
+    void set(std::int64_t value) { m_value.store(value, std::memory_order_relaxed); }
+
+    void add(std::int64_t amount) { m_value.fetch_add(amount, std::memory_order_relaxed); }
+
+    void increment() { add(1); }
+
+    void decrement() { add(-1); }
+
+    std::int64_t value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::int64_t> m_value;
+};
+
+/**
+ * A distribution of values, like publish latencies in microseconds. The values are counted in buckets that are linear
+ * up to 8, and above that split every power of two into 8 buckets, so any value is known to within 12.5% while the
+ * whole range of 64 bit values fits in a fixed array. Recording a value is a few relaxed atomic operations.
+ */
+class Histogram
+{
+public:
+    static const std::size_t SUB_BUCKET_BITS = 3;
+    static const std::size_t SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+    static const std::size_t BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    Histogram();
+
+    void record(std::uint64_t value);
+
+    /**
+     * Records the time passed since a point, in microseconds.
+     *
+     * @param start The point the measured operation started at.
+     */
+    void recordSince(std::chrono::steady_clock::time_point start);
+
+    std::uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+
+    std::uint64_t sum() const { return m_sum.load(std::memory_order_relaxed); }
+
+    std::uint64_t max() const { return m_max.load(std::memory_order_relaxed); }
+
+    std::uint64_t bucketCount(std::size_t index) const { return m_buckets[index].load(std::memory_order_relaxed); }
+
+    static std::size_t bucketIndex(std::uint64_t value);
+
+    /**
+     * @param index The index of a bucket.
+     * @return The highest value that is counted in the bucket.
+     */
+    static std::uint64_t bucketUpperBound(std::size_t index);
+
+private:
+    std::array<std::atomic<std::uint64_t>, BUCKETS> m_buckets;
+    std::atomic<std::uint64_t> m_count;
+    std::atomic<std::uint64_t> m_sum;
+    std::atomic<std::uint64_t> m_max;
+};
+
+struct CounterSample
+{
+    std::string name;
+    MetricLabels labels;
+    std::string help;
+    std::uint64_t value;
+};
+
+struct GaugeSample
+{
+    std::string name;
+    MetricLabels labels;
+    std::string help;
+    std::int64_t value;
+};
+
+struct HistogramSample
+{
+    std::string name;
+    MetricLabels labels;
+    std::string help;
+    std::uint64_t count;
+    std::uint64_t sum;
+    std::uint64_t max;
+    // The upper bound and the number of values of every bucket that is not empty, in ascending order.
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> buckets;
+
+    /**
+     * @param quantile The quantile, between 0 and 1.
+     * @return The upper bound of the bucket the quantile falls in, capped at the largest recorded value.
+     */
+    std::uint64_t valueAt(double quantile) const;
+};
+
+/**
+ * The values of all the metrics at one point in time, sorted by name.
+ */
+struct MetricsSnapshot
+{
+    std::vector<CounterSample> counters;
+    std::vector<GaugeSample> gauges;
+    std::vector<HistogramSample> histograms;
+};
+
+/**
+ * This class owns all the metrics of the process. Getting a metric takes a lock, so the components look their metrics
+ * up once and keep the reference, after which updating them never blocks. Metrics live as long as the registry does,
+ * and a metric asked for twice with the same name and labels is the same metric.
+ */
+class MetricsRegistry
+{
+public:
+    static MetricsRegistry& getInstance();
+
+    Counter& counter(const std::string& name, const std::string& help, const MetricLabels& labels = {});
+
+    Gauge& gauge(const std::string& name, const std::string& help, const MetricLabels& labels = {});
+
+    Histogram& histogram(const std::string& name, const std::string& help, const MetricLabels& labels = {});
+
+    MetricsSnapshot snapshot() const;
+
+    /**
+     * Formats the snapshot in the Prometheus text exposition format. The histograms are exposed as summaries, with
+     * the 0.5, 0.9, 0.99 and 0.999 quantiles.
+     *
+     * @param snapshot The snapshot to format.
+     * @return The formatted metrics.
+     */
+    static std::string toPrometheus(const MetricsSnapshot& snapshot);
+
+    /**
+     * Formats the snapshot as a JSON object with the "counters", "gauges" and "histograms" arrays.
+     *
+     * @param snapshot The snapshot to format.
+     * @return The formatted metrics.
+     */
+    static std::string toJson(const MetricsSnapshot& snapshot);
+
+private:
+    template <class T> struct Entry
+    {
+        std::string name;
+        MetricLabels labels;
+        std::string help;
+        std::unique_ptr<T> metric;
+    };
+
+    template <class T>
+    T& find(std::map<std::string, Entry<T>>& entries, const std::string& name, const std::string& help,
+            const MetricLabels& labels);
+
+    mutable std::mutex m_mutex;
+    std::map<std::string, Entry<Counter>> m_counters;
+    std::map<std::string, Entry<Gauge>> m_gauges;
+    std::map<std::string, Entry<Histogram>> m_histograms;
+};
+}    // namespace wolkabout
+
+#endif    // WOLKABOUTCORE_METRICS_H
@@ -0,0 +1,218 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WOLKABOUTCORE_RINGBUFFER_H
+#define WOLKABOUTCORE_RINGBUFFER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace wolkabout
+{
+/**
+ * This is a FIFO container that appends at the back and consumes from the front in constant time. The storage only
+ * grows while the buffer is filling up, and a buffer with a capacity overwrites its oldest item once it is full.
+ * The class is not thread safe, the owner is expected to guard it.
+ *
+ * @tparam T The type of the items. It needs to be move constructible and move assignable.
+ */
+template <class T> class RingBuffer
+{
+public:
+    /**
+     * Default constructor.
+     *
+     * @param capacity The maximum number of items the buffer holds. Zero means the buffer is not limited.
+     */
+    explicit RingBuffer(std::size_t capacity = 0);
+
+    std::size_t capacity() const;
+
+    /**
+     * This method changes the capacity of the buffer. If the buffer holds more items than the new capacity, the oldest
+     * ones are dropped.
+     *
+     * @param capacity The new capacity. Zero means the buffer is not limited.
+     */
+    void setCapacity(std::size_t capacity);
+
+    std::size_t size() const;
+
+    bool empty() const;
+
+    /**
+     * This method appends an item to the back of the buffer.
+     *
+     * @param item The item that should be appended.
+     * @return Whether the oldest item had to be dropped to make room for the new one.
+     */
+    bool push(T item);
+
+    /**
+     * This method returns an item by its position, where the position 0 is the oldest item in the buffer.
+     *
+     * @param index The position of the item. It must be less than `size()`.
+     * @return The item at the position.
+     */
+    T& at(std::size_t index);
+    const T& at(std::size_t index) const;
+
+    T& front();
+    const T& front() const;
+
+    /**
+     * This method removes the oldest items from the buffer. Once the buffer is mostly unused, its storage is shrunk to
+     * the remaining items and given back to the allocator, and removing all the items gives back all the storage.
+     *
+     * @param count The number of items to remove. If there are fewer items, all of them are removed.
+     */
+    void pop(std::size_t count = 1);
+
+    /**
+     * This method removes all the items from the buffer, and gives its storage back to the allocator.
+     */
+    void clear();
+
+private:
+    void linearize();
+
+    std::vector<T> m_items;
+    std::size_t m_head;
+    std::size_t m_size;
+    std::size_t m_capacity;
+};
+
+template <class T> RingBuffer<T>::RingBuffer(std::size_t capacity) : m_head{0}, m_size{0}, m_capacity{capacity}
+{
+}
+
+template <class T> std::size_t RingBuffer<T>::capacity() const
+{
+    return m_capacity;
+}
+
+template <class T> void RingBuffer<T>::setCapacity(std::size_t capacity)
+{
+    m_capacity = capacity;
+    if (m_capacity == 0)
+        return;
+
+    if (m_size > m_capacity)
+        pop(m_size - m_capacity);
+
+    if (m_items.size() > m_capacity)
+    {
+        linearize();
+        m_items.erase(m_items.begin() + static_cast<std::ptrdiff_t>(m_size), m_items.end());
+        m_items.shrink_to_fit();
+    }
+}
+
+template <class T> std::size_t RingBuffer<T>::size() const
+{
+    return m_size;
+}
+
+template <class T> bool RingBuffer<T>::empty() const
+{
+    return m_size == 0;
+}
+
+template <class T> bool RingBuffer<T>::push(T item)
+{
+    if (m_capacity != 0 && m_size == m_capacity)
+    {
+        m_items[m_head] = std::move(item);
+        m_head = (m_head + 1) % m_items.size();
+        return true;
+    }
+
+    if (m_size == m_items.size())
+    {
+        // The storage is full, so lay the items out from the start and let the vector grow at the back.
+        linearize();
+        m_items.push_back(std::move(item));
+    }
+    else
+    {
+        m_items[(m_head + m_size) % m_items.size()] = std::move(item);
+    }
+
+    ++m_size;
+    return false;
+}
+
+template <class T> T& RingBuffer<T>::at(std::size_t index)
+{
+    return m_items[(m_head + index) % m_items.size()];
+}
+
+template <class T> const T& RingBuffer<T>::at(std::size_t index) const
+{
+    return m_items[(m_head + index) % m_items.size()];
+}
+
+template <class T> T& RingBuffer<T>::front()
+{
+    return m_items[m_head];
+}
+
+template <class T> const T& RingBuffer<T>::front() const
+{
+    return m_items[m_head];
+}
+
+template <class T> void RingBuffer<T>::pop(std::size_t count)
+{
+    if (count >= m_size)
+    {
+        clear();
+        return;
+    }
+
+    m_head = (m_head + count) % m_items.size();
+    m_size -= count;
+
+    // Release the slots of the consumed items once the buffer is mostly unused, so they don't hold on to memory.
+    if (m_size < m_items.size() / 4)
+    {
+        linearize();
+        m_items.erase(m_items.begin() + static_cast<std::ptrdiff_t>(m_size), m_items.end());
+        m_items.shrink_to_fit();
+    }
+}
+
+template <class T> void RingBuffer<T>::clear()
+{
+    m_items.clear();
+    m_items.shrink_to_fit();
+    m_head = 0;
+    m_size = 0;
+}
+
+template <class T> void RingBuffer<T>::linearize()
+{
+    if (m_head == 0)
+        return;
+
+    std::rotate(m_items.begin(), m_items.begin() + static_cast<std::ptrdiff_t>(m_head), m_items.end());
+    m_head = 0;
+}
+}    // namespace wolkabout
+
+#endif
@@ -17,7 +17,18 @@
 #include "StringUtils.h"
 
 #include <algorithm>
+#include <array>
 #include <cctype>
+#include <cmath>
+#include <spdlog/fmt/fmt.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define WOLKABOUT_BASE64_X86
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define WOLKABOUT_BASE64_NEON
+#include <arm_neon.h>
+#endif
 
 namespace wolkabout
 {
@@ -25,6 +36,355 @@ static const std::string base64_chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
                                         "abcdefghijklmnopqrstuvwxyz"
                                         "0123456789+/";
 
+static const std::uint8_t BASE64_INVALID = 0xFF;
+
+static std::array<std::uint8_t, 256> makeBase64DecodeTable()
+{
+    auto table = std::array<std::uint8_t, 256>{};
+    table.fill(BASE64_INVALID);
+    for (std::size_t i = 0; i < base64_chars.size(); ++i)
+        table[static_cast<std::uint8_t>(base64_chars[i])] = static_cast<std::uint8_t>(i);
+    return table;
+}
+
+static const std::array<std::uint8_t, 256> base64_decode_table = makeBase64DecodeTable();
+
+/**
+ * The vectorized kernels below process only whole blocks, and return how many input bytes they have consumed. The
+ * scalar code picks up from there and handles the tail, padding and invalid characters. Every kernel reads and writes
+ * a couple of bytes past the block it is converting, so the loop conditions leave enough space at the end of both the
+ * input and output buffers.
+ */
+#if defined(WOLKABOUT_BASE64_X86)
+__attribute__((target("ssse3"))) static inline __m128i base64EncodeBlockSsse3(__m128i input)
+{
+    // Spread 12 input bytes into 16 lanes of 6 bits
+    input = _mm_shuffle_epi8(input, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    const auto t0 = _mm_and_si128(input, _mm_set1_epi32(0x0fc0fc00));
+    const auto t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const auto t2 = _mm_and_si128(input, _mm_set1_epi32(0x003f03f0));
+    const auto t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    const auto indices = _mm_or_si128(t1, t3);
+
+    // Translate the 6 bit values into the alphabet by adding a per-range offset
+    auto offsets = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    const auto less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    offsets = _mm_or_si128(offsets, _mm_and_si128(less, _mm_set1_epi8(13)));
+    const auto shiftTable = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                          '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    return _mm_add_epi8(_mm_shuffle_epi8(shiftTable, offsets), indices);
+}
+
+__attribute__((target("ssse3"))) static std::size_t base64EncodeSsse3(const std::uint8_t* input, std::size_t length,
+                                                                      char* output)
+{
+    auto consumed = std::size_t{0};
+    while (length - consumed >= 16)
+    {
+        const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + consumed));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output), base64EncodeBlockSsse3(block));
+        consumed += 12;
+        output += 16;
+    }
+    return consumed;
+}
+
+__attribute__((target("avx2"))) static std::size_t base64EncodeAvx2(const std::uint8_t* input, std::size_t length,
+                                                                    char* output)
+{
+    auto consumed = std::size_t{0};
+    while (length - consumed >= 28)
+    {
+        // Every 128 bit lane receives 12 input bytes, so the in-lane shuffles of the SSSE3 version apply as-is
+        const auto low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + consumed));
+        const auto high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + consumed + 12));
+        auto block = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+
+        block = _mm256_shuffle_epi8(block, _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1, 10, 11, 9,
+                                                           10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+        const auto t0 = _mm256_and_si256(block, _mm256_set1_epi32(0x0fc0fc00));
+        const auto t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        const auto t2 = _mm256_and_si256(block, _mm256_set1_epi32(0x003f03f0));
+        const auto t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        const auto indices = _mm256_or_si256(t1, t3);
+
+        auto offsets = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        const auto less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+        offsets = _mm256_or_si256(offsets, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+        const auto shiftTable = _mm256_setr_epi8(
+          'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+          '+' - 62, '/' - 63, 'A', 0, 0, 'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+          '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+        const auto result = _mm256_add_epi8(_mm256_shuffle_epi8(shiftTable, offsets), indices);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output), result);
+        consumed += 24;
+        output += 32;
+    }
+    return consumed;
+}
+
+__attribute__((target("ssse3"))) static std::size_t base64DecodeSsse3(const char* input, std::size_t length,
+                                                                      std::uint8_t* output)
+{
+    auto consumed = std::size_t{0};
+    while (length - consumed >= 24)
+    {
+        const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + consumed));
+
+        // Classify every character, and pick the offset that turns it into its 6 bit value
+        const auto upper = _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8('A' - 1)),
+                                         _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), block));
+        const auto lower = _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8('a' - 1)),
+                                         _mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), block));
+        const auto digit = _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8('0' - 1)),
+                                         _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), block));
+        const auto plus = _mm_cmpeq_epi8(block, _mm_set1_epi8('+'));
+        const auto slash = _mm_cmpeq_epi8(block, _mm_set1_epi8('/'));
+        const auto valid = _mm_or_si128(_mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, plus)), slash);
+        if (_mm_movemask_epi8(valid) != 0xFFFF)
+            break;
+
+        auto shift = _mm_and_si128(upper, _mm_set1_epi8(-'A'));
+        shift = _mm_or_si128(shift, _mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+        shift = _mm_or_si128(shift, _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+        shift = _mm_or_si128(shift, _mm_and_si128(plus, _mm_set1_epi8(62 - '+')));
+        shift = _mm_or_si128(shift, _mm_and_si128(slash, _mm_set1_epi8(63 - '/')));
+        const auto values = _mm_add_epi8(block, shift);
+
+        // Pack 16 lanes of 6 bits into 12 bytes
+        const auto pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+        const auto quads = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+        const auto packed =
+          _mm_shuffle_epi8(quads, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output), packed);
+        consumed += 16;
+        output += 12;
+    }
+    return consumed;
+}
+
+__attribute__((target("avx2"))) static std::size_t base64DecodeAvx2(const char* input, std::size_t length,
+                                                                    std::uint8_t* output)
+{
+    auto consumed = std::size_t{0};
+    while (length - consumed >= 48)
+    {
+        const auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + consumed));
+
+        const auto upper = _mm256_and_si256(_mm256_cmpgt_epi8(block, _mm256_set1_epi8('A' - 1)),
+                                            _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), block));
+        const auto lower = _mm256_and_si256(_mm256_cmpgt_epi8(block, _mm256_set1_epi8('a' - 1)),
+                                            _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), block));
+        const auto digit = _mm256_and_si256(_mm256_cmpgt_epi8(block, _mm256_set1_epi8('0' - 1)),
+                                            _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), block));
+        const auto plus = _mm256_cmpeq_epi8(block, _mm256_set1_epi8('+'));
+        const auto slash = _mm256_cmpeq_epi8(block, _mm256_set1_epi8('/'));
+        const auto valid =
+          _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(upper, lower), _mm256_or_si256(digit, plus)), slash);
+        if (_mm256_movemask_epi8(valid) != -1)
+            break;
+
+        auto shift = _mm256_and_si256(upper, _mm256_set1_epi8(-'A'));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a')));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(plus, _mm256_set1_epi8(62 - '+')));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(slash, _mm256_set1_epi8(63 - '/')));
+        const auto values = _mm256_add_epi8(block, shift);
+
+        // Pack each lane into its first 12 bytes, and then move the two lanes next to each other
+        const auto pairs = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        const auto quads = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+        const auto packed = _mm256_shuffle_epi8(quads, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1,
+                                                                        -1, -1, 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12,
+                                                                        -1, -1, -1, -1));
+        const auto joined = _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output), joined);
+        consumed += 32;
+        output += 24;
+    }
+    return consumed;
+}
+#elif defined(WOLKABOUT_BASE64_NEON)
+static std::size_t base64EncodeNeon(const std::uint8_t* input, std::size_t length, char* output)
+{
+    auto alphabet = uint8x16x4_t{};
+    for (auto i = 0; i < 4; ++i)
+        alphabet.val[i] = vld1q_u8(reinterpret_cast<const std::uint8_t*>(base64_chars.data()) + i * 16);
+
+    auto consumed = std::size_t{0};
+    while (length - consumed >= 48)
+    {
+        // Deinterleave 48 bytes into three registers, and spread them into four registers of 6 bit values
+        const auto bytes = vld3q_u8(input + consumed);
+        auto indices = uint8x16x4_t{};
+        indices.val[0] = vshrq_n_u8(bytes.val[0], 2);
+        indices.val[1] =
+          vorrq_u8(vshlq_n_u8(vandq_u8(bytes.val[0], vdupq_n_u8(0x03)), 4), vshrq_n_u8(bytes.val[1], 4));
+        indices.val[2] =
+          vorrq_u8(vshlq_n_u8(vandq_u8(bytes.val[1], vdupq_n_u8(0x0F)), 2), vshrq_n_u8(bytes.val[2], 6));
+        indices.val[3] = vandq_u8(bytes.val[2], vdupq_n_u8(0x3F));
+
+        auto characters = uint8x16x4_t{};
+        for (auto i = 0; i < 4; ++i)
+            characters.val[i] = vqtbl4q_u8(alphabet, indices.val[i]);
+        vst4q_u8(reinterpret_cast<std::uint8_t*>(output), characters);
+
+        consumed += 48;
+        output += 64;
+    }
+    return consumed;
+}
+
+static inline uint8x16_t base64DecodeValuesNeon(uint8x16_t block, uint8x16_t& valid)
+{
+    const auto upper = vandq_u8(vcgeq_u8(block, vdupq_n_u8('A')), vcleq_u8(block, vdupq_n_u8('Z')));
+    const auto lower = vandq_u8(vcgeq_u8(block, vdupq_n_u8('a')), vcleq_u8(block, vdupq_n_u8('z')));
+    const auto digit = vandq_u8(vcgeq_u8(block, vdupq_n_u8('0')), vcleq_u8(block, vdupq_n_u8('9')));
+    const auto plus = vceqq_u8(block, vdupq_n_u8('+'));
+    const auto slash = vceqq_u8(block, vdupq_n_u8('/'));
+    valid = vandq_u8(valid, vorrq_u8(vorrq_u8(vorrq_u8(upper, lower), vorrq_u8(digit, plus)), slash));
+
+    auto shift = vandq_u8(upper, vdupq_n_u8(static_cast<std::uint8_t>(-'A')));
+    shift = vorrq_u8(shift, vandq_u8(lower, vdupq_n_u8(static_cast<std::uint8_t>(26 - 'a'))));
+    shift = vorrq_u8(shift, vandq_u8(digit, vdupq_n_u8(static_cast<std::uint8_t>(52 - '0'))));
+    shift = vorrq_u8(shift, vandq_u8(plus, vdupq_n_u8(static_cast<std::uint8_t>(62 - '+'))));
+    shift = vorrq_u8(shift, vandq_u8(slash, vdupq_n_u8(static_cast<std::uint8_t>(63 - '/'))));
+    return vaddq_u8(block, shift);
+}
+
+static std::size_t base64DecodeNeon(const char* input, std::size_t length, std::uint8_t* output)
+{
+    auto consumed = std::size_t{0};
+    while (length - consumed >= 68)
+    {
+        // Deinterleave 64 characters into four registers, one for every position in a quantum
+        const auto block = vld4q_u8(reinterpret_cast<const std::uint8_t*>(input + consumed));
+        auto valid = vdupq_n_u8(0xFF);
+        auto values = uint8x16x4_t{};
+        for (auto i = 0; i < 4; ++i)
+            values.val[i] = base64DecodeValuesNeon(block.val[i], valid);
+        if (vminvq_u8(valid) != 0xFF)
+            break;
+
+        auto bytes = uint8x16x3_t{};
+        bytes.val[0] = vorrq_u8(vshlq_n_u8(values.val[0], 2), vshrq_n_u8(values.val[1], 4));
+        bytes.val[1] = vorrq_u8(vshlq_n_u8(values.val[1], 4), vshrq_n_u8(values.val[2], 2));
+        bytes.val[2] = vorrq_u8(vshlq_n_u8(values.val[2], 6), values.val[3]);
+        vst3q_u8(output, bytes);
+
+        consumed += 64;
+        output += 48;
+    }
+    return consumed;
+}
+#endif
+
+static std::size_t base64EncodeBlocks(const std::uint8_t* input, std::size_t length, char* output)
+{
+#if defined(WOLKABOUT_BASE64_X86)
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    static const bool hasSsse3 = __builtin_cpu_supports("ssse3");
+    if (hasAvx2)
+        return base64EncodeAvx2(input, length, output);
+    if (hasSsse3)
+        return base64EncodeSsse3(input, length, output);
+    return 0;
+#elif defined(WOLKABOUT_BASE64_NEON)
+    return base64EncodeNeon(input, length, output);
+#else
+    (void)input;
+    (void)length;
+    (void)output;
+    return 0;
+#endif
+}
+
+static std::size_t base64DecodeBlocks(const char* input, std::size_t length, std::uint8_t* output)
+{
+#if defined(WOLKABOUT_BASE64_X86)
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    static const bool hasSsse3 = __builtin_cpu_supports("ssse3");
+    if (hasAvx2)
+        return base64DecodeAvx2(input, length, output);
+    if (hasSsse3)
+        return base64DecodeSsse3(input, length, output);
+    return 0;
+#elif defined(WOLKABOUT_BASE64_NEON)
+    return base64DecodeNeon(input, length, output);
+#else
+    (void)input;
+    (void)length;
+    (void)output;
+    return 0;
+#endif
+}
+
+namespace
+{
+template <typename T> std::string integerToString(T value)
+{
+    // The digits are written into a buffer on the stack, and copied out once
+    return fmt::format_int(value).str();
+}
+
+template <typename T> std::string floatingPointToString(T value)
+{
+    // This is the shortest representation that reads back into the same value, unlike the six fixed decimals of
+    // `std::to_string` that lose the precision of the small values and pad all the others
+    auto string = fmt::format("{}", value);
+    if (!std::isfinite(value) || string.find('.') != std::string::npos)
+        return string;
+
+    // The whole numbers still look like floating point numbers
+    const auto exponent = string.find('e');
+    string.insert(exponent == std::string::npos ? string.size() : exponent, ".0");
+    return string;
+}
+}    // namespace
+
+template <> std::string StringUtils::toString<int>(const int& value)
+{
+    return integerToString(value);
+}
+
+template <> std::string StringUtils::toString<unsigned int>(const unsigned int& value)
+{
+    return integerToString(value);
+}
+
+template <> std::string StringUtils::toString<long>(const long& value)
+{
+    return integerToString(value);
+}
+
+template <> std::string StringUtils::toString<unsigned long>(const unsigned long& value)
+{
+    return integerToString(value);
+}
+
+template <> std::string StringUtils::toString<long long>(const long long& value)
+{
+    return integerToString(value);
+}
+
+template <> std::string StringUtils::toString<unsigned long long>(const unsigned long long& value)
+{
+    return integerToString(value);
+}
+
+template <> std::string StringUtils::toString<float>(const float& value)
+{
+    return floatingPointToString(value);
+}
+
+template <> std::string StringUtils::toString<double>(const double& value)
+{
+    return floatingPointToString(value);
+}
+
 const std::string StringUtils::EMPTY_STRING = "";
 const std::string StringUtils::BOOL_TRUE = "true";
 const std::string StringUtils::BOOL_FALSE = "false";
@@ -127,106 +487,107 @@ bool StringUtils::isBase64(unsigned char c)
 
 std::string StringUtils::base64Encode(const ByteArray& bytesToEncode)
 {
-    std::string ret;
-    int i = 0;
-    int j = 0;
-    std::uint8_t char_array_3[3];
-    std::uint8_t char_array_4[4];
+    auto ret = std::string{};
+    ret.resize(base64EncodedLength(bytesToEncode.size()));
+    if (!bytesToEncode.empty())
+        base64Encode(bytesToEncode.data(), bytesToEncode.size(), &ret[0]);
+    return ret;
+}
+
+std::size_t StringUtils::base64Encode(const std::uint8_t* bytesToEncode, std::size_t length, char* encoded)
+{
+    const auto consumed = base64EncodeBlocks(bytesToEncode, length, encoded);
+    auto input = bytesToEncode + consumed;
+    auto output = encoded + (consumed / 3) * 4;
+    auto remaining = length - consumed;
 
-    for (const auto& byte : bytesToEncode)
+    while (remaining >= 3)
     {
-        char_array_3[i++] = byte;
-        if (i == 3)
-        {
-            char_array_4[0] = static_cast<std::uint8_t>((char_array_3[0] & 0xfcu) >> 2u);
-            char_array_4[1] =
-              static_cast<std::uint8_t>(((char_array_3[0] & 0x03u) << 4u) + ((char_array_3[1] & 0xf0u) >> 4u));
-            char_array_4[2] =
-              static_cast<std::uint8_t>(((char_array_3[1] & 0x0fu) << 2u) + ((char_array_3[2] & 0xc0u) >> 6u));
-            char_array_4[3] = static_cast<std::uint8_t>(char_array_3[2] & 0x3fu);
-
-            for (i = 0; i < 4; ++i)
-            {
-                ret += base64_chars[char_array_4[i]];
-            }
-            i = 0;
-        }
+        const auto quantum = (static_cast<std::uint32_t>(input[0]) << 16u) |
+                             (static_cast<std::uint32_t>(input[1]) << 8u) | static_cast<std::uint32_t>(input[2]);
+        *output++ = base64_chars[(quantum >> 18u) & 0x3Fu];
+        *output++ = base64_chars[(quantum >> 12u) & 0x3Fu];
+        *output++ = base64_chars[(quantum >> 6u) & 0x3Fu];
+        *output++ = base64_chars[quantum & 0x3Fu];
+        input += 3;
+        remaining -= 3;
     }
 
-    if (i)
+    if (remaining)
     {
-        for (j = i; j < 3; ++j)
-        {
-            char_array_3[j] = '\0';
-        }
-
-        char_array_4[0] = static_cast<std::uint8_t>(char_array_3[0] & 0xfcu) >> 2u;
-        char_array_4[1] =
-          static_cast<std::uint8_t>(((char_array_3[0] & 0x03u) << 4u) + ((char_array_3[1] & 0xf0u) >> 4u));
-        char_array_4[2] =
-          static_cast<std::uint8_t>(((char_array_3[1] & 0x0fu) << 2u) + ((char_array_3[2] & 0xc0u) >> 6u));
-        char_array_4[3] = static_cast<std::uint8_t>(char_array_3[2] & 0x3fu);
+        auto quantum = static_cast<std::uint32_t>(input[0]) << 16u;
+        if (remaining == 2)
+            quantum |= static_cast<std::uint32_t>(input[1]) << 8u;
+        *output++ = base64_chars[(quantum >> 18u) & 0x3Fu];
+        *output++ = base64_chars[(quantum >> 12u) & 0x3Fu];
+        *output++ = remaining == 2 ? base64_chars[(quantum >> 6u) & 0x3Fu] : '=';
+        *output++ = '=';
+    }
 
-        for (j = 0; j < i + 1; ++j)
-        {
-            ret += base64_chars[char_array_4[j]];
-        }
+    return static_cast<std::size_t>(output - encoded);
+}
 
-        while ((i++ < 3))
-        {
-            ret += '=';
-        }
-    }
+std::size_t StringUtils::base64EncodedLength(std::size_t length)
+{
+    return ((length + 2) / 3) * 4;
+}
 
+std::string StringUtils::base64Decode(const std::string& encodedString)
+{
+    auto ret = std::string{};
+    base64Decode(encodedString, ret);
     return ret;
 }
 
-std::string StringUtils::base64Decode(const std::string& encodedString)
+void StringUtils::base64Decode(const std::string& encodedString, std::string& decoded)
 {
-    std::string ret;
+    // Make place for the largest possible output, and shrink it down once we know the real size
+    decoded.resize(base64DecodedLength(encodedString.size()));
+    const auto written =
+      base64Decode(encodedString.data(), encodedString.size(), reinterpret_cast<std::uint8_t*>(&decoded[0]));
+    decoded.resize(written);
+}
 
-    int in_len = encodedString.size();
-    int i = 0;
-    int j = 0;
-    int in_ = 0;
-    unsigned char char_array_4[4], char_array_3[3];
+std::size_t StringUtils::base64Decode(const char* encodedString, std::size_t length, std::uint8_t* decoded)
+{
+    const auto consumed = base64DecodeBlocks(encodedString, length, decoded);
+    auto written = (consumed / 4) * 3;
 
-    while (in_len-- && (encodedString[in_] != '=') && isBase64(encodedString[in_]))
+    auto quantum = std::uint32_t{0};
+    auto count = 0;
+    for (auto i = consumed; i < length; ++i)
     {
-        char_array_4[i++] = encodedString[in_];
-        in_++;
-        if (i == 4)
-        {
-            for (i = 0; i < 4; i++)
-                char_array_4[i] = base64_chars.find(char_array_4[i]);
+        const auto value = base64_decode_table[static_cast<std::uint8_t>(encodedString[i])];
+        if (value == BASE64_INVALID)
+            break;
 
-            char_array_3[0] = (char_array_4[0] << 2) + ((char_array_4[1] & 0x30) >> 4);
-            char_array_3[1] = ((char_array_4[1] & 0xf) << 4) + ((char_array_4[2] & 0x3c) >> 2);
-            char_array_3[2] = ((char_array_4[2] & 0x3) << 6) + char_array_4[3];
-
-            for (i = 0; (i < 3); i++)
-                ret += char_array_3[i];
-            i = 0;
+        quantum = (quantum << 6u) | value;
+        if (++count == 4)
+        {
+            decoded[written++] = static_cast<std::uint8_t>((quantum >> 16u) & 0xFFu);
+            decoded[written++] = static_cast<std::uint8_t>((quantum >> 8u) & 0xFFu);
+            decoded[written++] = static_cast<std::uint8_t>(quantum & 0xFFu);
+            quantum = 0;
+            count = 0;
         }
     }
 
-    if (i)
+    // Flush the leftover characters, if there's any
+    if (count == 2)
     {
-        for (j = i; j < 4; j++)
-            char_array_4[j] = 0;
-
-        for (j = 0; j < 4; j++)
-            char_array_4[j] = base64_chars.find(char_array_4[j]);
-
-        char_array_3[0] = (char_array_4[0] << 2) + ((char_array_4[1] & 0x30) >> 4);
-        char_array_3[1] = ((char_array_4[1] & 0xf) << 4) + ((char_array_4[2] & 0x3c) >> 2);
-        char_array_3[2] = ((char_array_4[2] & 0x3) << 6) + char_array_4[3];
-
-        for (j = 0; (j < i - 1); j++)
-            ret += char_array_3[j];
+        decoded[written++] = static_cast<std::uint8_t>((quantum >> 4u) & 0xFFu);
+    }
+    else if (count == 3)
+    {
+        decoded[written++] = static_cast<std::uint8_t>((quantum >> 10u) & 0xFFu);
+        decoded[written++] = static_cast<std::uint8_t>((quantum >> 2u) & 0xFFu);
     }
+    return written;
+}
 
-    return ret;
+std::size_t StringUtils::base64DecodedLength(std::size_t length)
+{
+    return (length / 4) * 3 + 3;
 }
 
 bool StringUtils::mqttTopicMatch(const std::string& wildcardTopic, const std::string& topic)
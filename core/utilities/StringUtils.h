@@ -51,12 +51,66 @@ public:
 
     static std::string base64Encode(const ByteArray& bytesToEncode);
 
+    /**
+     * This is the method that will encode a buffer of bytes into a base64 buffer, with padding.
+     *
+     * @param bytesToEncode The bytes that need to be encoded.
+     * @param length The number of bytes that need to be encoded.
+     * @param encoded The output buffer. Must have place for at least `base64EncodedLength(length)` characters.
+     * @return The number of characters written into the output buffer.
+     */
+    static std::size_t base64Encode(const std::uint8_t* bytesToEncode, std::size_t length, char* encoded);
+
+    /**
+     * This is the method that will calculate the exact length of the base64 encoding of a buffer.
+     *
+     * @param length The number of bytes that need to be encoded.
+     * @return The number of base64 characters with padding.
+     */
+    static std::size_t base64EncodedLength(std::size_t length);
+
     static std::string base64Decode(const std::string& encodedString);
 
+    /**
+     * This is the method that will decode a base64 string directly into the destination string, reusing its memory.
+     * Decoding stops at the first padding or non-base64 character.
+     *
+     * @param encodedString The base64 encoded string.
+     * @param decoded The string into which the decoded bytes will be written. Previous content is discarded.
+     */
+    static void base64Decode(const std::string& encodedString, std::string& decoded);
+
+    /**
+     * This is the method that will decode a base64 buffer into a buffer of bytes.
+     * Decoding stops at the first padding or non-base64 character.
+     *
+     * @param encodedString The base64 encoded characters.
+     * @param length The number of characters in the buffer.
+     * @param decoded The output buffer. Must have place for at least `base64DecodedLength(length)` bytes.
+     * @return The number of bytes written into the output buffer.
+     */
+    static std::size_t base64Decode(const char* encodedString, std::size_t length, std::uint8_t* decoded);
+
+    /**
+     * This is the method that will calculate the upper bound of the decoded size of a base64 buffer.
+     *
+     * @param length The number of base64 characters.
+     * @return The maximum number of bytes the characters can decode into.
+     */
+    static std::size_t base64DecodedLength(std::size_t length);
+
     static bool mqttTopicMatch(const std::string& wildcardTopic, const std::string& topic);
 
     static std::string toUpperCase(const std::string& string);
 
+    /**
+     * This is the method that will convert a value into a string. The numbers are formatted without consulting the
+     * locale, and the floating point numbers are written with the fewest digits that read back into the same number,
+     * always with the decimal point.
+     *
+     * @param value The value that needs to be converted.
+     * @return The value as a string.
+     */
     template <typename T> static std::string toString(const T& value);
 
     static std::vector<std::string> tokenize(std::string const& str, const char delim);
@@ -96,6 +150,15 @@ template <> inline std::string StringUtils::toString<const char*>(const char* co
 {
     return std::string{value};
 }
+
+template <> std::string StringUtils::toString<int>(const int& value);
+template <> std::string StringUtils::toString<unsigned int>(const unsigned int& value);
+template <> std::string StringUtils::toString<long>(const long& value);
+template <> std::string StringUtils::toString<unsigned long>(const unsigned long& value);
+template <> std::string StringUtils::toString<long long>(const long long& value);
+template <> std::string StringUtils::toString<unsigned long long>(const unsigned long long& value);
+template <> std::string StringUtils::toString<float>(const float& value);
+template <> std::string StringUtils::toString<double>(const double& value);
 }    // namespace wolkabout
 
 #endif
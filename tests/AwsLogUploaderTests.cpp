@@ -0,0 +1,143 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <any>
+#include <sstream>
+
+#define private public
+#define protected public
+#include "core/log_uploader/AwsLogUploader.h"
+#undef private
+#undef protected
+
+#include "core/utilities/FileSystemUtils.h"
+#include "core/utilities/Logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <map>
+#include <gtest/gtest.h>
+
+using namespace wolkabout;
+using namespace ::testing;
+
+/**
+ * These tests run against an S3 compatible storage (for example a local MinIO server), given with the
+ * `AWS_LOG_UPLOADER_TEST_ENDPOINT` and `AWS_LOG_UPLOADER_TEST_BUCKET` environment variables. The bucket has to
+ * exist, and the credentials are read the same way the AWS SDK always reads them. Without the variables, the tests are
+ * skipped.
+ */
+class AwsLogUploaderTests : public ::testing::Test
+{
+public:
+    static void SetUpTestCase() { Logger::init(LogLevel::TRACE, Logger::Type::CONSOLE); }
+
+    void SetUp() override
+    {
+        const auto endpoint = std::getenv("AWS_LOG_UPLOADER_TEST_ENDPOINT");
+        const auto bucket = std::getenv("AWS_LOG_UPLOADER_TEST_BUCKET");
+        if (endpoint == nullptr || bucket == nullptr)
+            GTEST_SKIP() << "No S3 compatible storage to test against.";
+
+        uploader = std::unique_ptr<AwsLogUploader>{new AwsLogUploader{bucket, "us-east-1", endpoint}};
+    }
+
+    void TearDown() override
+    {
+        for (const auto& file : createdFiles)
+            FileSystemUtils::deleteFile(file);
+    }
+
+    std::string createFile(const std::string& name, std::size_t size)
+    {
+        auto content = std::string(size, '\0');
+        for (std::size_t i = 0; i < size; ++i)
+            content[i] = static_cast<char>('a' + i % 26);
+        EXPECT_TRUE(FileSystemUtils::createFileWithContent(name, content));
+        createdFiles.emplace_back(name);
+        return name;
+    }
+
+    bool isRemote(const std::string& name)
+    {
+        const auto remoteLogs = uploader->getRemoteLogs();
+        return std::find(remoteLogs.cbegin(), remoteLogs.cend(), name) != remoteLogs.cend();
+    }
+
+    std::unique_ptr<AwsLogUploader> uploader;
+    std::vector<std::string> createdFiles;
+};
+
+TEST_F(AwsLogUploaderTests, UploadSmallFile)
+{
+    const auto file = createFile("AwsLogUploaderTestsSmall.log", 1024);
+    ASSERT_TRUE(uploader->upload(file));
+    EXPECT_TRUE(isRemote(file));
+}
+
+TEST_F(AwsLogUploaderTests, UploadLargeFileInParts)
+{
+    const auto file = createFile("AwsLogUploaderTestsLarge.log",
+                                 static_cast<std::size_t>(AwsLogUploader::MULTIPART_THRESHOLD + 12345));
+    ASSERT_TRUE(uploader->upload(file));
+    EXPECT_TRUE(isRemote(file));
+}
+
+TEST_F(AwsLogUploaderTests, InterruptedUploadIsContinued)
+{
+    const auto file = createFile("AwsLogUploaderTestsResumed.log",
+                                 static_cast<std::size_t>(AwsLogUploader::MULTIPART_THRESHOLD + 12345));
+
+    // The first attempt stops after a few parts, and the second one uploads the rest
+    std::atomic<int> checks{0};
+    EXPECT_FALSE(uploader->upload(file, [&] { return ++checks > 2; }));
+    EXPECT_FALSE(isRemote(file));
+
+    ASSERT_TRUE(uploader->upload(file, [] { return false; }));
+    EXPECT_TRUE(isRemote(file));
+}
+
+TEST_F(AwsLogUploaderTests, KeyPrefixSeparatesTheDevices)
+{
+    const auto file = createFile("AwsLogUploaderTestsPrefixed.log", 1024);
+    uploader->setKeyPrefix("DEVICE_KEY");
+    EXPECT_EQ(uploader->getRemoteName("/var/log/device.log"), "DEVICE_KEY/var/log/device.log");
+    EXPECT_EQ(uploader->getRemoteName(file), "DEVICE_KEY/" + file);
+
+    ASSERT_TRUE(uploader->upload(file));
+    EXPECT_TRUE(isRemote("DEVICE_KEY/" + file));
+    EXPECT_EQ(uploader->getRemoteLogSizes("DEVICE_KEY/"),
+              (std::map<std::string, std::uint64_t>{{"DEVICE_KEY/" + file, 1024}}));
+}
+
+TEST_F(AwsLogUploaderTests, UploadMissingFile)
+{
+    EXPECT_FALSE(uploader->upload("AwsLogUploaderTestsMissing.log"));
+}
+
+TEST_F(AwsLogUploaderTests, UploadersShareTheSdk)
+{
+    // A second uploader reuses the initialized SDK, and destroying it keeps the SDK up for the first one
+    {
+        AwsLogUploader second{uploader->getBucketName(), uploader->getRegion(),
+                              std::getenv("AWS_LOG_UPLOADER_TEST_ENDPOINT")};
+        EXPECT_EQ(second.getBucketName(), uploader->getBucketName());
+    }
+
+    const auto file = createFile("AwsLogUploaderTestsShared.log", 64);
+    EXPECT_TRUE(uploader->upload(file));
+}
@@ -35,3 +35,19 @@ class BufferTests : public ::testing::Test
 public:
     static void SetUpTestCase() { Logger::init(LogLevel::TRACE, Logger::Type::CONSOLE); }
 };
+
+TEST_F(BufferTests, IsDrainedCountsThePushedItems)
+{
+    Buffer<int> buffer;
+    EXPECT_TRUE(buffer.isDrained());
+
+    buffer.push(1);
+    EXPECT_TRUE(buffer.isEmpty());
+    EXPECT_FALSE(buffer.isDrained());
+
+    buffer.swapBuffers();
+    EXPECT_FALSE(buffer.isDrained());
+
+    EXPECT_EQ(buffer.pop(), 1);
+    EXPECT_TRUE(buffer.isDrained());
+}
@@ -0,0 +1,140 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <memory>
+
+#define private public
+#define protected public
+#include "core/persistence/filesystem/CircularFileSystemMessagePersistence.h"
+#include "core/persistence/filesystem/FileSystemMessagePersistence.h"
+#include "core/persistence/filesystem/MessagePersister.h"
+#undef private
+#undef protected
+
+#include "core/model/Message.h"
+#include "core/utilities/FileSystemUtils.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+using namespace wolkabout;
+using namespace ::testing;
+
+namespace
+{
+const std::string TEST_DIR = "./fsMessagePersistenceTestDir";
+}
+
+class FileSystemMessagePersistenceTests : public ::testing::Test
+{
+public:
+    void SetUp() override
+    {
+        service = std::unique_ptr<FileSystemMessagePersistence>{
+          new FileSystemMessagePersistence{TEST_DIR, PersistenceMethod::FIFO}};
+    }
+
+    void TearDown() override
+    {
+        service.reset();
+        for (const auto& file : FileSystemUtils::listFiles(TEST_DIR))
+            FileSystemUtils::deleteFile(FileSystemUtils::composePath(file, TEST_DIR));
+        rmdir(TEST_DIR.c_str());
+    }
+
+    std::unique_ptr<FileSystemMessagePersistence> service;
+};
+
+TEST_F(FileSystemMessagePersistenceTests, MessagesAreLoadedAsTheyWerePersisted)
+{
+    ASSERT_TRUE(service->push(std::make_shared<wolkabout::Message>("[{\"T\":21.5}]", "d2p/KEY/feed_values")));
+    ASSERT_TRUE(service->push(std::make_shared<wolkabout::Message>("[\"T\"]", "d2p/KEY/feed_values_request")));
+
+    service.reset(new FileSystemMessagePersistence{TEST_DIR, PersistenceMethod::FIFO});
+    auto message = service->front();
+    ASSERT_NE(message, nullptr);
+    EXPECT_EQ(message->getChannel(), "d2p/KEY/feed_values");
+    EXPECT_EQ(message->getContent(), "[{\"T\":21.5}]");
+
+    service->pop();
+    message = service->front();
+    ASSERT_NE(message, nullptr);
+    EXPECT_EQ(message->getChannel(), "d2p/KEY/feed_values_request");
+    EXPECT_EQ(message->getContent(), "[\"T\"]");
+
+    service->pop();
+    EXPECT_TRUE(service->empty());
+}
+
+TEST_F(FileSystemMessagePersistenceTests, MessagesKeepTheirIds)
+{
+    const auto persisted = std::make_shared<wolkabout::Message>("{}", "d2p/KEY/feed_values");
+    ASSERT_TRUE(service->push(persisted));
+
+    service.reset(new FileSystemMessagePersistence{TEST_DIR, PersistenceMethod::FIFO});
+    const auto loaded = service->front();
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->getId(), persisted->getId());
+    EXPECT_GT(wolkabout::Message("", "").getId(), persisted->getId());
+
+    // The messages persisted without an id get a new one
+    const auto legacy = MessagePersister{}.load("d2p/KEY/feed_values\n{}");
+    ASSERT_NE(legacy, nullptr);
+    EXPECT_EQ(legacy->getChannel(), "d2p/KEY/feed_values");
+    EXPECT_EQ(legacy->getContent(), "{}");
+    EXPECT_GT(legacy->getId(), persisted->getId());
+}
+
+TEST_F(FileSystemMessagePersistenceTests, OnlyTheLoadedMessageIsRemoved)
+{
+    ASSERT_TRUE(service->push(std::make_shared<wolkabout::Message>("old", "topic")));
+    ASSERT_TRUE(service->push(std::make_shared<wolkabout::Message>("new", "topic")));
+
+    // The loaded message expires before it is removed
+    const auto loaded = service->front();
+    ASSERT_NE(loaded, nullptr);
+    ASSERT_EQ(service->removeOlderThan(std::chrono::system_clock::now() + std::chrono::hours{1}), 2);
+    ASSERT_TRUE(service->push(std::make_shared<wolkabout::Message>("newest", "topic")));
+
+    EXPECT_FALSE(service->remove(loaded));
+    ASSERT_EQ(service->m_readingFiles.size(), 1);
+
+    const auto newest = service->front();
+    ASSERT_NE(newest, nullptr);
+    EXPECT_EQ(newest->getContent(), "newest");
+    EXPECT_FALSE(service->remove(std::make_shared<wolkabout::Message>("newest", "topic")));
+    EXPECT_TRUE(service->remove(newest));
+    EXPECT_TRUE(service->empty());
+}
+
+TEST_F(FileSystemMessagePersistenceTests, CircularPersistenceOnlyDropsWhatIsOverTheLimit)
+{
+    service.reset();
+    const auto message = std::make_shared<wolkabout::Message>(std::string(100, 'x'), "d2p/KEY/feed_values");
+    const auto size = MessagePersister{}.save(*message).size();
+    auto circular = std::unique_ptr<CircularFileSystemMessagePersistence>{new CircularFileSystemMessagePersistence{
+      TEST_DIR, PersistenceMethod::FIFO, static_cast<unsigned>(size * 3)}};
+
+    for (auto i = 0; i < 5; ++i)
+        ASSERT_TRUE(circular->push(message));
+    EXPECT_EQ(circular->m_readingFiles.size(), 3);
+    EXPECT_EQ(circular->m_totalFileSize, size * 3);
+
+    circular->setSizeLimit(static_cast<unsigned>(size * 2));
+    EXPECT_EQ(circular->m_readingFiles.size(), 2);
+    EXPECT_EQ(circular->m_totalFileSize, size * 2);
+}
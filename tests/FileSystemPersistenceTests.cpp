@@ -0,0 +1,222 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <memory>
+#include <vector>
+
+#define private public
+#define protected public
+#include "core/persistence/filesystem/FileSystemPersistence.h"
+#undef private
+#undef protected
+
+#include "core/utilities/FileSystemUtils.h"
+#include "core/utilities/Logger.h"
+
+#include <fstream>
+#include <gtest/gtest.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace wolkabout;
+using namespace ::testing;
+
+class FileSystemPersistenceTests : public ::testing::Test
+{
+public:
+    static void SetUpTestCase() { Logger::init(LogLevel::TRACE, Logger::Type::CONSOLE); }
+
+    void SetUp() override { service = std::unique_ptr<FileSystemPersistence>{new FileSystemPersistence{TEST_DIR}}; }
+
+    void TearDown() override
+    {
+        service.reset();
+        for (const auto& file : FileSystemUtils::listFiles(TEST_DIR))
+            FileSystemUtils::deleteFile(FileSystemUtils::composePath(file, TEST_DIR));
+        rmdir(TEST_DIR.c_str());
+    }
+
+    void restart()
+    {
+        service.reset();
+        service.reset(new FileSystemPersistence{TEST_DIR});
+    }
+
+    std::unique_ptr<FileSystemPersistence> service;
+
+    const std::string TEST_DIR = "./fileSystemPersistenceTests";
+};
+
+TEST_F(FileSystemPersistenceTests, ReadingsOutliveRestart)
+{
+    ASSERT_TRUE(service->putReading("T", Reading{"T", std::uint64_t{21}, 1000}));
+    ASSERT_TRUE(service->putReading("T", Reading{"T", std::string{"line\nbreak 5:"}, 1001}));
+    ASSERT_TRUE(service->putReading("L", Reading{"L", std::vector<std::string>{"1", "", "3"}, 1002}));
+
+    restart();
+
+    EXPECT_EQ(service->getReadingsKeys(), (std::vector<std::string>{"L", "T"}));
+    const auto readings = service->getReadings("T", 10);
+    ASSERT_EQ(readings.size(), 2);
+    EXPECT_EQ(readings[0]->getReference(), "T");
+    EXPECT_EQ(readings[0]->getUIntValue(), 21);
+    EXPECT_EQ(readings[0]->getTimestamp(), 1000);
+    EXPECT_EQ(readings[1]->getStringValue(), "line\nbreak 5:");
+    const auto multiValue = service->getReadings("L", 1);
+    ASSERT_EQ(multiValue.size(), 1);
+    EXPECT_EQ(multiValue[0]->getStringValues(), (std::vector<std::string>{"1", "", "3"}));
+}
+
+TEST_F(FileSystemPersistenceTests, RemovedReadingsStayRemoved)
+{
+    for (std::uint64_t i = 0; i < 5; ++i)
+        service->putReading("T", Reading{"T", i});
+    service->removeReadings("T", 2);
+
+    restart();
+
+    auto values = std::vector<std::uint64_t>{};
+    const auto visited =
+      service->visitReadings("T", 10, [&](const Reading& reading) { values.push_back(reading.getUIntValue()); });
+    EXPECT_EQ(visited, 3);
+    EXPECT_EQ(values, (std::vector<std::uint64_t>{2, 3, 4}));
+}
+
+TEST_F(FileSystemPersistenceTests, DrainedLogIsDropped)
+{
+    service->putReading("T", Reading{"T", std::uint64_t{1}});
+    service->removeReadings("T", 1);
+    EXPECT_TRUE(service->isEmpty());
+    EXPECT_FALSE(FileSystemUtils::isFilePresent(service->logPath("T", 0)));
+
+    service->putReading("T", Reading{"T", std::uint64_t{2}});
+    restart();
+
+    const auto readings = service->getReadings("T", 10);
+    ASSERT_EQ(readings.size(), 1);
+    EXPECT_EQ(readings[0]->getUIntValue(), 2);
+}
+
+TEST_F(FileSystemPersistenceTests, LogIsCompactedOnceMostlyRemoved)
+{
+    const auto value = std::string(10 * 1024, 'v');
+    for (auto i = 0; i < 200; ++i)
+        service->putReading("T", Reading{"T", value + std::to_string(i)});
+    service->removeReadings("T", 150);
+
+    EXPECT_EQ(service->m_readings["T"].generation, 1);
+    EXPECT_EQ(service->m_readings["T"].head, 0);
+    EXPECT_FALSE(FileSystemUtils::isFilePresent(service->logPath("T", 0)));
+
+    service->putReading("T", Reading{"T", std::string{"last"}});
+    restart();
+
+    const auto readings = service->getReadings("T", 100);
+    ASSERT_EQ(readings.size(), 51);
+    EXPECT_EQ(readings.front()->getStringValue(), value + "150");
+    EXPECT_EQ(readings.back()->getStringValue(), "last");
+}
+
+TEST_F(FileSystemPersistenceTests, CompactionIsUndoneWhenTheHeadsCanNotBeSaved)
+{
+    const auto value = std::string(10 * 1024, 'v');
+    for (auto i = 0; i < 200; ++i)
+        service->putReading("T", Reading{"T", value + std::to_string(i)});
+
+    // The heads can not be replaced while a directory is in the way of their temporary file
+    const auto blocker = FileSystemUtils::composePath("readings.heads.part", TEST_DIR);
+    ASSERT_TRUE(FileSystemUtils::createDirectory(blocker));
+    service->removeReadings("T", 150);
+    EXPECT_EQ(service->m_readings["T"].generation, 0);
+    EXPECT_TRUE(FileSystemUtils::isFilePresent(service->logPath("T", 0)));
+    EXPECT_FALSE(FileSystemUtils::isFilePresent(service->logPath("T", 1)));
+
+    service->putReading("T", Reading{"T", std::string{"last"}});
+    rmdir(blocker.c_str());
+    restart();
+
+    const auto readings = service->getReadings("T", 100);
+    ASSERT_EQ(readings.size(), 51);
+    EXPECT_EQ(readings.front()->getStringValue(), value + "150");
+    EXPECT_EQ(readings.back()->getStringValue(), "last");
+}
+
+TEST_F(FileSystemPersistenceTests, IncompleteReadingIsDropped)
+{
+    service->putReading("T", Reading{"T", std::uint64_t{1}});
+    service->putReading("T", Reading{"T", std::uint64_t{2}});
+    const auto path = service->logPath("T", 0);
+    service.reset();
+
+    {
+        auto stream = std::ofstream{path, std::ios::binary | std::ios::app};
+        stream << "4:1003" << "1:T" << "3:4";
+    }
+
+    restart();
+    EXPECT_EQ(service->getReadings("T", 10).size(), 2);
+
+    service->putReading("T", Reading{"T", std::uint64_t{3}});
+    const auto readings = service->getReadings("T", 10);
+    ASSERT_EQ(readings.size(), 3);
+    EXPECT_EQ(readings.back()->getUIntValue(), 3);
+}
+
+TEST_F(FileSystemPersistenceTests, AttributesAndParametersOutliveRestart)
+{
+    service->putAttribute("A", std::make_shared<Attribute>("A", DataType::STRING, "first"));
+    service->putAttribute("A", std::make_shared<Attribute>("A", DataType::NUMERIC, "2"));
+    service->putAttribute("B", std::make_shared<Attribute>("B", DataType::BOOLEAN, "true"));
+    service->removeAttributes("B");
+    service->putParameter("P", Parameter{ParameterName::EXTERNAL_ID, "ID"});
+
+    restart();
+
+    EXPECT_EQ(service->getAttributeKeys(), std::vector<std::string>{"A"});
+    const auto attribute = service->getAttributeUnderKey("A");
+    ASSERT_NE(attribute, nullptr);
+    EXPECT_EQ(attribute->getDataType(), DataType::NUMERIC);
+    EXPECT_EQ(attribute->getValue(), "2");
+    EXPECT_EQ(service->getParameterForKey("P").first, ParameterName::EXTERNAL_ID);
+    EXPECT_EQ(service->getParameterForKey("P").second, "ID");
+    EXPECT_FALSE(service->isEmpty());
+
+    service->removeAttributes();
+    service->removeParameters();
+    restart();
+    EXPECT_TRUE(service->isEmpty());
+}
+
+TEST_F(FileSystemPersistenceTests, ReadingsExpireByInsertionTime)
+{
+    service->putReading("T", Reading{"T", std::uint64_t{1}});
+    service->putReading("P", Reading{"P", std::uint64_t{2}});
+    std::this_thread::sleep_for(std::chrono::milliseconds{5});
+    const auto expiry = std::chrono::system_clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds{5});
+    service->putReading("T", Reading{"T", std::uint64_t{3}});
+
+    EXPECT_EQ(service->removeReadingsOlderThan(expiry - std::chrono::hours{1}), 0);
+    EXPECT_EQ(service->removeReadingsOlderThan(expiry), 2);
+    EXPECT_EQ(service->getReadingsKeys(), std::vector<std::string>{"T"});
+
+    restart();
+
+    const auto readings = service->getReadings("T", 10);
+    ASSERT_EQ(readings.size(), 1);
+    EXPECT_EQ(readings.front()->getUIntValue(), 3);
+}
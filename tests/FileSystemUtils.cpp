@@ -28,6 +28,7 @@
 #include <gtest/gtest.h>
 
 #include <fstream>
+#include <zlib.h>
 
 using namespace wolkabout;
 using namespace ::testing;
@@ -225,6 +226,92 @@ TEST_F(FileSystemUtilsTests, ReadFileBinaryFileDoesntExist)
     ASSERT_FALSE(FileSystemUtils::readBinaryFileContent(TEST_FILE, value));
 }
 
+TEST_F(FileSystemUtilsTests, ReadFileBinaryLargerThanBuffer)
+{
+    auto content = ByteArray(200 * 1024 + 13);
+    for (std::size_t i = 0; i < content.size(); ++i)
+        content[i] = static_cast<Byte>(i % 253);
+    ASSERT_TRUE(FileSystemUtils::createBinaryFileWithContent(TEST_FILE, content));
+
+    auto value = ByteArray{1, 2, 3};
+    ASSERT_TRUE(FileSystemUtils::readBinaryFileContent(TEST_FILE, value));
+    EXPECT_EQ(value, content);
+    EXPECT_EQ(value.capacity(), content.size());
+}
+
+TEST_F(FileSystemUtilsTests, ReadFileBinaryWithoutSize)
+{
+    // The files in /proc report no size, but they do have content
+    auto value = ByteArray{};
+    ASSERT_TRUE(FileSystemUtils::readBinaryFileContent("/proc/self/status", value));
+    ASSERT_GT(value.size(), 5);
+    EXPECT_EQ(std::string(value.begin(), value.begin() + 5), "Name:");
+
+    auto hash = ByteArray{};
+    ASSERT_TRUE(FileSystemUtils::hashFile("/proc/self/cmdline", HashAlgorithm::MD5, hash));
+    ASSERT_TRUE(FileSystemUtils::readBinaryFileContent("/proc/self/cmdline", value));
+    EXPECT_EQ(hash, ByteUtils::hashMDA5(value));
+}
+
+TEST_F(FileSystemUtilsTests, HashFile)
+{
+    ASSERT_TRUE(writeToFile("AAAAA"));
+
+    auto hash = ByteArray{};
+    ASSERT_TRUE(FileSystemUtils::hashFile(TEST_FILE, HashAlgorithm::SHA256, hash));
+    EXPECT_EQ(ByteUtils::toHexString(hash), "11770b3ea657fe68cba19675143e4715c8de9d763d3c21a85af6b7513d43997d");
+    ASSERT_TRUE(FileSystemUtils::hashFile(TEST_FILE, HashAlgorithm::MD5, hash));
+    EXPECT_EQ(ByteUtils::toHexString(hash), "f6a6263167c92de8644ac998b3c4e4d1");
+}
+
+TEST_F(FileSystemUtilsTests, HashFileLargerThanBuffer)
+{
+    auto content = ByteArray(200 * 1024 + 13);
+    for (std::size_t i = 0; i < content.size(); ++i)
+        content[i] = static_cast<Byte>(i % 253);
+    ASSERT_TRUE(FileSystemUtils::createBinaryFileWithContent(TEST_FILE, content));
+
+    auto hash = ByteArray{};
+    ASSERT_TRUE(FileSystemUtils::hashFile(TEST_FILE, HashAlgorithm::SHA256, hash));
+    EXPECT_EQ(hash, ByteUtils::hashSHA256(content));
+}
+
+TEST_F(FileSystemUtilsTests, HashFileDoesntExist)
+{
+    auto hash = ByteArray{};
+    ASSERT_FALSE(FileSystemUtils::hashFile(TEST_FILE, HashAlgorithm::MD5, hash));
+}
+
+TEST_F(FileSystemUtilsTests, CompressFile)
+{
+    auto content = std::string{};
+    for (auto i = 0; i < 20000; ++i)
+        content += "[05/17/22 13:05:09] [I] Log line " + std::to_string(i % 100) + "\n";
+    ASSERT_TRUE(writeToFile(content));
+
+    const auto compressedFile = TEST_FILE + ".gz";
+    ASSERT_TRUE(FileSystemUtils::compressFile(TEST_FILE, compressedFile));
+    EXPECT_FALSE(FileSystemUtils::isFilePresent(compressedFile + ".part"));
+    EXPECT_LT(FileSystemUtils::getFileSize(compressedFile) * 10, content.size());
+
+    auto decompressed = std::string(content.size() + 1, '\0');
+    gzFile file = gzopen(compressedFile.c_str(), "rb");
+    ASSERT_NE(file, nullptr);
+    const auto size = gzread(file, &decompressed[0], static_cast<unsigned>(decompressed.size()));
+    gzclose(file);
+    std::remove(compressedFile.c_str());
+
+    ASSERT_EQ(size, static_cast<int>(content.size()));
+    decompressed.resize(content.size());
+    EXPECT_EQ(decompressed, content);
+}
+
+TEST_F(FileSystemUtilsTests, CompressFileDoesntExist)
+{
+    EXPECT_FALSE(FileSystemUtils::compressFile(TEST_FILE, TEST_FILE + ".gz"));
+    EXPECT_FALSE(FileSystemUtils::isFilePresent(TEST_FILE + ".gz"));
+}
+
 TEST_F(FileSystemUtilsTests, IsDirectoryPresent)
 {
     ASSERT_TRUE(createDir());
@@ -0,0 +1,69 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/utilities/Hasher.h"
+#include "core/utilities/Logger.h"
+
+#include <gtest/gtest.h>
+
+using namespace wolkabout;
+using namespace ::testing;
+
+class HasherTests : public ::testing::Test
+{
+public:
+    static void SetUpTestCase() { Logger::init(LogLevel::TRACE, Logger::Type::CONSOLE); }
+};
+
+TEST_F(HasherTests, SHA256SinglePiece)
+{
+    Hasher hasher{HashAlgorithm::SHA256};
+    hasher.update(ByteArray{65, 65, 65, 65, 65});
+    EXPECT_EQ(ByteUtils::toHexString(hasher.finalize()),
+              "11770b3ea657fe68cba19675143e4715c8de9d763d3c21a85af6b7513d43997d");
+}
+
+TEST_F(HasherTests, MD5SinglePiece)
+{
+    Hasher hasher{HashAlgorithm::MD5};
+    hasher.update(ByteArray{65, 65, 65, 65, 65});
+    EXPECT_EQ(ByteUtils::toHexString(hasher.finalize()), "f6a6263167c92de8644ac998b3c4e4d1");
+}
+
+TEST_F(HasherTests, MultiplePiecesMatchWholeHash)
+{
+    auto data = ByteArray(10000);
+    for (std::size_t i = 0; i < data.size(); ++i)
+        data[i] = static_cast<Byte>(i % 251);
+
+    for (const auto algorithm : {HashAlgorithm::MD5, HashAlgorithm::SHA256})
+    {
+        Hasher hasher{algorithm};
+        for (std::size_t offset = 0; offset < data.size(); offset += 777)
+            hasher.update(data.data() + offset, std::min<std::size_t>(777, data.size() - offset));
+        const auto expected =
+          algorithm == HashAlgorithm::MD5 ? ByteUtils::hashMDA5(data) : ByteUtils::hashSHA256(data);
+        EXPECT_EQ(hasher.finalize(), expected);
+    }
+}
+
+TEST_F(HasherTests, ReusableAfterFinalize)
+{
+    Hasher hasher{HashAlgorithm::MD5};
+    hasher.update(ByteArray{1, 2, 3});
+    hasher.finalize();
+    EXPECT_EQ(ByteUtils::toHexString(hasher.finalize()), "d41d8cd98f00b204e9800998ecf8427e");
+}
@@ -0,0 +1,137 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#define private public
+#define protected public
+#include "core/persistence/inmemory/InMemoryPersistence.h"
+#undef private
+#undef protected
+
+#include <gtest/gtest.h>
+
+using namespace wolkabout;
+using namespace ::testing;
+
+class InMemoryPersistenceTests : public ::testing::Test
+{
+public:
+    void SetUp() override { service = std::unique_ptr<InMemoryPersistence>{new InMemoryPersistence}; }
+
+    std::unique_ptr<InMemoryPersistence> service;
+};
+
+TEST_F(InMemoryPersistenceTests, ReadingsAreConsumedInOrder)
+{
+    EXPECT_TRUE(service->isEmpty());
+    for (std::uint64_t i = 0; i < 5; ++i)
+        ASSERT_TRUE(service->putReading("T", Reading{"T", i}));
+    EXPECT_FALSE(service->isEmpty());
+    EXPECT_EQ(service->getReadingsKeys(), std::vector<std::string>{"T"});
+
+    const auto readings = service->getReadings("T", 3);
+    ASSERT_EQ(readings.size(), 3);
+    EXPECT_EQ(readings.front()->getUIntValue(), 0);
+    EXPECT_EQ(readings.back()->getUIntValue(), 2);
+
+    service->removeReadings("T", 3);
+    auto values = std::vector<std::uint64_t>{};
+    const auto visited =
+      service->visitReadings("T", 10, [&](const Reading& reading) { values.push_back(reading.getUIntValue()); });
+    EXPECT_EQ(visited, 2);
+    EXPECT_EQ(values, (std::vector<std::uint64_t>{3, 4}));
+
+    service->removeReadings("T", 10);
+    EXPECT_TRUE(service->isEmpty());
+    EXPECT_TRUE(service->getReadingsKeys().empty());
+    EXPECT_TRUE(service->getReadings("U", 1).empty());
+}
+
+TEST_F(InMemoryPersistenceTests, VisitedReadingsAreNotCopied)
+{
+    ASSERT_TRUE(service->putReading("T", Reading{"T", std::uint64_t{1}}));
+
+    const Reading* first = nullptr;
+    const Reading* second = nullptr;
+    service->visitReadings("T", 1, [&](const Reading& reading) { first = &reading; });
+    service->visitReadings("T", 1, [&](const Reading& reading) { second = &reading; });
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(first, second);
+
+    // The readings handed out by getReadings are copies, that outlive their removal from the persistence
+    const auto readings = service->getReadings("T", 1);
+    ASSERT_EQ(readings.size(), 1);
+    EXPECT_NE(readings.front().get(), first);
+    service->removeReadings("T", 1);
+    EXPECT_EQ(readings.front()->getUIntValue(), 1);
+}
+
+TEST_F(InMemoryPersistenceTests, FullKeyDropsTheOldestReadings)
+{
+    service.reset(new InMemoryPersistence{2});
+    service->setReadingsCapacity("P", 3);
+    for (std::uint64_t i = 0; i < 5; ++i)
+    {
+        service->putReading("T", Reading{"T", i});
+        service->putReading("P", Reading{"P", i});
+    }
+
+    const auto temperatures = service->getReadings("T", 10);
+    ASSERT_EQ(temperatures.size(), 2);
+    EXPECT_EQ(temperatures.front()->getUIntValue(), 3);
+    const auto pressures = service->getReadings("P", 10);
+    ASSERT_EQ(pressures.size(), 3);
+    EXPECT_EQ(pressures.front()->getUIntValue(), 2);
+}
+
+TEST_F(InMemoryPersistenceTests, AttributeAndParameterKeys)
+{
+    service->putAttribute("A", std::make_shared<Attribute>("A", DataType::STRING, "V"));
+    service->putAttribute("B", std::make_shared<Attribute>("B", DataType::STRING, "V"));
+    service->putParameter("P", Parameter{ParameterName::EXTERNAL_ID, "ID"});
+
+    EXPECT_EQ(service->getAttributeKeys(), (std::vector<std::string>{"A", "B"}));
+    EXPECT_EQ(service->getParameterKeys(), std::vector<std::string>{"P"});
+    EXPECT_FALSE(service->isEmpty());
+}
+
+TEST_F(InMemoryPersistenceTests, ConcurrentPutAndRemove)
+{
+    const std::uint64_t count = 10000;
+    auto producer = std::thread{[&] {
+        for (std::uint64_t i = 0; i < count; ++i)
+            service->putReading("T", Reading{"T", i});
+    }};
+
+    auto consumed = std::uint64_t{0};
+    auto expected = std::uint64_t{0};
+    while (consumed < count)
+    {
+        const auto visited = service->visitReadings("T", 100, [&](const Reading& reading) {
+            EXPECT_EQ(reading.getUIntValue(), expected);
+            ++expected;
+        });
+        service->removeReadings("T", visited);
+        consumed += visited;
+    }
+    producer.join();
+
+    EXPECT_TRUE(service->isEmpty());
+}
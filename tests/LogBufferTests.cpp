@@ -0,0 +1,171 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fcntl.h>
+#include <mutex>
+#include <sstream>
+#include <unistd.h>
+
+#define private public
+#include "core/utilities/LogBuffer.h"
+#undef private
+
+#include <gtest/gtest.h>
+
+using namespace wolkabout;
+using namespace ::testing;
+
+class LogBufferTests : public ::testing::Test
+{
+public:
+    static Log makeLog(LogLevel level, int index)
+    {
+        auto log = Log{level};
+        log << "Log number " << index;
+        return log;
+    }
+
+    // Dumps the buffer into a pipe, and returns what came out of it
+    static std::string dump(const LogBuffer& buffer, bool* dumped = nullptr)
+    {
+        int descriptors[2];
+        if (pipe(descriptors) != 0)
+            return "";
+        fcntl(descriptors[0], F_SETFL, O_NONBLOCK);
+
+        const auto result = buffer.dump(descriptors[1]);
+        if (dumped != nullptr)
+            *dumped = result;
+        close(descriptors[1]);
+
+        auto output = std::string{};
+        char chunk[256];
+        for (auto size = read(descriptors[0], chunk, sizeof(chunk)); size > 0;
+             size = read(descriptors[0], chunk, sizeof(chunk)))
+            output.append(chunk, static_cast<std::size_t>(size));
+        close(descriptors[0]);
+        return output;
+    }
+
+    static bool endsWith(const std::string& line, const std::string& suffix)
+    {
+        return line.size() >= suffix.size() && line.compare(line.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+};
+
+TEST_F(LogBufferTests, FormatsLogsInOrder)
+{
+    LogBuffer buffer;
+    buffer.push(makeLog(LogLevel::INFO, 1));
+    buffer.push(makeLog(LogLevel::ERROR, 2));
+    buffer.push(makeLog(LogLevel::TRACE, 3));
+    ASSERT_EQ(buffer.size(), 3u);
+
+    const auto lines = buffer.format();
+    ASSERT_EQ(lines.size(), 3u);
+    EXPECT_TRUE(endsWith(lines[0], "] [I] Log number 1\n"));
+    EXPECT_TRUE(endsWith(lines[1], "] [E] Log number 2\n"));
+    EXPECT_TRUE(endsWith(lines[2], "] [T] Log number 3\n"));
+    EXPECT_EQ(lines[0].front(), '[');
+}
+
+TEST_F(LogBufferTests, FormatsTheTimestamp)
+{
+    std::tm time{};
+    time.tm_year = 122;
+    time.tm_mon = 4;
+    time.tm_mday = 17;
+    time.tm_hour = 13;
+    time.tm_min = 5;
+    time.tm_sec = 9;
+    time.tm_isdst = -1;
+
+    LogBuffer buffer;
+    buffer.push(makeLog(LogLevel::DEBUG, 1), std::chrono::system_clock::from_time_t(std::mktime(&time)));
+    const auto lines = buffer.format();
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_EQ(lines.front(), "[05/17/2022 13:05:09] [D] Log number 1\n");
+}
+
+TEST_F(LogBufferTests, OverwritesTheOldestLogs)
+{
+    LogBuffer buffer{256};
+    for (auto i = 0; i < 100; ++i)
+        buffer.push(makeLog(LogLevel::INFO, i));
+
+    const auto lines = buffer.format();
+    ASSERT_FALSE(lines.empty());
+    ASSERT_LT(lines.size(), 100u);
+    EXPECT_EQ(lines.size(), buffer.size());
+
+    // The newest logs are kept, and they are intact after wrapping around the end of the buffer
+    for (std::size_t i = 0; i < lines.size(); ++i)
+    {
+        const auto index = 100 - lines.size() + i;
+        EXPECT_TRUE(endsWith(lines[i], "] [I] Log number " + std::to_string(index) + "\n")) << lines[i];
+    }
+}
+
+TEST_F(LogBufferTests, DropsLogsLargerThanTheBuffer)
+{
+    LogBuffer buffer{32};
+    auto log = Log{LogLevel::INFO};
+    log << std::string(64, 'a');
+    buffer.push(log);
+    EXPECT_EQ(buffer.size(), 0u);
+    EXPECT_TRUE(buffer.format().empty());
+}
+
+TEST_F(LogBufferTests, DumpsTheLogsWithoutFormattingThem)
+{
+    LogBuffer buffer;
+    auto log = Log{LogLevel::WARN};
+    log << "Values " << -42 << ' ' << 7u << ' ' << 2.5 << ' ' << 0.1 << ' ' << -3.0 << ' ' << std::hex << 255;
+    buffer.push(log, std::chrono::system_clock::from_time_t(1652792709));
+    buffer.push(makeLog(LogLevel::ERROR, 2), std::chrono::system_clock::from_time_t(0));
+
+    EXPECT_EQ(dump(buffer), "[05/17/2022 13:05:09] [W] Values -42 7 2.5 0.1 -3 255\n"
+                            "[01/01/1970 00:00:00] [E] Log number 2\n");
+}
+
+TEST_F(LogBufferTests, DumpsTheLogsWrappedAroundTheEnd)
+{
+    LogBuffer buffer{256};
+    for (auto i = 0; i < 100; ++i)
+        buffer.push(makeLog(LogLevel::INFO, i));
+
+    // The times are written in different time zones, so only what follows them is compared
+    auto expected = std::string{};
+    for (const auto& line : buffer.format())
+        expected += line.substr(line.find(']'));
+
+    auto dumped = std::istringstream{dump(buffer)};
+    auto actual = std::string{};
+    for (auto line = std::string{}; std::getline(dumped, line);)
+        actual += line.substr(line.find(']')) + "\n";
+    EXPECT_EQ(actual, expected);
+}
+
+TEST_F(LogBufferTests, DumpSkipsTheBufferBeingWrittenInto)
+{
+    LogBuffer buffer;
+    buffer.push(makeLog(LogLevel::INFO, 1));
+
+    std::lock_guard<std::mutex> lock{buffer.m_mutex};
+    auto dumped = true;
+    EXPECT_EQ(dump(buffer, &dumped).find("Log number"), std::string::npos);
+    EXPECT_FALSE(dumped);
+}
@@ -0,0 +1,136 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/utilities/LogLimiter.h"
+
+#include <gtest/gtest.h>
+
+using namespace wolkabout;
+using namespace ::testing;
+
+class LogLimiterTests : public ::testing::Test
+{
+public:
+    static Log makeLog(LogLevel level, const std::string& message, int line = 10)
+    {
+        auto log = Log{level};
+        log.setSource(__FILE__, line);
+        log << message;
+        return log;
+    }
+
+    static std::vector<std::string> filter(LogLimiter& limiter, const Log& log,
+                                           std::chrono::steady_clock::time_point now)
+    {
+        auto messages = std::vector<std::string>{};
+        for (const auto& entry : limiter.filter(log, now))
+            messages.emplace_back(entry.getMessage());
+        return messages;
+    }
+
+    static std::vector<std::string> takeSummaries(LogLimiter& limiter, std::chrono::steady_clock::time_point now,
+                                                  bool all)
+    {
+        auto messages = std::vector<std::string>{};
+        for (const auto& entry : limiter.takeSummaries(now, all))
+            messages.emplace_back(entry.getMessage());
+        return messages;
+    }
+
+    LogLimiter limiter;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+};
+
+TEST_F(LogLimiterTests, PassesEverythingByDefault)
+{
+    for (auto i = 0; i < 10; ++i)
+        EXPECT_EQ(filter(limiter, makeLog(LogLevel::ERROR, "Failed to publish message"), start),
+                  std::vector<std::string>{"Failed to publish message"});
+}
+
+TEST_F(LogLimiterTests, DropsOffLogs)
+{
+    EXPECT_TRUE(limiter.filter(makeLog(LogLevel::OFF, "Hello"), start).empty());
+}
+
+TEST_F(LogLimiterTests, RateLimitPerCallSite)
+{
+    limiter.setRateLimit(LogLevel::ERROR, 2, std::chrono::milliseconds{1000});
+
+    EXPECT_EQ(filter(limiter, makeLog(LogLevel::ERROR, "First"), start).size(), 1u);
+    EXPECT_EQ(filter(limiter, makeLog(LogLevel::ERROR, "Second"), start).size(), 1u);
+    EXPECT_TRUE(filter(limiter, makeLog(LogLevel::ERROR, "Third"), start).empty());
+    EXPECT_TRUE(filter(limiter, makeLog(LogLevel::ERROR, "Fourth"), start).empty());
+
+    // Another call site and another level are not affected
+    EXPECT_EQ(filter(limiter, makeLog(LogLevel::ERROR, "Other site", 20), start).size(), 1u);
+    EXPECT_EQ(filter(limiter, makeLog(LogLevel::INFO, "Other level"), start).size(), 1u);
+
+    // Once the period passes, the amount of held back logs is reported
+    const auto messages =
+      filter(limiter, makeLog(LogLevel::ERROR, "Fifth"), start + std::chrono::milliseconds{1000});
+    ASSERT_EQ(messages.size(), 2u);
+    EXPECT_EQ(messages[0], std::string{"Suppressed 2 logs from "} + __FILE__ + ":10");
+    EXPECT_EQ(messages[1], "Fifth");
+}
+
+TEST_F(LogLimiterTests, SummariesAreTakenWithoutALaterLog)
+{
+    limiter.setRateLimit(LogLevel::ERROR, 1, std::chrono::milliseconds{1000});
+    limiter.setCollapseRepeated(LogLevel::INFO, true);
+
+    EXPECT_EQ(filter(limiter, makeLog(LogLevel::ERROR, "First"), start).size(), 1u);
+    EXPECT_TRUE(filter(limiter, makeLog(LogLevel::ERROR, "Second"), start).empty());
+    EXPECT_TRUE(filter(limiter, makeLog(LogLevel::ERROR, "Third"), start).empty());
+    EXPECT_EQ(filter(limiter, makeLog(LogLevel::INFO, "Connecting", 20), start).size(), 1u);
+    EXPECT_TRUE(filter(limiter, makeLog(LogLevel::INFO, "Connecting", 20), start).empty());
+
+    // The repeated logs are summarized right away, the suppressed ones once the period of their call site ends
+    EXPECT_EQ(takeSummaries(limiter, start, false), std::vector<std::string>{"Last message repeated 1 times"});
+    EXPECT_TRUE(takeSummaries(limiter, start + std::chrono::milliseconds{500}, false).empty());
+    EXPECT_EQ(takeSummaries(limiter, start + std::chrono::milliseconds{1000}, false),
+              std::vector<std::string>{std::string{"Suppressed 2 logs from "} + __FILE__ + ":10"});
+    EXPECT_TRUE(takeSummaries(limiter, start + std::chrono::milliseconds{1000}, false).empty());
+
+    // The call site starts a new period with its next log, and everything is summarized when asked for all
+    const auto next = start + std::chrono::milliseconds{1100};
+    EXPECT_EQ(filter(limiter, makeLog(LogLevel::ERROR, "Fourth"), next).size(), 1u);
+    EXPECT_TRUE(filter(limiter, makeLog(LogLevel::ERROR, "Fifth"), next).empty());
+    EXPECT_EQ(takeSummaries(limiter, next, true),
+              std::vector<std::string>{std::string{"Suppressed 1 logs from "} + __FILE__ + ":10"});
+}
+
+TEST_F(LogLimiterTests, CollapseRepeated)
+{
+    limiter.setCollapseRepeated(LogLevel::ERROR, true);
+
+    EXPECT_EQ(filter(limiter, makeLog(LogLevel::ERROR, "Failed to persist message"), start).size(), 1u);
+    for (auto i = 0; i < 5; ++i)
+        EXPECT_TRUE(filter(limiter, makeLog(LogLevel::ERROR, "Failed to persist message"), start).empty());
+
+    const auto messages = filter(limiter, makeLog(LogLevel::ERROR, "Reconnected"), start);
+    ASSERT_EQ(messages.size(), 2u);
+    EXPECT_EQ(messages[0], "Last message repeated 5 times");
+    EXPECT_EQ(messages[1], "Reconnected");
+}
+
+TEST_F(LogLimiterTests, CollapseOnlyConfiguredLevels)
+{
+    limiter.setCollapseRepeated(LogLevel::ERROR, true);
+
+    EXPECT_EQ(filter(limiter, makeLog(LogLevel::INFO, "Persisting message"), start).size(), 1u);
+    EXPECT_EQ(filter(limiter, makeLog(LogLevel::INFO, "Persisting message"), start).size(), 1u);
+}
@@ -15,6 +15,7 @@
  */
 
 #include <any>
+#include <fstream>
 #include <sstream>
 
 #define private public
@@ -23,15 +24,320 @@
 #undef private
 #undef protected
 
+#include "core/utilities/FileSystemUtils.h"
 #include "core/utilities/Logger.h"
+#include "tests/mocks/LogUploaderMock.h"
 
+#include <algorithm>
+#include <atomic>
 #include <gtest/gtest.h>
+#include <sys/inotify.h>
+#include <thread>
+#include <unistd.h>
+#include <utime.h>
 
 using namespace wolkabout;
 using namespace ::testing;
 
+namespace
+{
+class PrefixedLogUploaderMock : public LogUploaderMock
+{
+public:
+    std::string getRemoteName(const std::string& pathToLogFile) const override { return "DEVICE_KEY/" + pathToLogFile; }
+};
+}    // namespace
+
 class LogManagerTests : public ::testing::Test
 {
 public:
     static void SetUpTestCase() { Logger::init(LogLevel::TRACE, Logger::Type::CONSOLE); }
+
+    void SetUp() override { FileSystemUtils::createDirectory(TEST_DIR); }
+
+    void TearDown() override
+    {
+        for (const auto& file : FileSystemUtils::listFiles(TEST_DIR))
+            FileSystemUtils::deleteFile(FileSystemUtils::composePath(file, TEST_DIR));
+        rmdir(TEST_DIR.c_str());
+    }
+
+    void createLog(const std::string& name, std::size_t size, std::chrono::seconds age)
+    {
+        const auto path = FileSystemUtils::composePath(name, TEST_DIR);
+        ASSERT_TRUE(FileSystemUtils::createFileWithContent(path, std::string(size, 'a')));
+
+        const auto time = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now() - age);
+        struct utimbuf times
+        {
+            time, time
+        };
+        ASSERT_EQ(utime(path.c_str(), &times), 0);
+    }
+
+    static std::vector<std::string> sorted(std::vector<std::string> files)
+    {
+        std::sort(files.begin(), files.end());
+        return files;
+    }
+
+    const std::string TEST_DIR = "./logManagerTests";
 };
+
+TEST_F(LogManagerTests, CheckLogOverflowDeletesTheOldestLogs)
+{
+    for (auto i = 0; i < 5; ++i)
+        createLog("log" + std::to_string(i) + ".log", 100, std::chrono::seconds{10 - i});
+    createLog("other.txt", 1000, std::chrono::seconds{20});
+
+    LogManager logManager{TEST_DIR, ".log", 250};
+    EXPECT_EQ(logManager.getTotalLogSize(), 500u);
+
+    logManager.checkLogOverflow();
+    EXPECT_EQ(sorted(logManager.getLogFileNames()), (std::vector<std::string>{"log3.log", "log4.log"}));
+    EXPECT_EQ(logManager.getTotalLogSize(), 200u);
+    EXPECT_TRUE(FileSystemUtils::isFilePresent(FileSystemUtils::composePath("other.txt", TEST_DIR)));
+}
+
+TEST_F(LogManagerTests, GetLogsToDeleteUsesModificationTime)
+{
+    createLog("old.log", 10, std::chrono::hours{2});
+    createLog("new.log", 10, std::chrono::seconds{0});
+
+    LogManager logManager{TEST_DIR, ".log", 0, std::chrono::hours{1}, std::chrono::hours{1}};
+    EXPECT_EQ(logManager.getLogsToDelete(), std::vector<std::string>{"old.log"});
+}
+
+TEST_F(LogManagerTests, IndexFollowsDirectoryEvents)
+{
+    LogManager logManager{TEST_DIR, ".log", 0};
+    logManager.startWatching();
+    ASSERT_GE(logManager.m_inotifyDescriptor, 0);
+    ASSERT_NE(logManager.m_watcher, nullptr);
+    EXPECT_TRUE(logManager.getLogFileNames().empty());
+
+    // The watcher handles the events on its own, well before the periodic checks would
+    const auto waitForTotalSize = [&](std::uint64_t size) {
+        for (auto i = 0; i < 200 && logManager.getTotalLogSize() != size; ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        return logManager.getTotalLogSize();
+    };
+
+    createLog("first.log", 100, std::chrono::seconds{0});
+    createLog("ignored.txt", 100, std::chrono::seconds{0});
+    EXPECT_EQ(waitForTotalSize(100), 100u);
+    EXPECT_EQ(logManager.getLogFileNames(), std::vector<std::string>{"first.log"});
+
+    ASSERT_TRUE(FileSystemUtils::createFileWithContent(FileSystemUtils::composePath("first.log", TEST_DIR),
+                                                       std::string(150, 'b')));
+    EXPECT_EQ(waitForTotalSize(150), 150u);
+
+    ASSERT_TRUE(FileSystemUtils::deleteFile(FileSystemUtils::composePath("first.log", TEST_DIR)));
+    EXPECT_EQ(waitForTotalSize(0), 0u);
+    EXPECT_TRUE(logManager.getLogFileNames().empty());
+
+    logManager.stopWatching();
+    EXPECT_EQ(logManager.m_watcher, nullptr);
+    EXPECT_LT(logManager.m_inotifyDescriptor, 0);
+}
+
+TEST_F(LogManagerTests, FailedOverflowCheckWaitsForANewLog)
+{
+    for (auto i = 0; i < 3; ++i)
+        createLog("log" + std::to_string(i) + ".log", 100, std::chrono::seconds{10 - i});
+
+    LogManager logManager{TEST_DIR, ".log", 150};
+
+    // After a check that could not bring the logs under the limit, the writes into the logs are not checked
+    logManager.m_overflowUnfixed = true;
+    logManager.checkLogOverflowAfter(IN_MODIFY | IN_CLOSE_WRITE);
+    EXPECT_EQ(logManager.getTotalLogSize(), 300u);
+
+    logManager.checkLogOverflowAfter(IN_CREATE);
+    EXPECT_EQ(logManager.getLogFileNames(), std::vector<std::string>{"log2.log"});
+    EXPECT_FALSE(logManager.m_overflowUnfixed);
+
+    // The writes are checked again once the overflow was fixed
+    ASSERT_TRUE(FileSystemUtils::createFileWithContent(FileSystemUtils::composePath("log2.log", TEST_DIR),
+                                                       std::string(200, 'b')));
+    logManager.checkLogOverflowAfter(IN_MODIFY);
+    EXPECT_EQ(logManager.getTotalLogSize(), 0u);
+}
+
+TEST_F(LogManagerTests, CompressLogsKeepsTheActiveLog)
+{
+    createLog("first.log", 10000, std::chrono::hours{3});
+    createLog("second.log", 10000, std::chrono::hours{2});
+    createLog("active.log", 10000, std::chrono::seconds{0});
+
+    LogManager logManager{TEST_DIR, ".log", 0};
+    logManager.compressLogs();
+
+    EXPECT_EQ(sorted(logManager.getLogFileNames()),
+              (std::vector<std::string>{"active.log", "first.log.gz", "second.log.gz"}));
+    EXPECT_LT(logManager.getTotalLogSize(), 11000u);
+
+    // The compressed logs keep their age
+    const auto compressedLog = FileSystemUtils::composePath("first.log.gz", TEST_DIR);
+    const auto age = std::difftime(std::time(nullptr), FileSystemUtils::getLastModified(compressedLog));
+    EXPECT_GE(age, 3 * 3600 - 60);
+}
+
+TEST_F(LogManagerTests, CompressLogsKeepsTheLogsStillBeingWritten)
+{
+    createLog("rotated.log", 10000, std::chrono::hours{3});
+    createLog("open.log", 10000, std::chrono::hours{3});
+    createLog("recent.log", 10000, std::chrono::minutes{1});
+    createLog("active.log", 10000, std::chrono::seconds{0});
+
+    // A logger of this process is still writing into the log, even though it is older than the others
+    std::ofstream openLog{FileSystemUtils::composePath("open.log", TEST_DIR), std::ios::app};
+    ASSERT_TRUE(openLog.is_open());
+
+    LogManager logManager{TEST_DIR, ".log", 0};
+    logManager.compressLogs();
+
+    EXPECT_EQ(sorted(logManager.getLogFileNames()),
+              (std::vector<std::string>{"active.log", "open.log", "recent.log", "rotated.log.gz"}));
+}
+
+TEST_F(LogManagerTests, UploadListsRemoteLogsOnlyForUnknownLogs)
+{
+    createLog("first.log", 100, std::chrono::hours{3});
+    createLog("second.log", 100, std::chrono::hours{2});
+    createLog("third.log", 100, std::chrono::hours{2});
+    createLog("active.log", 100, std::chrono::seconds{0});
+
+    auto logUploader = std::make_shared<PrefixedLogUploaderMock>();
+    LogManager logManager{TEST_DIR, ".log", 0, std::chrono::hours(0), std::chrono::hours(0), std::chrono::hours(1),
+                          std::chrono::hours(1), logUploader};
+
+    // The first log is already in the bucket, under the prefix of this device. The third one is there too, but its
+    // upload was cut short, and the second one was only uploaded by another device.
+    EXPECT_CALL(*logUploader, getRemoteLogSizes("DEVICE_KEY/" + TEST_DIR + "/"))
+      .WillOnce(Return(LogUploaderMock::RemoteLogSizes{{"DEVICE_KEY/" + TEST_DIR + "/first.log", 100},
+                                                       {"DEVICE_KEY/" + TEST_DIR + "/third.log", 50}}));
+    EXPECT_CALL(*logUploader, upload(FileSystemUtils::composePath("second.log", TEST_DIR))).WillOnce(Return(true));
+    EXPECT_CALL(*logUploader, upload(FileSystemUtils::composePath("third.log", TEST_DIR))).WillOnce(Return(true));
+    logManager.uploadLogs();
+
+    // Now the manifest knows about both logs, so the bucket is not listed again
+    EXPECT_CALL(*logUploader, getRemoteLogSizes(_)).Times(0);
+    EXPECT_CALL(*logUploader, upload(_)).Times(0);
+    logManager.uploadLogs();
+
+    // The manifest is not one of the logs
+    EXPECT_EQ(sorted(logManager.getLogFileNames()),
+              (std::vector<std::string>{"active.log", "first.log", "second.log", "third.log"}));
+}
+
+TEST_F(LogManagerTests, UploadManifestIsKeptBetweenRuns)
+{
+    createLog("first.log", 100, std::chrono::hours{3});
+
+    auto logUploader = std::make_shared<LogUploaderMock>();
+    {
+        LogManager logManager{TEST_DIR, ".log", 0, std::chrono::hours(0), std::chrono::hours(0), std::chrono::hours(1),
+                              std::chrono::hours(1), logUploader};
+        EXPECT_CALL(*logUploader, getRemoteLogSizes(_)).WillOnce(Return(LogUploaderMock::RemoteLogSizes{}));
+        EXPECT_CALL(*logUploader, upload(_)).WillOnce(Return(true));
+        logManager.uploadLogs();
+    }
+    Mock::VerifyAndClearExpectations(logUploader.get());
+
+    // A log that only had its modification time changed is recognized by its hash
+    createLog("first.log", 100, std::chrono::hours{4});
+    LogManager logManager{TEST_DIR, ".log", 0, std::chrono::hours(0), std::chrono::hours(0), std::chrono::hours(1),
+                          std::chrono::hours(1), logUploader};
+    EXPECT_CALL(*logUploader, getRemoteLogSizes(_)).Times(0);
+    EXPECT_CALL(*logUploader, upload(_)).Times(0);
+    logManager.uploadLogs();
+
+    // A log with a different content is uploaded again
+    createLog("first.log", 200, std::chrono::hours{4});
+    EXPECT_CALL(*logUploader, upload(FileSystemUtils::composePath("first.log", TEST_DIR))).WillOnce(Return(true));
+    logManager.uploadLogs();
+}
+
+TEST_F(LogManagerTests, UploadStartsWithTheNewestLogs)
+{
+    createLog("oldest.log", 100, std::chrono::hours{4});
+    createLog("newest.log", 100, std::chrono::hours{2});
+    createLog("older.log", 100, std::chrono::hours{3});
+
+    auto logUploader = std::make_shared<NiceMock<LogUploaderMock>>();
+    LogManager logManager{TEST_DIR, ".log", 0, std::chrono::hours(0), std::chrono::hours(0), std::chrono::hours(1),
+                          std::chrono::hours(1), logUploader};
+
+    ON_CALL(*logUploader, getRemoteLogSizes(_)).WillByDefault(Return(LogUploaderMock::RemoteLogSizes{}));
+    InSequence sequence;
+    EXPECT_CALL(*logUploader, upload(FileSystemUtils::composePath("newest.log", TEST_DIR))).WillOnce(Return(true));
+    EXPECT_CALL(*logUploader, upload(FileSystemUtils::composePath("older.log", TEST_DIR))).WillOnce(Return(true));
+    EXPECT_CALL(*logUploader, upload(FileSystemUtils::composePath("oldest.log", TEST_DIR))).WillOnce(Return(true));
+    logManager.uploadLogs();
+}
+
+TEST_F(LogManagerTests, UploadWaitsWhilePaused)
+{
+    createLog("first.log", 100, std::chrono::hours{3});
+
+    auto logUploader = std::make_shared<NiceMock<LogUploaderMock>>();
+    LogManager logManager{TEST_DIR, ".log", 0, std::chrono::hours(0), std::chrono::hours(0), std::chrono::hours(1),
+                          std::chrono::hours(1), logUploader};
+    ON_CALL(*logUploader, getRemoteLogSizes(_)).WillByDefault(Return(LogUploaderMock::RemoteLogSizes{}));
+
+    std::atomic_bool paused{true};
+    std::atomic_bool uploaded{false};
+    logManager.setUploadPaused([&] { return paused.load(); });
+    EXPECT_CALL(*logUploader, upload(_)).WillOnce(DoAll(Assign(&uploaded, true), Return(true)));
+
+    std::thread uploader{[&] { logManager.uploadLogs(); }};
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_FALSE(uploaded);
+
+    paused = false;
+    uploader.join();
+    EXPECT_TRUE(uploaded);
+}
+
+TEST_F(LogManagerTests, UploadIsNotInterruptedForever)
+{
+    createLog("first.log", 100, std::chrono::hours{3});
+
+    auto logUploader = std::make_shared<NiceMock<LogUploaderMock>>();
+    LogManager logManager{TEST_DIR, ".log", 0, std::chrono::hours(0), std::chrono::hours(0), std::chrono::hours(1),
+                          std::chrono::hours(1), logUploader};
+    ON_CALL(*logUploader, getRemoteLogSizes(_)).WillByDefault(Return(LogUploaderMock::RemoteLogSizes{}));
+
+    // Every attempt brings a pause with it, that is over as soon as it is noticed
+    std::atomic_bool paused{false};
+    logManager.setUploadPaused([&] { return paused.exchange(false); });
+    InSequence sequence;
+    EXPECT_CALL(*logUploader, upload(_)).Times(4).WillRepeatedly(DoAll(Assign(&paused, true), Return(false)));
+    EXPECT_CALL(*logUploader, upload(_)).WillOnce(DoAll(Assign(&paused, true), Return(true)));
+
+    // The interrupted attempts are spaced out
+    const auto started = std::chrono::steady_clock::now();
+    logManager.uploadLogs();
+    EXPECT_GE(std::chrono::steady_clock::now() - started, std::chrono::milliseconds(1740));
+}
+
+TEST_F(LogManagerTests, UploadKeepsToTheBandwidth)
+{
+    createLog("first.log", 1000, std::chrono::hours{3});
+    createLog("second.log", 1000, std::chrono::hours{2});
+
+    auto logUploader = std::make_shared<NiceMock<LogUploaderMock>>();
+    LogManager logManager{TEST_DIR, ".log", 0, std::chrono::hours(0), std::chrono::hours(0), std::chrono::hours(1),
+                          std::chrono::hours(1), logUploader};
+    ON_CALL(*logUploader, getRemoteLogSizes(_)).WillByDefault(Return(LogUploaderMock::RemoteLogSizes{}));
+    ON_CALL(*logUploader, upload(_)).WillByDefault(Return(true));
+
+    // Two logs of 1000 bytes take at least 200ms at 10000 bytes per second
+    EXPECT_CALL(*logUploader, setBandwidthLimit(10000)).Times(AtLeast(1));
+    logManager.setUploadBandwidth(10000);
+
+    const auto started = std::chrono::steady_clock::now();
+    logManager.uploadLogs();
+    EXPECT_GE(std::chrono::steady_clock::now() - started, std::chrono::milliseconds(190));
+}
@@ -15,19 +15,92 @@
  */
 
 #include <any>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <mutex>
 #include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
 
 #define private public
 #define protected public
+#include "core/utilities/LogBuffer.h"
 #include "core/utilities/Logger.h"
 #undef private
 #undef protected
 
 #include <gtest/gtest.h>
+#include <spdlog/sinks/base_sink.h>
+#include <spdlog/sinks/ostream_sink.h>
+#include <spdlog/spdlog.h>
 
 using namespace wolkabout;
 using namespace ::testing;
 
+namespace
+{
+class SlowSink : public spdlog::sinks::base_sink<std::mutex>
+{
+public:
+    std::vector<std::string> lines()
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        return m_lines;
+    }
+
+    // The flush is queued behind the logs, so once it arrives, the logs before it were all written
+    std::vector<std::string> linesOnceFlushed()
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+        m_flushCondition.wait_for(lock, std::chrono::seconds{5}, [this] { return m_flushed; });
+        return m_lines;
+    }
+
+protected:
+    void sink_it_(const spdlog::details::log_msg& message) override
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds{200});
+        m_lines.emplace_back(message.payload.data(), message.payload.size());
+    }
+
+    void flush_() override
+    {
+        m_flushed = true;
+        m_flushCondition.notify_all();
+    }
+
+private:
+    std::vector<std::string> m_lines;
+    bool m_flushed = false;
+    std::condition_variable m_flushCondition;
+};
+
+class SlowErrorSink : public spdlog::sinks::base_sink<std::mutex>
+{
+protected:
+    void sink_it_(const spdlog::details::log_msg& message) override
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        std::cerr << std::string(message.payload.data(), message.payload.size()) << std::endl;
+    }
+
+    void flush_() override {}
+};
+
+bool previousHandlerCalled = false;
+
+void previousHandler(int /* signal */, siginfo_t* /* info */, void* /* context */)
+{
+    previousHandlerCalled = true;
+}
+}    // namespace
+
 class LoggerTests : public ::testing::Test
 {
 public:
@@ -52,3 +125,287 @@ TEST_F(LoggerTests, LogLevelTest)
     for (const auto& pair : map)
         EXPECT_EQ(from_string(pair.second), pair.first);
 }
+
+TEST_F(LoggerTests, IsEnabledFollowsLevel)
+{
+    const auto previousLevel = Logger::getLevel();
+
+    Logger::setLevel(LogLevel::INFO);
+    EXPECT_FALSE(Logger::isEnabled(LogLevel::TRACE));
+    EXPECT_FALSE(Logger::isEnabled(LogLevel::DEBUG));
+    EXPECT_TRUE(Logger::isEnabled(LogLevel::INFO));
+    EXPECT_TRUE(Logger::isEnabled(LogLevel::ERROR));
+    EXPECT_FALSE(Logger::isEnabled(LogLevel::OFF));
+
+    Logger::setLevel(LogLevel::OFF);
+    EXPECT_FALSE(Logger::isEnabled(LogLevel::ERROR));
+
+    Logger::setLevel(previousLevel);
+}
+
+TEST_F(LoggerTests, SetLevelReachesTheOutputs)
+{
+    const auto previousLevel = Logger::getLevel();
+
+    Logger::setLevel(LogLevel::ERROR);
+    EXPECT_EQ(spdlog::default_logger_raw()->level(), spdlog::level::err);
+
+    Logger::setLevel(LogLevel::TRACE);
+    EXPECT_EQ(spdlog::default_logger_raw()->level(), spdlog::level::trace);
+
+    Logger::setLevel(previousLevel);
+}
+
+TEST_F(LoggerTests, DisabledLogIsNotFormatted)
+{
+    const auto previousLevel = Logger::getLevel();
+    Logger::setLevel(LogLevel::INFO);
+
+    auto evaluated = 0;
+    auto evaluate = [&]() -> int { return ++evaluated; };
+    LOG(TRACE) << "This is not formatted " << evaluate();
+    LOG(DEBUG) << "Neither is this " << evaluate();
+    EXPECT_EQ(evaluated, 0);
+
+    LOG(INFO, false) << "This is formatted, but not logged " << evaluate();
+    EXPECT_EQ(evaluated, 1);
+
+    Logger::setLevel(previousLevel);
+}
+
+TEST_F(LoggerTests, LogWorksAsSingleStatement)
+{
+    auto evaluated = false;
+    if (evaluated)
+        LOG(TRACE) << "Unreachable";
+    else
+        evaluated = true;
+    EXPECT_TRUE(evaluated);
+}
+
+TEST_F(LoggerTests, AsyncLoggerWritesEverythingWhenBlocking)
+{
+    auto sink = std::make_shared<SlowSink>();
+    Logger asyncLogger;
+    asyncLogger.enableAsync(4, Logger::OverflowPolicy::BLOCK);
+    asyncLogger.m_consoleLogger = asyncLogger.createLogger("asyncBlockingTestLogger", sink);
+    asyncLogger.m_consoleLogger->set_pattern("%v");
+    asyncLogger.m_consoleLogger->flush_on(spdlog::level::off);
+
+    // The sink is far slower than the logs are made, so the queue is full for most of them
+    for (auto i = 0; i < 100; ++i)
+    {
+        auto log = Log{LogLevel::ERROR};
+        log << i;
+        asyncLogger += log;
+    }
+    asyncLogger.flush();
+
+    // Counted before the logger is destroyed, as that writes out whatever is still queued
+    const auto lines = sink->linesOnceFlushed();
+    ASSERT_EQ(lines.size(), 100u);
+    for (auto i = 0; i < 100; ++i)
+        EXPECT_EQ(lines[static_cast<std::size_t>(i)], std::to_string(i));
+    EXPECT_EQ(asyncLogger.droppedLogs(), 0u);
+    spdlog::drop("asyncBlockingTestLogger");
+}
+
+TEST_F(LoggerTests, AsyncFlushWaitsForTheQueuedLogs)
+{
+    auto sink = std::make_shared<SlowSink>();
+    Logger asyncLogger;
+    asyncLogger.enableAsync(Logger::ASYNC_QUEUE_SIZE, Logger::OverflowPolicy::BLOCK);
+    asyncLogger.m_consoleLogger = asyncLogger.createLogger("asyncFlushingTestLogger", sink);
+    asyncLogger.m_consoleLogger->set_pattern("%v");
+    asyncLogger.m_consoleLogger->flush_on(spdlog::level::off);
+
+    for (auto i = 0; i < 100; ++i)
+    {
+        auto log = Log{LogLevel::ERROR};
+        log << i;
+        asyncLogger += log;
+    }
+
+    // The logs are all written once the flush returns, without waiting on the sink
+    asyncLogger.flush();
+    EXPECT_EQ(sink->lines().size(), 100u);
+    spdlog::drop("asyncFlushingTestLogger");
+}
+
+TEST_F(LoggerTests, TerminateWritesOutTheQueuedLogs)
+{
+    EXPECT_DEATH(
+      {
+          Logger::getInstance().enableAsync(Logger::ASYNC_QUEUE_SIZE, Logger::OverflowPolicy::BLOCK);
+          Logger::getInstance().m_consoleLogger =
+            Logger::getInstance().createLogger("terminateTestLogger", std::make_shared<SlowErrorSink>());
+          Logger::getInstance().m_consoleLogger->set_pattern("%v");
+          Logger::installCrashHandler();
+
+          for (auto i = 0; i < 100; ++i)
+          {
+              auto log = Log{LogLevel::ERROR};
+              log << "Queued log " << i;
+              Logger::getInstance() += log;
+          }
+          std::terminate();
+      },
+      "Queued log 99");
+}
+
+TEST_F(LoggerTests, CrashHandlerHandsTheSignalToThePreviousHandler)
+{
+    struct sigaction original = {};
+    struct sigaction previous = {};
+    previous.sa_sigaction = &previousHandler;
+    previous.sa_flags = SA_SIGINFO;
+    sigemptyset(&previous.sa_mask);
+    ASSERT_EQ(sigaction(SIGFPE, &previous, &original), 0);
+    const auto originalTerminate = std::get_terminate();
+
+    // Installing the handler twice still leaves the previous handler to be called
+    Logger::installCrashHandler();
+    Logger::installCrashHandler();
+    previousHandlerCalled = false;
+    std::raise(SIGFPE);
+    EXPECT_TRUE(previousHandlerCalled);
+
+    // The previous handler is put back once the signal was handed to it
+    struct sigaction current = {};
+    ASSERT_EQ(sigaction(SIGFPE, nullptr, &current), 0);
+    EXPECT_EQ(current.sa_sigaction, &previousHandler);
+
+    sigaction(SIGFPE, &original, nullptr);
+    for (const auto signal : {SIGSEGV, SIGABRT, SIGILL, SIGBUS})
+        std::signal(signal, SIG_DFL);
+    std::set_terminate(originalTerminate);
+}
+
+TEST_F(LoggerTests, AsyncLoggerCountsDroppedLogs)
+{
+    auto stream = std::make_shared<std::ostringstream>();
+    auto dropped = std::size_t{0};
+    {
+        Logger asyncLogger;
+        asyncLogger.enableAsync(2, Logger::OverflowPolicy::DROP);
+        asyncLogger.m_consoleLogger = asyncLogger.createLogger(
+          "asyncDroppingTestLogger", std::make_shared<spdlog::sinks::ostream_sink_mt>(*stream));
+        asyncLogger.m_consoleLogger->set_pattern("%v");
+
+        for (auto i = 0; i < 1000; ++i)
+        {
+            auto log = Log{LogLevel::ERROR};
+            log << i;
+            asyncLogger += log;
+        }
+        dropped = asyncLogger.droppedLogs();
+    }
+    spdlog::drop("asyncDroppingTestLogger");
+
+    auto lines = std::size_t{0};
+    auto line = std::string{};
+    auto input = std::istringstream{stream->str()};
+    while (std::getline(input, line))
+        ++lines;
+    EXPECT_EQ(lines + dropped, 1000u);
+}
+
+TEST_F(LoggerTests, LogFormatsLikeAStream)
+{
+    enum Unscoped
+    {
+        FIRST = 7
+    };
+    const char* nullString = nullptr;
+
+    auto log = Log{LogLevel::INFO};
+    log << 'c' << static_cast<std::uint8_t>('u') << static_cast<std::int16_t>(-12) << -1234567890123LL << 42u
+        << std::numeric_limits<std::uint64_t>::max() << 3.14159265 << 2.5f << true << " literal "
+        << std::string{"string"} << nullString << std::hex << 255 << std::dec << 255 << FIRST;
+
+    std::ostringstream expected;
+    expected << 'c' << static_cast<std::uint8_t>('u') << static_cast<std::int16_t>(-12) << -1234567890123LL << 42u
+             << std::numeric_limits<std::uint64_t>::max() << 3.14159265 << 2.5f << true << " literal "
+             << std::string{"string"} << "" << std::hex << 255 << std::dec << 255 << FIRST;
+    EXPECT_EQ(log.getMessage(), expected.str());
+}
+
+TEST_F(LoggerTests, LogKeepsTheStreamState)
+{
+    auto log = Log{LogLevel::INFO};
+    log << std::setw(5) << 42 << '|' << std::setfill('0') << std::setw(4) << 7 << '|' << 7 << '|'
+        << std::setprecision(3) << 3.14159 << '|' << std::fixed << 2.5 << '|' << std::boolalpha << true << false;
+
+    std::ostringstream expected;
+    expected << std::setw(5) << 42 << '|' << std::setfill('0') << std::setw(4) << 7 << '|' << 7 << '|'
+             << std::setprecision(3) << 3.14159 << '|' << std::fixed << 2.5 << '|' << std::boolalpha << true << false;
+    EXPECT_EQ(log.getMessage(), expected.str());
+    EXPECT_EQ(log.getMessage(), "   42|0007|7|3.14|2.500|truefalse");
+}
+
+TEST_F(LoggerTests, BufferKeepsLogs)
+{
+    logger.m_buffer = std::make_shared<LogBuffer>();
+
+    auto log = Log{LogLevel::INFO};
+    log << "Hello World!";
+    logger += log;
+
+    const auto lines = logger.buffer();
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_NE(lines.front().find("[I] Hello World!"), std::string::npos);
+}
+
+TEST_F(LoggerTests, LimiterCollapsesRepeatedLogs)
+{
+    logger.m_buffer = std::make_shared<LogBuffer>();
+    logger.setCollapseRepeated(LogLevel::ERROR, true);
+
+    for (auto i = 0; i < 3; ++i)
+    {
+        auto log = Log{LogLevel::ERROR};
+        log << "Failed to publish message";
+        logger += log;
+    }
+    auto log = Log{LogLevel::ERROR};
+    log << "Connected";
+    logger += log;
+
+    const auto lines = logger.buffer();
+    ASSERT_EQ(lines.size(), 3u);
+    EXPECT_NE(lines[0].find("Failed to publish message"), std::string::npos);
+    EXPECT_NE(lines[1].find("Last message repeated 2 times"), std::string::npos);
+    EXPECT_NE(lines[2].find("Connected"), std::string::npos);
+}
+
+TEST_F(LoggerTests, LimiterSummariesAreWrittenWhenTheLogsStop)
+{
+    logger.m_buffer = std::make_shared<LogBuffer>();
+    logger.setCollapseRepeated(LogLevel::ERROR, true);
+
+    for (auto i = 0; i < 3; ++i)
+    {
+        auto log = Log{LogLevel::ERROR};
+        log << "Failed to publish message";
+        logger += log;
+    }
+
+    // Nothing else is logged, so the summary is written by the limiter timer
+    auto lines = logger.buffer();
+    for (auto i = 0; i < 300 && lines.size() < 2; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        lines = logger.buffer();
+    }
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_NE(lines[1].find("Last message repeated 2 times"), std::string::npos);
+
+    // And flushing writes out the rest right away
+    auto log = Log{LogLevel::ERROR};
+    log << "Failed to publish message";
+    logger += log;
+    logger.flush();
+    lines = logger.buffer();
+    ASSERT_EQ(lines.size(), 3u);
+    EXPECT_NE(lines[2].find("Last message repeated 1 times"), std::string::npos);
+}
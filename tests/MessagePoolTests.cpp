@@ -0,0 +1,127 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define private public
+#define protected public
+#include "core/model/MessagePool.h"
+#undef private
+#undef protected
+
+#include <gtest/gtest.h>
+
+using namespace wolkabout;
+using namespace ::testing;
+
+class MessagePoolTests : public ::testing::Test
+{
+public:
+    static Counter& misses()
+    {
+        return MetricsRegistry::getInstance().counter("wolkabout_message_pool_misses_total", "");
+    }
+};
+
+TEST_F(MessagePoolTests, SlotIsTakenWhileTheMessageIsOwned)
+{
+    MessagePool pool{2};
+    EXPECT_EQ(pool.capacity(), 2);
+    EXPECT_EQ(pool.available(), 2);
+
+    auto message = pool.acquire("{}", "d2p/KEY/feed_values");
+    ASSERT_NE(message, nullptr);
+    EXPECT_EQ(message->getContent(), "{}");
+    EXPECT_EQ(message->getChannel(), "d2p/KEY/feed_values");
+    EXPECT_EQ(pool.available(), 1);
+
+    auto copy = message;
+    message.reset();
+    EXPECT_EQ(pool.available(), 1);
+
+    copy.reset();
+    EXPECT_EQ(pool.available(), 2);
+}
+
+TEST_F(MessagePoolTests, SlotKeepsItsBuffers)
+{
+    MessagePool pool{1, 256};
+
+    auto message = pool.acquire(std::string(200, 'a'), "d2p/KEY/feed_values");
+    const auto* pooled = message.get();
+    const auto* content = message->getContent().data();
+    message.reset();
+
+    message = pool.acquire("[]", "d2p/KEY/feed_values");
+    EXPECT_EQ(message.get(), pooled);
+    EXPECT_EQ(message->getContent().data(), content);
+    EXPECT_EQ(message->getContent(), "[]");
+    EXPECT_GE(message->getContent().capacity(), 256);
+}
+
+TEST_F(MessagePoolTests, EmptyPoolAllocatesTheMessages)
+{
+    MessagePool pool{1};
+    const auto missesBefore = misses().value();
+
+    const auto first = pool.acquire("1", "topic");
+    const auto second = pool.acquire("2", "topic");
+    ASSERT_NE(second, nullptr);
+    EXPECT_EQ(second->getContent(), "2");
+    EXPECT_EQ(pool.available(), 0);
+    EXPECT_EQ(misses().value(), missesBefore + 1);
+}
+
+TEST_F(MessagePoolTests, FailedWriteGivesTheSlotBack)
+{
+    MessagePool pool{1};
+    EXPECT_THROW(pool.acquire([](std::string&, std::string&) { throw std::runtime_error{"Failed to serialize"}; }),
+                 std::runtime_error);
+    EXPECT_EQ(pool.available(), 1);
+}
+
+TEST_F(MessagePoolTests, MessagesOutliveThePool)
+{
+    auto pool = std::unique_ptr<MessagePool>{new MessagePool{1}};
+    const auto message = pool->acquire("{}", "topic");
+    pool.reset();
+
+    EXPECT_EQ(message->getContent(), "{}");
+}
+
+TEST_F(MessagePoolTests, SlotsAreSharedBetweenThreads)
+{
+    MessagePool pool{8};
+
+    auto threads = std::vector<std::thread>{};
+    for (auto i = 0; i < 4; ++i)
+        threads.emplace_back([&pool, i] {
+            for (auto j = 0; j < 10000; ++j)
+            {
+                const auto content = std::to_string(i);
+                const auto message = pool.acquire(content, "topic");
+                ASSERT_EQ(message->getContent(), content);
+            }
+        });
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(pool.available(), 8);
+}
@@ -0,0 +1,176 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#define private public
+#define protected public
+#include "core/connectivity/MessageTracer.h"
+#undef private
+#undef protected
+
+#include "core/connectivity/mqtt/MqttConnectivityService.h"
+#include "core/model/Message.h"
+#include "core/model/MessagePool.h"
+
+#include <gtest/gtest.h>
+
+using namespace wolkabout;
+using namespace ::testing;
+
+namespace
+{
+class ConnectedMqttClient : public MqttClient
+{
+public:
+    bool connect(const std::string&, const std::string&, const std::string&, const std::string&) override
+    {
+        return true;
+    }
+    void disconnect() override {}
+    bool isConnected() override { return true; }
+    bool subscribe(const std::string&) override { return true; }
+    bool publish(const std::string&, const std::string&, bool) override
+    {
+        ++published;
+        return true;
+    }
+
+    std::atomic<int> published{0};
+};
+}    // namespace
+
+class MessageTracerTests : public ::testing::Test
+{
+public:
+    void TearDown() override { MessageTracer::disable(); }
+
+    static std::vector<TraceStage> stages(const std::vector<TraceEvent>& events, std::uint64_t messageId)
+    {
+        auto stages = std::vector<TraceStage>{};
+        for (const auto& event : events)
+        {
+            if (event.messageId == messageId)
+                stages.emplace_back(event.stage);
+        }
+        return stages;
+    }
+};
+
+TEST_F(MessageTracerTests, NothingIsRecordedWhileDisabled)
+{
+    MessageTracer::enable(16);
+    MessageTracer::disable();
+
+    const auto message = wolkabout::Message{"", "d2p/KEY/feed_values"};
+    MessageTracer::trace(message, TraceStage::ENQUEUED);
+    EXPECT_TRUE(MessageTracer::getInstance().getEvents().empty());
+}
+
+TEST_F(MessageTracerTests, RingKeepsTheLatestEvents)
+{
+    MessageTracer::enable(3);
+
+    const auto message = wolkabout::Message{"", "d2p/KEY/feed_values"};
+    MessageTracer::trace(message, TraceStage::ENQUEUED);
+    MessageTracer::trace(message, TraceStage::DEQUEUED);
+    MessageTracer::trace(message, TraceStage::PUBLISH_STARTED);
+    MessageTracer::trace(message, TraceStage::ACKNOWLEDGED);
+
+    const auto events = MessageTracer::getInstance().getEvents();
+    EXPECT_EQ(stages(events, message.getId()),
+              (std::vector<TraceStage>{TraceStage::DEQUEUED, TraceStage::PUBLISH_STARTED, TraceStage::ACKNOWLEDGED}));
+    EXPECT_LE(events.front().timestamp, events.back().timestamp);
+
+    MessageTracer::enable(3);
+    EXPECT_TRUE(MessageTracer::getInstance().getEvents().empty());
+}
+
+TEST_F(MessageTracerTests, ServiceTracesThePublishedMessages)
+{
+    MessageTracer::enable();
+    auto client = std::make_shared<ConnectedMqttClient>();
+    auto service = std::unique_ptr<MqttConnectivityService>{
+      new MqttConnectivityService{client, "KEY", "", "", "", "KEY"}};
+    ASSERT_TRUE(service->connect());
+
+    const auto message = std::make_shared<wolkabout::Message>("[]", "d2p/KEY/feed_values");
+    service->addMessage(message);
+    for (auto i = 0; i < 100 && client->published == 0; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    ASSERT_EQ(client->published, 1);
+    service.reset();
+
+    EXPECT_EQ(stages(MessageTracer::getInstance().getEvents(), message->getId()),
+              (std::vector<TraceStage>{TraceStage::ENQUEUED, TraceStage::DEQUEUED, TraceStage::PUBLISH_STARTED,
+                                       TraceStage::ACKNOWLEDGED}));
+}
+
+TEST_F(MessageTracerTests, PooledMessagesAreTracedApart)
+{
+    MessageTracer::enable(16);
+    MessagePool pool{1};
+
+    auto message = pool.acquire("1", "d2p/KEY/feed_values");
+    const auto firstId = message->getId();
+    MessageTracer::trace(*message, TraceStage::ENQUEUED);
+    MessageTracer::trace(*message, TraceStage::ACKNOWLEDGED);
+    message.reset();
+
+    // The second message is made out of the same slot, at the same address
+    message = pool.acquire("2", "d2p/KEY/feed_values");
+    ASSERT_NE(message->getId(), firstId);
+    MessageTracer::trace(*message, TraceStage::ENQUEUED);
+
+    const auto events = MessageTracer::getInstance().getEvents();
+    EXPECT_EQ(stages(events, firstId), (std::vector<TraceStage>{TraceStage::ENQUEUED, TraceStage::ACKNOWLEDGED}));
+    EXPECT_EQ(stages(events, message->getId()), (std::vector<TraceStage>{TraceStage::ENQUEUED}));
+}
+
+TEST_F(MessageTracerTests, ChromeTraceSpansTheIntervalsOfEachMessage)
+{
+    const auto events = std::vector<TraceEvent>{{0x10, TraceStage::ENQUEUED, 1, 1},
+                                                {0x10, TraceStage::DEQUEUED, 5, 2},
+                                                {0x10, TraceStage::PUBLISH_STARTED, 6, 2},
+                                                {0x10, TraceStage::ACKNOWLEDGED, 9, 2},
+                                                // The message is published out of the persistence after a restart
+                                                {0x10, TraceStage::ENQUEUED, 12, 1}};
+
+    EXPECT_EQ(MessageTracer::toChromeTrace(events),
+              "{\"displayTimeUnit\":\"ms\",\"traceEvents\":["
+              "{\"name\":\"enqueued\",\"cat\":\"message\",\"ph\":\"n\",\"id\":\"0x10\",\"ts\":1,\"pid\":1,\"tid\":1},"
+              "{\"name\":\"buffered\",\"cat\":\"message\",\"ph\":\"b\",\"id\":\"0x10\",\"ts\":1,\"pid\":1,\"tid\":1},"
+              "{\"name\":\"buffered\",\"cat\":\"message\",\"ph\":\"e\",\"id\":\"0x10\",\"ts\":5,\"pid\":1,\"tid\":2},"
+              "{\"name\":\"dequeued\",\"cat\":\"message\",\"ph\":\"n\",\"id\":\"0x10\",\"ts\":5,\"pid\":1,\"tid\":2},"
+              "{\"name\":\"dispatching\",\"cat\":\"message\",\"ph\":\"b\",\"id\":\"0x10\",\"ts\":5,\"pid\":1,"
+              "\"tid\":2},"
+              "{\"name\":\"dispatching\",\"cat\":\"message\",\"ph\":\"e\",\"id\":\"0x10\",\"ts\":6,\"pid\":1,"
+              "\"tid\":2},"
+              "{\"name\":\"publish_started\",\"cat\":\"message\",\"ph\":\"n\",\"id\":\"0x10\",\"ts\":6,\"pid\":1,"
+              "\"tid\":2},"
+              "{\"name\":\"publishing\",\"cat\":\"message\",\"ph\":\"b\",\"id\":\"0x10\",\"ts\":6,\"pid\":1,\"tid\":2},"
+              "{\"name\":\"publishing\",\"cat\":\"message\",\"ph\":\"e\",\"id\":\"0x10\",\"ts\":9,\"pid\":1,\"tid\":2},"
+              "{\"name\":\"acknowledged\",\"cat\":\"message\",\"ph\":\"n\",\"id\":\"0x10\",\"ts\":9,\"pid\":1,"
+              "\"tid\":2},"
+              "{\"name\":\"enqueued\",\"cat\":\"message\",\"ph\":\"n\",\"id\":\"0x10\",\"ts\":12,\"pid\":1,\"tid\":1}"
+              "]}");
+    EXPECT_EQ(MessageTracer::toJson({events.front()}),
+              "[{\"message\":16,\"stage\":\"enqueued\",\"timestamp\":1,\"thread\":1}]");
+}
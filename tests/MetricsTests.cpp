@@ -0,0 +1,184 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#define private public
+#define protected public
+#include "core/utilities/Metrics.h"
+#undef private
+#undef protected
+
+#include "core/model/Message.h"
+#include "core/persistence/filesystem/CircularFileSystemMessagePersistence.h"
+#include "core/persistence/inmemory/InMemoryMessagePersistence.h"
+#include "core/protocol/wolkabout/WolkaboutDataProtocol.h"
+#include "core/utilities/FileSystemUtils.h"
+
+#include <gtest/gtest.h>
+
+using namespace wolkabout;
+using namespace ::testing;
+
+class MetricsTests : public ::testing::Test
+{
+public:
+    MetricsRegistry registry;
+};
+
+TEST_F(MetricsTests, HistogramBucketsCoverEveryValue)
+{
+    for (std::uint64_t value = 0; value < 100000; ++value)
+    {
+        const auto index = Histogram::bucketIndex(value);
+        ASSERT_LE(value, Histogram::bucketUpperBound(index));
+        if (index > 0)
+        {
+            ASSERT_GT(value, Histogram::bucketUpperBound(index - 1));
+        }
+    }
+
+    EXPECT_EQ(Histogram::bucketIndex(UINT64_MAX), Histogram::BUCKETS - 1);
+    EXPECT_EQ(Histogram::bucketUpperBound(Histogram::BUCKETS - 1), UINT64_MAX);
+
+    // The buckets are never wider than an eighth of the values in them
+    const auto index = Histogram::bucketIndex(1000000);
+    EXPECT_LE(Histogram::bucketUpperBound(index) - Histogram::bucketUpperBound(index - 1), 1000000 / 8);
+}
+
+TEST_F(MetricsTests, HistogramQuantiles)
+{
+    auto& histogram = registry.histogram("latency", "Latency");
+    for (std::uint64_t value = 1; value <= 1000; ++value)
+        histogram.record(value);
+
+    const auto snapshot = registry.snapshot();
+    ASSERT_EQ(snapshot.histograms.size(), 1);
+    const auto& sample = snapshot.histograms.front();
+    EXPECT_EQ(sample.count, 1000);
+    EXPECT_EQ(sample.sum, 500500);
+    EXPECT_EQ(sample.max, 1000);
+    EXPECT_NEAR(static_cast<double>(sample.valueAt(0.5)), 500, 500 / 8);
+    EXPECT_NEAR(static_cast<double>(sample.valueAt(0.99)), 990, 990 / 8);
+    EXPECT_EQ(sample.valueAt(1), 1000);
+}
+
+TEST_F(MetricsTests, MetricsAreSharedByNameAndLabels)
+{
+    auto& first = registry.counter("messages_total", "Messages", {{"backend", "memory"}});
+    auto& second = registry.counter("messages_total", "Messages", {{"backend", "memory"}});
+    auto& other = registry.counter("messages_total", "Messages", {{"backend", "filesystem"}});
+    EXPECT_EQ(&first, &second);
+    EXPECT_NE(&first, &other);
+
+    auto threads = std::vector<std::thread>{};
+    for (auto i = 0; i < 4; ++i)
+        threads.emplace_back([&] {
+            for (auto j = 0; j < 10000; ++j)
+                registry.counter("messages_total", "Messages", {{"backend", "memory"}}).increment();
+        });
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(first.value(), 40000);
+    EXPECT_EQ(other.value(), 0);
+}
+
+TEST_F(MetricsTests, Exporters)
+{
+    registry.counter("messages_total", "Messages", {{"backend", "memory"}}).increment(3);
+    registry.counter("messages_total", "Messages", {{"backend", "filesystem"}}).increment(2);
+    registry.gauge("queued", "Queued \"messages\"").set(-1);
+    registry.histogram("latency", "Latency").record(7);
+
+    const auto snapshot = registry.snapshot();
+    EXPECT_EQ(MetricsRegistry::toPrometheus(snapshot), "# HELP messages_total Messages\n"
+                                                       "# TYPE messages_total counter\n"
+                                                       "messages_total{backend=\"filesystem\"} 2\n"
+                                                       "messages_total{backend=\"memory\"} 3\n"
+                                                       "# HELP queued Queued \"messages\"\n"
+                                                       "# TYPE queued gauge\n"
+                                                       "queued -1\n"
+                                                       "# HELP latency Latency\n"
+                                                       "# TYPE latency summary\n"
+                                                       "latency{quantile=\"0.5\"} 7\n"
+                                                       "latency{quantile=\"0.9\"} 7\n"
+                                                       "latency{quantile=\"0.99\"} 7\n"
+                                                       "latency{quantile=\"0.999\"} 7\n"
+                                                       "latency_sum 7\n"
+                                                       "latency_count 1\n");
+    EXPECT_EQ(MetricsRegistry::toJson(snapshot),
+              "{\"counters\":["
+              "{\"name\":\"messages_total\",\"labels\":{\"backend\":\"filesystem\"},\"help\":\"Messages\",\"value\":2},"
+              "{\"name\":\"messages_total\",\"labels\":{\"backend\":\"memory\"},\"help\":\"Messages\",\"value\":3}],"
+              "\"gauges\":[{\"name\":\"queued\",\"labels\":{},\"help\":\"Queued \\\"messages\\\"\",\"value\":-1}],"
+              "\"histograms\":[{\"name\":\"latency\",\"labels\":{},\"help\":\"Latency\",\"count\":1,\"sum\":7,"
+              "\"max\":7,\"p50\":7,\"p90\":7,\"p99\":7,\"p999\":7,\"buckets\":[{\"le\":7,\"count\":1}]}]}");
+}
+
+TEST_F(MetricsTests, PersistenceBacklogIsTracked)
+{
+    auto& gauge = MetricsRegistry::getInstance().gauge("wolkabout_persisted_messages", "", {{"backend", "memory"}});
+    const auto before = gauge.value();
+    {
+        InMemoryMessagePersistence persistence;
+        persistence.push(nullptr);
+        persistence.push(nullptr);
+        persistence.push(nullptr);
+        EXPECT_EQ(gauge.value(), before + 3);
+
+        persistence.pop();
+        EXPECT_EQ(gauge.value(), before + 2);
+    }
+    EXPECT_EQ(gauge.value(), before);
+}
+
+TEST_F(MetricsTests, CircularPersistenceHasItsOwnBackend)
+{
+    const auto directory = std::string{"./metricsTestDir"};
+    auto& circular =
+      MetricsRegistry::getInstance().gauge("wolkabout_persisted_messages", "", {{"backend", "circular_filesystem"}});
+    auto& filesystem =
+      MetricsRegistry::getInstance().gauge("wolkabout_persisted_messages", "", {{"backend", "filesystem"}});
+    const auto circularBefore = circular.value();
+    const auto filesystemBefore = filesystem.value();
+    {
+        CircularFileSystemMessagePersistence persistence{directory, PersistenceMethod::FIFO, 1024 * 1024};
+        ASSERT_TRUE(persistence.push(std::make_shared<wolkabout::Message>("[]", "d2p/KEY/feed_values")));
+        EXPECT_EQ(circular.value(), circularBefore + 1);
+        EXPECT_EQ(filesystem.value(), filesystemBefore);
+    }
+
+    for (const auto& file : FileSystemUtils::listFiles(directory))
+        FileSystemUtils::deleteFile(FileSystemUtils::composePath(file, directory));
+    rmdir(directory.c_str());
+}
+
+TEST_F(MetricsTests, ParseFailuresAreCountedByMessageType)
+{
+    auto& failures = MetricsRegistry::getInstance().counter("wolkabout_protocol_parse_failures_total", "",
+                                                            {{"type", toString(MessageType::FEED_VALUES)}});
+    const auto before = failures.value();
+
+    WolkaboutDataProtocol protocol;
+    EXPECT_EQ(protocol.parseFeedValues(std::make_shared<wolkabout::Message>("[", "p2d/KEY/feed_values")), nullptr);
+    EXPECT_NE(protocol.parseFeedValues(std::make_shared<wolkabout::Message>("[]", "p2d/KEY/feed_values")), nullptr);
+    EXPECT_EQ(failures.value(), before + 1);
+}
@@ -16,6 +16,8 @@
 
 #include <any>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 #define private public
 #define protected public
@@ -30,6 +32,7 @@
 #include "core/model/messages/ErrorMessage.h"
 #include "core/model/messages/FeedRegistrationMessage.h"
 #include "core/model/messages/FeedRemovalMessage.h"
+#include "core/model/messages/FeedValuesBuilder.h"
 #include "core/model/messages/FeedValuesMessage.h"
 #include "core/model/messages/FileBinaryRequestMessage.h"
 #include "core/model/messages/FileBinaryResponseMessage.h"
@@ -196,6 +199,65 @@ TEST_F(ModelMessagesTests, FeedValuesMessageGetReadings)
     EXPECT_FALSE(message.getReadings().empty());
 }
 
+TEST_F(ModelMessagesTests, FeedValuesBuilderKeepsReferencesOnce)
+{
+    auto builder = FeedValuesBuilder{4};
+    builder.add("T", 21.5, 1000).add("H", std::uint64_t{40}, 1000).add("T", 22.0, 2000).add("ON", true, 2000);
+    EXPECT_EQ(builder.size(), 4);
+
+    const auto message = builder.build();
+    EXPECT_EQ(builder.size(), 0);
+
+    const auto& columns = message.getColumns();
+    EXPECT_EQ(columns.references, (std::vector<std::string>{"T", "H", "ON"}));
+    EXPECT_EQ(columns.referenceIndices, (std::vector<std::uint32_t>{0, 1, 0, 2}));
+    EXPECT_EQ(columns.timestamps, (std::vector<std::uint64_t>{1000, 1000, 2000, 2000}));
+    EXPECT_TRUE(columns.strings.empty());
+}
+
+TEST_F(ModelMessagesTests, FeedValuesBuilderMessageGetReadings)
+{
+    auto builder = FeedValuesBuilder{};
+    builder.add("T", 21.5, 1000)
+      .add("S", "text", 1000)
+      .add("A", std::vector<std::double_t>{0.1, -9.81}, 2000)
+      .add(Reading{"L", Location{45.5, 19.25}, 2000});
+    const auto message = builder.build();
+
+    const auto& readings = message.getReadings();
+    ASSERT_EQ(readings.size(), 2);
+    ASSERT_EQ(readings.at(1000).size(), 2);
+    EXPECT_EQ(readings.at(1000)[0].getDoubleValue(), 21.5);
+    EXPECT_EQ(readings.at(1000)[1].getStringValue(), "text");
+    ASSERT_EQ(readings.at(2000).size(), 2);
+    EXPECT_EQ(readings.at(2000)[0].getDoubleValues(), (std::vector<std::double_t>{0.1, -9.81}));
+    EXPECT_EQ(readings.at(2000)[1].getStringValue(), "45.5,19.25");
+    EXPECT_EQ(readings.at(2000)[1].getTimestamp(), 2000);
+}
+
+TEST_F(ModelMessagesTests, FeedValuesBuilderMessageReadingsAreMadeOnce)
+{
+    auto builder = FeedValuesBuilder{};
+    for (auto i = 0; i < 1000; ++i)
+        builder.add("T" + std::to_string(i % 10), static_cast<std::int64_t>(i), 1000 + i / 10);
+    const auto message = builder.build();
+
+    auto threads = std::vector<std::thread>{};
+    auto readings = std::vector<const std::map<std::uint64_t, std::vector<Reading>>*>(4);
+    for (auto i = 0; i < 4; ++i)
+        threads.emplace_back([&message, &readings, i] { readings[i] = &message.getReadings(); });
+    for (auto& thread : threads)
+        thread.join();
+
+    for (const auto* threadReadings : readings)
+        EXPECT_EQ(threadReadings, readings.front());
+    ASSERT_EQ(message.getReadings().size(), 100);
+    EXPECT_EQ(message.getReadings().at(1099).size(), 10);
+
+    const auto copy = message;
+    EXPECT_EQ(copy.getReadings().at(1099).back().getIntValue(), 999);
+}
+
 TEST_F(ModelMessagesTests, MessageTypeForFileBinaryRequestMessage)
 {
     EXPECT_EQ(FileBinaryRequestMessage("", 0).getMessageType(), MessageType::FILE_BINARY_REQUEST);
@@ -221,6 +283,33 @@ TEST_F(ModelMessagesTests, FileBinaryResponseMessageGetEverything)
     EXPECT_FALSE(message.getCurrentHash().empty());
 }
 
+TEST_F(ModelMessagesTests, FileBinaryResponseMessageSplitsPayload)
+{
+    const auto previousHash = std::string(32, 'P');
+    const auto currentHash = std::string(32, 'C');
+    const auto message = FileBinaryResponseMessage{previousHash + "DATA" + currentHash};
+    EXPECT_EQ(message.getPreviousHash(), previousHash);
+    EXPECT_EQ(message.getData().toByteArray(), (ByteArray{'D', 'A', 'T', 'A'}));
+    EXPECT_EQ(message.getCurrentHash(), currentHash);
+}
+
+TEST_F(ModelMessagesTests, FileBinaryResponseMessageTooShort)
+{
+    const auto message = FileBinaryResponseMessage{std::string(64, 'A')};
+    EXPECT_TRUE(message.getPreviousHash().empty());
+    EXPECT_TRUE(message.getData().empty());
+    EXPECT_TRUE(message.getCurrentHash().empty());
+}
+
+TEST_F(ModelMessagesTests, FileBinaryResponseMessageDoesNotCopyData)
+{
+    const auto received =
+      std::make_shared<const wolkabout::Message>(std::string(1024, 'A'), "p2d/key/file_binary_response");
+    const auto message = FileBinaryResponseMessage{received};
+    EXPECT_EQ(message.getData().data(), reinterpret_cast<const Byte*>(received->getContent().data()) + 32);
+    EXPECT_EQ(message.getData().size(), 1024 - 64);
+}
+
 TEST_F(ModelMessagesTests, MessageTypeForFileDeleteMessage)
 {
     EXPECT_EQ(FileDeleteMessage{{}}.getMessageType(), MessageType::FILE_DELETE);
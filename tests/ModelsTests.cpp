@@ -143,6 +143,22 @@ TEST_F(ModelsTests, ReadingSetTimestampTest)
     EXPECT_NE(reading.getTimestamp(), 0);
 }
 
+TEST_F(ModelsTests, DoubleReadingKeepsPrecision)
+{
+    const auto reading = Reading{"R", 0.000123456789};
+    EXPECT_EQ(reading.getStringValue(), "0.000123456789");
+    EXPECT_TRUE(reading.isDouble());
+    EXPECT_EQ(reading.getDoubleValue(), 0.000123456789);
+
+    const auto wholeReading = Reading{"R", 20.0};
+    EXPECT_EQ(wholeReading.getStringValue(), "20.0");
+    EXPECT_TRUE(wholeReading.isDouble());
+
+    const auto multiReading = Reading{"R", std::vector<std::double_t>{0.1, -9.81, 1e-9}};
+    EXPECT_EQ(multiReading.getStringValues(), (std::vector<std::string>{"0.1", "-9.81", "1.0e-09"}));
+    EXPECT_EQ(multiReading.getDoubleValues(), (std::vector<std::double_t>{0.1, -9.81, 1e-9}));
+}
+
 TEST_F(ModelsTests, MultiReadingTest)
 {
     auto reading = Reading{"R", std::vector<std::double_t>{123, 456}};
@@ -0,0 +1,153 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <chrono>
+#include <memory>
+
+#define private public
+#define protected public
+#include "core/persistence/RetentionService.h"
+#include "core/persistence/inmemory/InMemoryMessagePersistence.h"
+#include "core/persistence/inmemory/InMemoryPersistence.h"
+#undef private
+#undef protected
+
+#include "core/model/Message.h"
+#include "core/utilities/Logger.h"
+#include "tests/mocks/MessagePersistenceMock.h"
+#include "tests/mocks/PersistenceMock.h"
+
+#include <gtest/gtest.h>
+
+using namespace wolkabout;
+using namespace ::testing;
+
+class RetentionServiceTests : public ::testing::Test
+{
+public:
+    static void SetUpTestCase() { Logger::init(LogLevel::TRACE, Logger::Type::CONSOLE); }
+
+    void SetUp() override
+    {
+        persistenceMock = std::make_shared<NiceMock<PersistenceMock>>();
+        messagePersistenceMock = std::make_shared<NiceMock<MessagePersistenceMock>>();
+        service = std::unique_ptr<RetentionService>{new RetentionService};
+        service->addPersistence(persistenceMock);
+        service->addMessagePersistence(messagePersistenceMock);
+    }
+
+    std::shared_ptr<PersistenceMock> persistenceMock;
+    std::shared_ptr<MessagePersistenceMock> messagePersistenceMock;
+    std::unique_ptr<RetentionService> service;
+};
+
+TEST_F(RetentionServiceTests, NothingExpiresWithoutRetentionTime)
+{
+    EXPECT_CALL(*persistenceMock, removeReadingsOlderThan).Times(0);
+    EXPECT_CALL(*messagePersistenceMock, removeOlderThan).Times(0);
+    EXPECT_EQ(service->removeExpired(), 0);
+}
+
+TEST_F(RetentionServiceTests, RetentionTimeParameterIsInMinutes)
+{
+    EXPECT_FALSE(service->applyParameter(Parameter{ParameterName::MAXIMUM_MESSAGE_SIZE, "10"}));
+    EXPECT_FALSE(service->applyParameter(Parameter{ParameterName::OUTBOUND_DATA_RETENTION_TIME, "-100"}));
+    EXPECT_FALSE(service->applyParameter(Parameter{ParameterName::OUTBOUND_DATA_RETENTION_TIME, "forever"}));
+    EXPECT_EQ(service->getRetentionTime().count(), 0);
+
+    ASSERT_TRUE(service->applyParameter(Parameter{ParameterName::OUTBOUND_DATA_RETENTION_TIME, "10"}));
+    EXPECT_EQ(service->getRetentionTime(), std::chrono::minutes{10});
+
+    const auto now = std::chrono::system_clock::now();
+    EXPECT_CALL(*persistenceMock, removeReadingsOlderThan(now - std::chrono::minutes{10})).WillOnce(Return(3));
+    EXPECT_CALL(*messagePersistenceMock, removeOlderThan(now - std::chrono::minutes{10})).WillOnce(Return(2));
+    EXPECT_EQ(service->removeExpired(now), 5);
+}
+
+TEST_F(RetentionServiceTests, InMemoryPersistencesExpireTheOldest)
+{
+    auto persistence = std::make_shared<InMemoryPersistence>();
+    auto messagePersistence = std::make_shared<InMemoryMessagePersistence>();
+    service.reset(new RetentionService);
+    service->addPersistence(persistence);
+    service->addMessagePersistence(messagePersistence);
+    service->setRetentionTime(std::chrono::hours{1});
+
+    persistence->putReading("T", Reading{"T", std::uint64_t{1}});
+    persistence->putReading("P", Reading{"P", std::uint64_t{2}});
+    messagePersistence->push(std::make_shared<wolkabout::Message>("old", "topic"));
+    for (auto& pair : persistence->m_readings)
+        pair.second.front().persistedAt -= std::chrono::hours{2};
+    messagePersistence->m_queue.front().pushedAt -= std::chrono::hours{2};
+
+    persistence->putReading("T", Reading{"T", std::uint64_t{3}});
+    messagePersistence->push(std::make_shared<wolkabout::Message>("new", "topic"));
+
+    EXPECT_EQ(service->removeExpired(), 3);
+    EXPECT_EQ(persistence->getReadingsKeys(), std::vector<std::string>{"T"});
+    const auto readings = persistence->getReadings("T", 10);
+    ASSERT_EQ(readings.size(), 1);
+    EXPECT_EQ(readings.front()->getUIntValue(), 3);
+    EXPECT_EQ(messagePersistence->front()->getContent(), "new");
+
+    EXPECT_EQ(service->removeExpired(), 0);
+}
+
+TEST_F(RetentionServiceTests, ExpiredMessageBeingPublishedIsNotReplaced)
+{
+    auto messagePersistence = std::make_shared<InMemoryMessagePersistence>();
+    service.reset(new RetentionService);
+    service->addMessagePersistence(messagePersistence);
+    service->setRetentionTime(std::chrono::hours{1});
+
+    messagePersistence->push(std::make_shared<wolkabout::Message>("old", "topic"));
+    messagePersistence->m_queue.front().pushedAt -= std::chrono::hours{2};
+    messagePersistence->push(std::make_shared<wolkabout::Message>("new", "topic"));
+
+    // The retention removes the message while it is being published, so it must not take the next one with it
+    const auto published = messagePersistence->front();
+    EXPECT_EQ(service->removeExpired(), 1);
+    EXPECT_FALSE(messagePersistence->remove(published));
+    ASSERT_NE(messagePersistence->front(), nullptr);
+    EXPECT_EQ(messagePersistence->front()->getContent(), "new");
+
+    EXPECT_TRUE(messagePersistence->remove(messagePersistence->front()));
+    EXPECT_EQ(messagePersistence->front(), nullptr);
+}
+
+TEST_F(RetentionServiceTests, TimerRemovesTheExpiredData)
+{
+    service.reset(new RetentionService{std::chrono::milliseconds{10}});
+    service->addPersistence(persistenceMock);
+    service->setRetentionTime(std::chrono::minutes{1});
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    auto called = false;
+    EXPECT_CALL(*persistenceMock, removeReadingsOlderThan).WillRepeatedly([&](std::chrono::system_clock::time_point) {
+        std::lock_guard<std::mutex> lock{mutex};
+        called = true;
+        condition.notify_one();
+        return std::size_t{0};
+    });
+
+    service->start();
+    std::unique_lock<std::mutex> lock{mutex};
+    EXPECT_TRUE(condition.wait_for(lock, std::chrono::seconds{1}, [&] { return called; }));
+    lock.unlock();
+    service->stop();
+}
@@ -0,0 +1,114 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+
+#define private public
+#define protected public
+#include "core/utilities/RingBuffer.h"
+#undef private
+#undef protected
+
+#include <gtest/gtest.h>
+
+using namespace wolkabout;
+using namespace ::testing;
+
+class RingBufferTests : public ::testing::Test
+{
+};
+
+TEST_F(RingBufferTests, PushAndPopKeepTheOrder)
+{
+    auto buffer = RingBuffer<std::string>{};
+    EXPECT_TRUE(buffer.empty());
+
+    for (auto i = 0; i < 10; ++i)
+        EXPECT_FALSE(buffer.push(std::to_string(i)));
+    ASSERT_EQ(buffer.size(), 10);
+
+    buffer.pop(3);
+    ASSERT_EQ(buffer.size(), 7);
+    EXPECT_EQ(buffer.front(), "3");
+
+    // These wrap around into the slots of the popped items
+    buffer.push("10");
+    buffer.push("11");
+    ASSERT_EQ(buffer.size(), 9);
+    for (std::size_t i = 0; i < buffer.size(); ++i)
+        EXPECT_EQ(buffer.at(i), std::to_string(i + 3));
+
+    buffer.pop(100);
+    EXPECT_TRUE(buffer.empty());
+    EXPECT_TRUE(buffer.m_items.empty());
+}
+
+TEST_F(RingBufferTests, FullBufferDropsTheOldest)
+{
+    auto buffer = RingBuffer<int>{3};
+    EXPECT_FALSE(buffer.push(1));
+    EXPECT_FALSE(buffer.push(2));
+    EXPECT_FALSE(buffer.push(3));
+    EXPECT_TRUE(buffer.push(4));
+    EXPECT_TRUE(buffer.push(5));
+
+    ASSERT_EQ(buffer.size(), 3);
+    EXPECT_EQ(buffer.at(0), 3);
+    EXPECT_EQ(buffer.at(1), 4);
+    EXPECT_EQ(buffer.at(2), 5);
+    EXPECT_EQ(buffer.m_items.size(), 3);
+}
+
+TEST_F(RingBufferTests, LoweringTheCapacityDropsTheOldest)
+{
+    auto buffer = RingBuffer<int>{};
+    for (auto i = 0; i < 8; ++i)
+        buffer.push(i);
+    buffer.pop(2);
+    buffer.push(8);
+
+    buffer.setCapacity(4);
+    ASSERT_EQ(buffer.size(), 4);
+    EXPECT_LE(buffer.m_items.size(), 4);
+    EXPECT_LT(buffer.m_items.capacity(), 8);
+    for (std::size_t i = 0; i < buffer.size(); ++i)
+        EXPECT_EQ(buffer.at(i), static_cast<int>(i) + 5);
+
+    EXPECT_TRUE(buffer.push(9));
+    EXPECT_EQ(buffer.front(), 6);
+
+    buffer.setCapacity(0);
+    EXPECT_FALSE(buffer.push(10));
+    EXPECT_EQ(buffer.size(), 5);
+}
+
+TEST_F(RingBufferTests, PoppingMostItemsReleasesTheSlots)
+{
+    auto buffer = RingBuffer<int>{};
+    for (auto i = 0; i < 100; ++i)
+        buffer.push(i);
+
+    buffer.pop(90);
+    EXPECT_EQ(buffer.size(), 10);
+    EXPECT_EQ(buffer.m_items.size(), 10);
+    EXPECT_LT(buffer.m_items.capacity(), 100);
+    for (std::size_t i = 0; i < buffer.size(); ++i)
+        EXPECT_EQ(buffer.at(i), static_cast<int>(i) + 90);
+
+    buffer.pop(10);
+    EXPECT_TRUE(buffer.empty());
+    EXPECT_EQ(buffer.m_items.capacity(), 0);
+}
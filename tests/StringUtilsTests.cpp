@@ -26,6 +26,7 @@
 #include "core/utilities/Logger.h"
 
 #include <gtest/gtest.h>
+#include <limits>
 
 using namespace wolkabout;
 using namespace ::testing;
@@ -111,3 +112,114 @@ TEST_F(StringUtilsTests, ToUpperCaseTest)
 {
     EXPECT_EQ(StringUtils::toUpperCase("Hello!"), "HELLO!");
 }
+
+TEST_F(StringUtilsTests, Base64EncodeTest)
+{
+    EXPECT_EQ(StringUtils::base64Encode(ByteArray{}), "");
+    EXPECT_EQ(StringUtils::base64Encode(ByteArray{'f'}), "Zg==");
+    EXPECT_EQ(StringUtils::base64Encode(ByteArray{'f', 'o'}), "Zm8=");
+    EXPECT_EQ(StringUtils::base64Encode(ByteArray{'f', 'o', 'o'}), "Zm9v");
+    EXPECT_EQ(StringUtils::base64Encode(ByteArray{'f', 'o', 'o', 'b', 'a', 'r'}), "Zm9vYmFy");
+}
+
+TEST_F(StringUtilsTests, Base64DecodeTest)
+{
+    EXPECT_EQ(StringUtils::base64Decode(""), "");
+    EXPECT_EQ(StringUtils::base64Decode("Zg=="), "f");
+    EXPECT_EQ(StringUtils::base64Decode("Zm8="), "fo");
+    EXPECT_EQ(StringUtils::base64Decode("Zm9v"), "foo");
+    EXPECT_EQ(StringUtils::base64Decode("Zm9vYmFy"), "foobar");
+    EXPECT_EQ(StringUtils::base64Decode("Zm9v\"YmFy"), "foo");
+}
+
+TEST_F(StringUtilsTests, Base64DecodeIntoDestinationTest)
+{
+    auto bytes = ByteArray(1000);
+    for (std::size_t i = 0; i < bytes.size(); ++i)
+        bytes[i] = static_cast<std::uint8_t>(i * 7);
+
+    auto decoded = std::string{"previous content"};
+    StringUtils::base64Decode(StringUtils::base64Encode(bytes), decoded);
+    EXPECT_EQ(decoded, std::string(bytes.cbegin(), bytes.cend()));
+}
+
+TEST_F(StringUtilsTests, Base64RoundTripAllLengthsTest)
+{
+    // Cover the boundaries between the vectorized blocks and the scalar tail
+    for (std::size_t length = 0; length < 300; ++length)
+    {
+        auto bytes = ByteArray(length);
+        for (std::size_t i = 0; i < length; ++i)
+            bytes[i] = static_cast<std::uint8_t>((i * 131 + length) & 0xFF);
+
+        const auto encoded = StringUtils::base64Encode(bytes);
+        ASSERT_EQ(encoded.size(), StringUtils::base64EncodedLength(length));
+        const auto decoded = StringUtils::base64Decode(encoded);
+        ASSERT_EQ(decoded, std::string(bytes.cbegin(), bytes.cend())) << "Failed for length " << length;
+    }
+}
+
+TEST_F(StringUtilsTests, Base64EncodeMatchesAlphabetTest)
+{
+    // Every 6 bit value appears in the input, so the whole alphabet must be produced in order
+    auto bytes = ByteArray{};
+    for (std::uint32_t i = 0; i < 64; i += 4)
+    {
+        const auto quantum = (i << 18u) | ((i + 1) << 12u) | ((i + 2) << 6u) | (i + 3);
+        bytes.emplace_back(static_cast<std::uint8_t>(quantum >> 16u));
+        bytes.emplace_back(static_cast<std::uint8_t>(quantum >> 8u));
+        bytes.emplace_back(static_cast<std::uint8_t>(quantum));
+    }
+    bytes.insert(bytes.end(), bytes.cbegin(), bytes.cend());
+
+    const auto alphabet = std::string{"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"};
+    EXPECT_EQ(StringUtils::base64Encode(bytes), alphabet + alphabet);
+}
+
+TEST_F(StringUtilsTests, Base64DecodeStopsAtInvalidCharacterTest)
+{
+    const auto encoded = StringUtils::base64Encode(ByteArray(300, 0xAB));
+    for (const auto position : {std::size_t{8}, std::size_t{100}, std::size_t{200}})
+    {
+        auto broken = encoded;
+        broken[position] = '-';
+        EXPECT_EQ(StringUtils::base64Decode(broken), std::string((position / 4) * 3, static_cast<char>(0xAB)));
+    }
+}
+
+TEST_F(StringUtilsTests, Base64BufferOverloadsTest)
+{
+    const auto bytes = ByteArray{'W', 'o', 'l', 'k', 'A', 'b', 'o', 'u', 't'};
+
+    auto encoded = std::vector<char>(StringUtils::base64EncodedLength(bytes.size()));
+    ASSERT_EQ(StringUtils::base64Encode(bytes.data(), bytes.size(), encoded.data()), encoded.size());
+    EXPECT_EQ(std::string(encoded.cbegin(), encoded.cend()), "V29sa0Fib3V0");
+
+    auto decoded = ByteArray(StringUtils::base64DecodedLength(encoded.size()));
+    decoded.resize(StringUtils::base64Decode(encoded.data(), encoded.size(), decoded.data()));
+    EXPECT_EQ(decoded, bytes);
+}
+
+TEST_F(StringUtilsTests, IntegerToStringTest)
+{
+    EXPECT_EQ(StringUtils::toString(0), "0");
+    EXPECT_EQ(StringUtils::toString(-123), "-123");
+    EXPECT_EQ(StringUtils::toString(std::numeric_limits<std::uint64_t>::max()), "18446744073709551615");
+    EXPECT_EQ(StringUtils::toString(std::numeric_limits<std::int64_t>::min()), "-9223372036854775808");
+}
+
+TEST_F(StringUtilsTests, FloatingPointToStringTest)
+{
+    EXPECT_EQ(StringUtils::toString(0.1), "0.1");
+    EXPECT_EQ(StringUtils::toString(-2.5), "-2.5");
+    EXPECT_EQ(StringUtils::toString(123.0), "123.0");
+    EXPECT_EQ(StringUtils::toString(0.1f), "0.1");
+
+    // The values that std::to_string would round away keep all of their digits
+    for (const auto value : {1e-7, 1.0 / 3.0, 123456.789012345, 1e300, -2.2250738585072014e-308, 9007199254740993.0})
+    {
+        const auto string = StringUtils::toString(value);
+        EXPECT_NE(string.find('.'), std::string::npos) << string;
+        EXPECT_EQ(std::stod(string), value) << string;
+    }
+}
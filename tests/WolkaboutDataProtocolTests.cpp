@@ -20,6 +20,7 @@
 #undef private
 #undef protected
 
+#include "core/model/messages/FeedValuesBuilder.h"
 #include "core/protocol/wolkabout/WolkaboutProtocol.h"
 #include "core/utilities/Logger.h"
 
@@ -27,6 +28,8 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <limits>
 #include <regex>
 
 using namespace ::testing;
@@ -222,6 +225,94 @@ TEST_F(WolkaboutDataProtocolTests, SerializeMultiValueReading)
     EXPECT_TRUE(std::regex_match(message->getContent(), payloadRegex));
 }
 
+TEST_F(WolkaboutDataProtocolTests, SerializeFeedValuesColumnsLikeReadings)
+{
+    // The same values, once as readings and once as columns, added out of order
+    auto builder = FeedValuesBuilder{};
+    builder.add(TEMPERATURE, 20.5, 2000)
+      .add(TEMPERATURE, std::int64_t{-3}, 1000)
+      .add("Switch", true, 1000)
+      .add("Text", std::string{"42"}, 0)
+      .add(ACCELERATION, std::vector<std::double_t>{12.1005, 0.2304, -0.128}, 2000);
+    const auto readings = FeedValuesMessage{
+      {Reading{TEMPERATURE, 20.5, 2000}, Reading{TEMPERATURE, std::int64_t{-3}, 1000}, Reading{"Switch", true, 1000},
+       Reading{"Text", std::string{"42"}, 0},
+       Reading{ACCELERATION, std::vector<std::double_t>{12.1005, 0.2304, -0.128}, 2000}}};
+
+    const auto columnsMessage = protocol->makeOutboundMessage(DEVICE_KEY, builder.build());
+    const auto readingsMessage = protocol->makeOutboundMessage(DEVICE_KEY, readings);
+    ASSERT_NE(columnsMessage, nullptr);
+    ASSERT_NE(readingsMessage, nullptr);
+    LogMessage(*columnsMessage);
+
+    EXPECT_EQ(columnsMessage->getChannel(), readingsMessage->getChannel());
+    EXPECT_EQ(columnsMessage->getContent(), readingsMessage->getContent());
+    EXPECT_EQ(json::parse(columnsMessage->getContent()),
+              json::parse(R"([{"Text":42},{"T":-3,"Switch":true,"timestamp":1000},)"
+                          R"({"T":20.5,"Acceleration":"12.1005,0.2304,-0.128","timestamp":2000}])"));
+}
+
+TEST_F(WolkaboutDataProtocolTests, SerializeFeedValuesEmptyColumns)
+{
+    auto builder = FeedValuesBuilder{};
+    EXPECT_EQ(protocol->makeOutboundMessage(DEVICE_KEY, builder.build()), nullptr);
+}
+
+TEST_F(WolkaboutDataProtocolTests, SerializeFeedValuesIntoPooledMessages)
+{
+    MessagePool pool{1};
+    const auto values = FeedValuesMessage{{Reading{TEMPERATURE, 20.5, 2000}, Reading{"Switch", true, 1000}}};
+
+    const auto expected = protocol->makeOutboundMessage(DEVICE_KEY, values);
+    auto message = protocol->makeOutboundMessage(DEVICE_KEY, values, pool);
+    ASSERT_NE(expected, nullptr);
+    ASSERT_NE(message, nullptr);
+    EXPECT_EQ(message->getChannel(), expected->getChannel());
+    EXPECT_EQ(message->getContent(), expected->getContent());
+    EXPECT_EQ(pool.available(), 0);
+
+    // The next message reuses the slot, and none of the previous content is left in it
+    const auto* pooled = message.get();
+    message.reset();
+    message = protocol->makeOutboundMessage(DEVICE_KEY, FeedValuesMessage{{Reading{"Switch", false}}}, pool);
+    ASSERT_NE(message, nullptr);
+    EXPECT_EQ(message.get(), pooled);
+    EXPECT_EQ(message->getContent(), R"([{"Switch":false}])");
+
+    // The slot is given back when the message can not be made
+    message.reset();
+    EXPECT_EQ(protocol->makeOutboundMessage(DEVICE_KEY, FeedValuesMessage{{}}, pool), nullptr);
+    EXPECT_EQ(pool.available(), 1);
+}
+
+TEST_F(WolkaboutDataProtocolTests, SerializeFeedValuesColumnsIntoPooledMessages)
+{
+    // The values that the json formats in its own way, added out of order and with a repeated reference
+    MessagePool pool{1};
+    auto builder = FeedValuesBuilder{};
+    builder.add("Zeta", 0.1, 2000)
+      .add("Alpha", 1.0, 2000)
+      .add("Big", 1e21, 2000)
+      .add("Nan", std::nan(""), 2000)
+      .add("Min", std::numeric_limits<std::int64_t>::min(), 1000)
+      .add("Max", std::numeric_limits<std::uint64_t>::max(), 1000)
+      .add("Quote \"\\\n\x01\x7f\xc3\xa9", std::string{"Tab\tand \"quotes\""}, 1000)
+      .add("Number", std::string{"-12"}, 1000)
+      .add("Switch", std::string{"TRUE"}, 0)
+      .add("Switch", false, 0)
+      .add("timestamp", std::uint64_t{5}, 3000)
+      .add(ACCELERATION, std::vector<std::int64_t>{1, -2, 3}, 1000);
+    const auto values = builder.build();
+
+    const auto expected = protocol->makeOutboundMessage(DEVICE_KEY, values);
+    const auto message = protocol->makeOutboundMessage(DEVICE_KEY, values, pool);
+    ASSERT_NE(expected, nullptr);
+    ASSERT_NE(message, nullptr);
+    LogMessage(*message);
+    EXPECT_EQ(message->getChannel(), expected->getChannel());
+    EXPECT_EQ(message->getContent(), expected->getContent());
+}
+
 TEST_F(WolkaboutDataProtocolTests, SerializeFeedValuesMultiple)
 {
     // Make a single reading that will be sent out
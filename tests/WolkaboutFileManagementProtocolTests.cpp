@@ -449,6 +449,25 @@ TEST_F(WolkaboutFileManagementProtocolTests, DeserializeFileBinaryResponseSingle
     EXPECT_EQ(parsedMessage->getMessageType(), MessageType::FILE_BINARY_RESPONSE);
 }
 
+TEST_F(WolkaboutFileManagementProtocolTests, DeserializeFileBinaryResponseWithData)
+{
+    // Make a message that contains both the hashes and the data
+    auto topic = "p2d/" + DEVICE_KEY + "/file_binary_response";
+    auto message =
+      std::make_shared<wolkabout::Message>(std::string(32, 'P') + std::string(256, 'D') + std::string(32, 'C'), topic);
+
+    // Make place for the parsed message
+    auto parsedMessage = std::shared_ptr<FileBinaryResponseMessage>{};
+    ASSERT_NO_FATAL_FAILURE(parsedMessage = protocol->parseFileBinaryResponse(message));
+    ASSERT_NE(parsedMessage, nullptr);
+
+    // Check that the data is read out of the received message
+    EXPECT_EQ(parsedMessage->getPreviousHash(), std::string(32, 'P'));
+    EXPECT_EQ(parsedMessage->getData().data(), reinterpret_cast<const Byte*>(message->getContent().data()) + 32);
+    EXPECT_EQ(parsedMessage->getData().toByteArray(), ByteArray(256, 'D'));
+    EXPECT_EQ(parsedMessage->getCurrentHash(), std::string(32, 'C'));
+}
+
 TEST_F(WolkaboutFileManagementProtocolTests, DeserializeFileUrlDownloadInitInvalidTopic)
 {
     // Make a message where the topic is not the right one
@@ -144,6 +144,92 @@ TEST_F(WolkaboutGatewaySubdeviceProtocolTests, MakeOutboundFromPullFeeds)
     LogMessage(*parsedMessage);
 }
 
+TEST_F(WolkaboutGatewaySubdeviceProtocolTests, MakeOutboundBatchFromFeedValues)
+{
+    // Make the feed values messages for two subdevices
+    auto feed = FeedValuesMessage{{{"T", std::string{"123"}}}};
+    auto firstFeed = dataProtocol->makeOutboundMessage(SUBDEVICE_KEY, feed);
+    auto secondFeed = dataProtocol->makeOutboundMessage(SUBDEVICE_KEY + "_2", feed);
+    auto messages = std::vector<GatewaySubdeviceMessage>{GatewaySubdeviceMessage{*firstFeed},
+                                                         GatewaySubdeviceMessage{*secondFeed}};
+
+    // Now make the batch message
+    auto parsedMessage = std::unique_ptr<wolkabout::Message>{};
+    ASSERT_NO_FATAL_FAILURE(parsedMessage = protocol->makeOutboundMessage(DEVICE_KEY, messages));
+    ASSERT_NE(parsedMessage, nullptr);
+    LogMessage(*parsedMessage);
+    EXPECT_EQ(parsedMessage->getChannel(), "g2p/" + DEVICE_KEY + "/feed_values");
+    EXPECT_EQ(parsedMessage->getContent(), R"([{"device":")" + SUBDEVICE_KEY + R"(","payload":)" +
+                                             firstFeed->getContent() + R"(},{"device":")" + SUBDEVICE_KEY +
+                                             R"(_2","payload":)" + secondFeed->getContent() + "}]");
+
+    // Check that the batch can be parsed back into the sub-messages
+    auto incomingMessages = std::vector<GatewaySubdeviceMessage>{};
+    ASSERT_NO_FATAL_FAILURE(incomingMessages = protocol->parseIncomingSubdeviceMessage(
+                              std::make_shared<wolkabout::Message>(*parsedMessage)));
+    ASSERT_EQ(incomingMessages.size(), 2);
+    EXPECT_EQ(incomingMessages.front().getMessage().getContent(), firstFeed->getContent());
+    EXPECT_EQ(protocol->getDeviceKey(incomingMessages.back().getMessage()), SUBDEVICE_KEY + "_2");
+}
+
+TEST_F(WolkaboutGatewaySubdeviceProtocolTests, MakeOutboundBatchFromPullFeeds)
+{
+    // Make the pull feed values message
+    auto parsedFeed = dataProtocol->makeOutboundMessage(SUBDEVICE_KEY, PullFeedValuesMessage{});
+
+    // Now make the batch message
+    auto parsedMessage = std::unique_ptr<wolkabout::Message>{};
+    ASSERT_NO_FATAL_FAILURE(parsedMessage = protocol->makeOutboundMessage(
+                              DEVICE_KEY, std::vector<GatewaySubdeviceMessage>{GatewaySubdeviceMessage{*parsedFeed}}));
+    ASSERT_NE(parsedMessage, nullptr);
+    LogMessage(*parsedMessage);
+    EXPECT_EQ(parsedMessage->getContent(), R"([")" + SUBDEVICE_KEY + R"("])");
+}
+
+TEST_F(WolkaboutGatewaySubdeviceProtocolTests, MakeOutboundBatchEmpty)
+{
+    EXPECT_EQ(protocol->makeOutboundMessage(DEVICE_KEY, std::vector<GatewaySubdeviceMessage>{}), nullptr);
+}
+
+TEST_F(WolkaboutGatewaySubdeviceProtocolTests, MakeOutboundBatchMixedTypes)
+{
+    auto feed = dataProtocol->makeOutboundMessage(SUBDEVICE_KEY, FeedValuesMessage{{{"T", std::string{"123"}}}});
+    auto pullFeed = dataProtocol->makeOutboundMessage(SUBDEVICE_KEY, PullFeedValuesMessage{});
+    auto messages =
+      std::vector<GatewaySubdeviceMessage>{GatewaySubdeviceMessage{*feed}, GatewaySubdeviceMessage{*pullFeed}};
+    EXPECT_EQ(protocol->makeOutboundMessage(DEVICE_KEY, messages), nullptr);
+}
+
+TEST_F(WolkaboutGatewaySubdeviceProtocolTests, MakeOutboundBatchInvalidContent)
+{
+    auto feed = dataProtocol->makeOutboundMessage(SUBDEVICE_KEY, FeedValuesMessage{{{"T", std::string{"123"}}}});
+    auto messages = std::vector<GatewaySubdeviceMessage>{
+      GatewaySubdeviceMessage{*feed},
+      GatewaySubdeviceMessage{wolkabout::Message{R"([{"T":123)", feed->getChannel()}}};
+    EXPECT_EQ(protocol->makeOutboundMessage(DEVICE_KEY, messages), nullptr);
+}
+
+TEST_F(WolkaboutGatewaySubdeviceProtocolTests, MakeOutboundBatchFromSingleMessages)
+{
+    auto feed = FeedValuesMessage{{{"T", std::string{"123"}}}};
+    auto firstFeed = dataProtocol->makeOutboundMessage(SUBDEVICE_KEY, feed);
+    auto secondFeed = dataProtocol->makeOutboundMessage(SUBDEVICE_KEY + "_2", feed);
+    auto messages = std::vector<GatewaySubdeviceMessage>{GatewaySubdeviceMessage{*firstFeed},
+                                                         GatewaySubdeviceMessage{*secondFeed}};
+
+    // The default of the interface joins the messages made one by one into the same batch
+    const auto expected = protocol->makeOutboundMessage(DEVICE_KEY, messages);
+    const auto joined = protocol->GatewaySubdeviceProtocol::makeOutboundMessage(DEVICE_KEY, messages);
+    ASSERT_NE(expected, nullptr);
+    ASSERT_NE(joined, nullptr);
+    LogMessage(*joined);
+    EXPECT_EQ(joined->getChannel(), expected->getChannel());
+    EXPECT_EQ(joined->getContent(), expected->getContent());
+
+    messages.clear();
+    EXPECT_EQ(protocol->GatewaySubdeviceProtocol::makeOutboundMessage(DEVICE_KEY, messages), nullptr);
+}
+
 TEST_F(WolkaboutGatewaySubdeviceProtocolTests, MakeOutboundFromRegistrationMessage)
 {
     auto registrationMessage = registrationProtocol->makeOutboundMessage(
@@ -209,7 +295,7 @@ TEST_F(WolkaboutGatewaySubdeviceProtocolTests, ParseIncomingFileBinaryResponse)
     // And parse the message
     auto parsedMessages = std::vector<GatewaySubdeviceMessage>{};
     ASSERT_NO_FATAL_FAILURE(parsedMessages = protocol->parseIncomingSubdeviceMessage(message));
-    ASSERT_FALSE(parsedMessages.empty());
-    for (const auto& parsedMessage : parsedMessages)
-        LogMessage(parsedMessage.getMessage());
+    ASSERT_EQ(parsedMessages.size(), 1);
+    EXPECT_EQ(parsedMessages.front().getMessage().getContent(), std::string(64, 100));
+    EXPECT_EQ(parsedMessages.front().getMessage().getChannel(), "p2d/AD1/file_binary_response");
 }
@@ -37,6 +37,8 @@ public:
     MOCK_METHOD(std::unique_ptr<Message>, makeOutboundMessage, (const std::string&, FeedRegistrationMessage));
     MOCK_METHOD(std::unique_ptr<Message>, makeOutboundMessage, (const std::string&, FeedRemovalMessage));
     MOCK_METHOD(std::unique_ptr<Message>, makeOutboundMessage, (const std::string&, FeedValuesMessage));
+    MOCK_METHOD(std::shared_ptr<Message>, makeOutboundMessage,
+                (const std::string&, const FeedValuesMessage&, MessagePool&));
     MOCK_METHOD(std::unique_ptr<Message>, makeOutboundMessage, (const std::string&, PullFeedValuesMessage));
     MOCK_METHOD(std::unique_ptr<Message>, makeOutboundMessage, (const std::string&, AttributeRegistrationMessage));
     MOCK_METHOD(std::unique_ptr<Message>, makeOutboundMessage, (const std::string&, ParametersUpdateMessage));
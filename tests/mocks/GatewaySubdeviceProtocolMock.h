@@ -35,6 +35,8 @@ public:
     MOCK_METHOD(std::string, getResponseChannelForMessage, (MessageType, const std::string&), (const));
     // GatewaySubdeviceProtocol methods
     MOCK_METHOD(std::unique_ptr<Message>, makeOutboundMessage, (const std::string&, const GatewaySubdeviceMessage&));
+    MOCK_METHOD(std::unique_ptr<Message>, makeOutboundMessage,
+                (const std::string&, const std::vector<GatewaySubdeviceMessage>&));
     MOCK_METHOD(std::vector<GatewaySubdeviceMessage>, parseIncomingSubdeviceMessage, (std::shared_ptr<Message>));
 };
 
@@ -0,0 +1,36 @@
+/**
+ * Copyright 2022 Wolkabout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WOLKABOUTCONNECTOR_LOGUPLOADERMOCK_H
+#define WOLKABOUTCONNECTOR_LOGUPLOADERMOCK_H
+
+#include "core/utilities/LogUploader.h"
+
+#include <gmock/gmock.h>
+
+using namespace wolkabout;
+
+class LogUploaderMock : public LogUploader
+{
+public:
+    MOCK_METHOD(bool, upload, (const std::string&));
+    MOCK_METHOD(std::vector<std::string>, getRemoteLogs, ());
+    using RemoteLogSizes = std::map<std::string, std::uint64_t>;
+    MOCK_METHOD(RemoteLogSizes, getRemoteLogSizes, (const std::string&));
+    MOCK_METHOD(void, setBandwidthLimit, (std::uint64_t));
+};
+
+#endif    // WOLKABOUTCONNECTOR_LOGUPLOADERMOCK_H
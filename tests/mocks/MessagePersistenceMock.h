@@ -28,8 +28,10 @@ class MessagePersistenceMock : public MessagePersistence
 public:
     MOCK_METHOD(bool, push, (std::shared_ptr<Message>));
     MOCK_METHOD(void, pop, ());
+    MOCK_METHOD(bool, remove, (const std::shared_ptr<Message>&));
     MOCK_METHOD(std::shared_ptr<Message>, front, ());
     MOCK_METHOD(bool, empty, (), (const));
+    MOCK_METHOD(std::size_t, removeOlderThan, (std::chrono::system_clock::time_point));
 };
 
 #endif    // WOLKGATEWAY_MESSAGEPERSISTENCEMOCK_H
@@ -29,6 +29,7 @@ public:
     MOCK_METHOD(bool, putReading, (const std::string&, const Reading&));
     MOCK_METHOD(std::vector<std::shared_ptr<Reading>>, getReadings, (const std::string&, std::uint_fast64_t));
     MOCK_METHOD(void, removeReadings, (const std::string&, std::uint_fast64_t));
+    MOCK_METHOD(std::size_t, removeReadingsOlderThan, (std::chrono::system_clock::time_point));
     MOCK_METHOD(std::vector<std::string>, getReadingsKeys, ());
     MOCK_METHOD(bool, putAttribute, (const std::string&, std::shared_ptr<Attribute>));
     MOCK_METHOD((std::map<std::string, std::shared_ptr<Attribute>>), getAttributes, ());